@@ -0,0 +1,490 @@
+#include "association.h"
+#include "executor.h"
+#include "stats_hooks.h"
+#include <algorithm>
+#include <limits>
+
+namespace nms {
+
+namespace {
+
+inline bool passesGate(float iou, float threshold) {
+    return iou > 0.0f && iou >= threshold;
+}
+
+inline Match makeMatch(int row, int col, float iou) {
+    Match match;
+    match.detection = row;
+    match.track = col;
+    match.iou = iou;
+    return match;
+}
+
+bool edgeGreater(const Match& a, const Match& b) {
+    if (a.iou != b.iou) {
+        return a.iou > b.iou;
+    }
+    if (a.detection != b.detection) {
+        return a.detection < b.detection;
+    }
+    return a.track < b.track;
+}
+
+/**
+ * @brief 按IoU降序贪心选择workspace.edges中的边
+ */
+void greedyFromEdges(size_t rows, size_t cols, AssignmentWorkspace& workspace, AssociationResult& result) {
+    std::vector<Match>& edges = workspace.edges;
+    std::sort(edges.begin(), edges.end(), edgeGreater);
+
+    workspace.row_used.assign(rows, 0);
+    workspace.col_used.assign(cols, 0);
+    for (size_t k = 0; k < edges.size(); ++k) {
+        const Match& edge = edges[k];
+        if (workspace.row_used[edge.detection] || workspace.col_used[edge.track]) {
+            continue;
+        }
+        workspace.row_used[edge.detection] = 1;
+        workspace.col_used[edge.track] = 1;
+        result.matches.push_back(edge);
+    }
+}
+
+/**
+ * @brief 对匹配排序并补全未匹配的行和列
+ */
+void finalizeResult(size_t rows, size_t cols, AssignmentWorkspace& workspace, AssociationResult& result) {
+    std::sort(result.matches.begin(), result.matches.end(), [](const Match& a, const Match& b) {
+        return a.detection < b.detection;
+    });
+
+    workspace.row_used.assign(rows, 0);
+    workspace.col_used.assign(cols, 0);
+    for (size_t k = 0; k < result.matches.size(); ++k) {
+        workspace.row_used[result.matches[k].detection] = 1;
+        workspace.col_used[result.matches[k].track] = 1;
+    }
+    for (size_t i = 0; i < rows; ++i) {
+        if (!workspace.row_used[i]) {
+            result.unmatched_detections.push_back(static_cast<int>(i));
+        }
+    }
+    for (size_t j = 0; j < cols; ++j) {
+        if (!workspace.col_used[j]) {
+            result.unmatched_tracks.push_back(static_cast<int>(j));
+        }
+    }
+}
+
+void resetResult(AssociationResult& result) {
+    result.matches.clear();
+    result.unmatched_detections.clear();
+    result.unmatched_tracks.clear();
+}
+
+/**
+ * @brief 最大权匹配（最短增广路形式的匈牙利算法）
+ * weight(i, j)为非负权重，不可匹配的元素权重为0，与不匹配等价。
+ * 行数多于列数时在转置问题上求解，保证每轮增广都能成功。
+ * 结果写入workspace.row_match（每行匹配的列，未匹配为-1）
+ */
+template <typename Weight>
+void solveMaxWeight(size_t rows, size_t cols, const Weight& weight, AssignmentWorkspace& workspace) {
+    std::vector<int>& row_match = workspace.row_match;
+    row_match.assign(rows, -1);
+    if (rows == 0 || cols == 0) {
+        return;
+    }
+
+    const bool transposed = rows > cols;
+    const size_t n = transposed ? cols : rows;
+    const size_t m = transposed ? rows : cols;
+    const double inf = std::numeric_limits<double>::infinity();
+
+    // 下标从1开始，p[j]为第j列匹配的行，第0列是增广路的虚拟起点
+    std::vector<double>& u = workspace.u;
+    std::vector<double>& v = workspace.v;
+    std::vector<double>& min_slack = workspace.min_slack;
+    std::vector<size_t>& p = workspace.p;
+    std::vector<size_t>& way = workspace.way;
+    std::vector<char>& used = workspace.used;
+    u.assign(n + 1, 0.0);
+    v.assign(m + 1, 0.0);
+    min_slack.resize(m + 1);
+    p.assign(m + 1, 0);
+    way.assign(m + 1, 0);
+    used.resize(m + 1);
+
+    for (size_t i = 1; i <= n; ++i) {
+        p[0] = i;
+        size_t j0 = 0;
+        std::fill(min_slack.begin(), min_slack.end(), inf);
+        std::fill(used.begin(), used.end(), 0);
+
+        do {
+            used[j0] = 1;
+            size_t i0 = p[j0];
+            double delta = inf;
+            size_t j1 = 0;
+            for (size_t j = 1; j <= m; ++j) {
+                if (used[j]) {
+                    continue;
+                }
+                double cost = -static_cast<double>(transposed ? weight(j - 1, i0 - 1)
+                                                              : weight(i0 - 1, j - 1));
+                double slack = cost - u[i0] - v[j];
+                if (slack < min_slack[j]) {
+                    min_slack[j] = slack;
+                    way[j] = j0;
+                }
+                if (min_slack[j] < delta) {
+                    delta = min_slack[j];
+                    j1 = j;
+                }
+            }
+            for (size_t j = 0; j <= m; ++j) {
+                if (used[j]) {
+                    u[p[j]] += delta;
+                    v[j] -= delta;
+                } else {
+                    min_slack[j] -= delta;
+                }
+            }
+            j0 = j1;
+        } while (p[j0] != 0);
+
+        // 沿增广路翻转匹配
+        do {
+            size_t j1 = way[j0];
+            p[j0] = p[j1];
+            j0 = j1;
+        } while (j0 != 0);
+    }
+
+    for (size_t j = 1; j <= m; ++j) {
+        if (p[j] == 0) {
+            continue;
+        }
+        if (transposed) {
+            row_match[j - 1] = static_cast<int>(p[j] - 1);
+        } else {
+            row_match[p[j] - 1] = static_cast<int>(j - 1);
+        }
+    }
+}
+
+/**
+ * @brief 稠密矩阵的门限权重
+ */
+struct DenseWeight {
+    const float* iou;
+    size_t cols;
+    float threshold;
+
+    float operator()(size_t i, size_t j) const {
+        float value = iou[i * cols + j];
+        return passesGate(value, threshold) ? value : 0.0f;
+    }
+};
+
+/**
+ * @brief 单个连通分量内的稠密权重
+ */
+struct ComponentWeight {
+    const float* values;
+    size_t cols;
+
+    float operator()(size_t i, size_t j) const {
+        return values[i * cols + j];
+    }
+};
+
+int findRoot(std::vector<int>& parent, int x) {
+    while (parent[x] != x) {
+        parent[x] = parent[parent[x]];
+        x = parent[x];
+    }
+    return x;
+}
+
+/**
+ * @brief 去掉类别不同的元素（原地压缩CSR）
+ */
+void maskSparseByClass(const std::vector<Box>& detections, const std::vector<Box>& tracks,
+                       SparseIoUMatrix& matrix) {
+    size_t write = 0;
+    size_t begin = 0;
+    for (size_t i = 0; i < matrix.rows; ++i) {
+        size_t end = matrix.row_ptr[i + 1];
+        for (size_t k = begin; k < end; ++k) {
+            if (detections[i].class_id == tracks[matrix.col_index[k]].class_id) {
+                matrix.col_index[write] = matrix.col_index[k];
+                matrix.values[write] = matrix.values[k];
+                ++write;
+            }
+        }
+        begin = end;
+        matrix.row_ptr[i + 1] = static_cast<int>(write);
+    }
+    matrix.col_index.resize(write);
+    matrix.values.resize(write);
+}
+
+void maskDenseByClass(const std::vector<Box>& detections, const std::vector<Box>& tracks,
+                      float* iou) {
+    for (size_t i = 0; i < detections.size(); ++i) {
+        float* row = iou + i * tracks.size();
+        for (size_t j = 0; j < tracks.size(); ++j) {
+            if (detections[i].class_id != tracks[j].class_id) {
+                row[j] = 0.0f;
+            }
+        }
+    }
+}
+
+void solveDense(const float* iou, size_t rows, size_t cols, const AssociationConfig& config,
+                AssociationResult& result) {
+    if (config.method == AssignmentMethod::GREEDY) {
+        greedyAssignment(iou, rows, cols, config.iou_threshold, result);
+    } else {
+        hungarianAssignment(iou, rows, cols, config.iou_threshold, result);
+    }
+}
+
+AssociationResult associateSparse(const std::vector<Box>& detections, const std::vector<Box>& tracks,
+                                  const AssociationConfig& config, Executor& executor) {
+    SparseIoUMatrix matrix;
+    if (config.iou_type == IoUType::IOU_3D) {
+        calculateSparseIoU3DMatrix(detections, tracks, matrix, executor);
+    } else {
+        calculateSparseBEVIoUMatrix(detections, tracks, matrix, executor);
+    }
+    if (config.class_aware) {
+        maskSparseByClass(detections, tracks, matrix);
+    }
+
+    AssociationResult result;
+    if (config.method == AssignmentMethod::GREEDY) {
+        greedyAssignment(matrix, config.iou_threshold, result);
+    } else {
+        hungarianAssignment(matrix, config.iou_threshold, result);
+    }
+    return result;
+}
+
+} // namespace
+
+void greedyAssignment(const float* iou, size_t rows, size_t cols, float threshold,
+                      AssociationResult& result) {
+    AssignmentWorkspace workspace;
+    greedyAssignment(iou, rows, cols, threshold, result, workspace);
+}
+
+void greedyAssignment(const float* iou, size_t rows, size_t cols, float threshold,
+                      AssociationResult& result, AssignmentWorkspace& workspace) {
+    resetResult(result);
+
+    workspace.edges.clear();
+    for (size_t i = 0; i < rows; ++i) {
+        const float* row = iou + i * cols;
+        for (size_t j = 0; j < cols; ++j) {
+            if (passesGate(row[j], threshold)) {
+                workspace.edges.push_back(makeMatch(static_cast<int>(i), static_cast<int>(j), row[j]));
+            }
+        }
+    }
+
+    greedyFromEdges(rows, cols, workspace, result);
+    finalizeResult(rows, cols, workspace, result);
+}
+
+void hungarianAssignment(const float* iou, size_t rows, size_t cols, float threshold,
+                         AssociationResult& result) {
+    AssignmentWorkspace workspace;
+    hungarianAssignment(iou, rows, cols, threshold, result, workspace);
+}
+
+void hungarianAssignment(const float* iou, size_t rows, size_t cols, float threshold,
+                         AssociationResult& result, AssignmentWorkspace& workspace) {
+    resetResult(result);
+
+    DenseWeight weight;
+    weight.iou = iou;
+    weight.cols = cols;
+    weight.threshold = threshold;
+
+    solveMaxWeight(rows, cols, weight, workspace);
+
+    // 权重为0的分配只是补齐，不算匹配
+    const std::vector<int>& row_match = workspace.row_match;
+    for (size_t i = 0; i < rows; ++i) {
+        if (row_match[i] < 0) {
+            continue;
+        }
+        float value = weight(i, row_match[i]);
+        if (value > 0.0f) {
+            result.matches.push_back(makeMatch(static_cast<int>(i), row_match[i], value));
+        }
+    }
+
+    finalizeResult(rows, cols, workspace, result);
+}
+
+void greedyAssignment(const SparseIoUMatrix& iou, float threshold, AssociationResult& result) {
+    AssignmentWorkspace workspace;
+    greedyAssignment(iou, threshold, result, workspace);
+}
+
+void greedyAssignment(const SparseIoUMatrix& iou, float threshold, AssociationResult& result,
+                      AssignmentWorkspace& workspace) {
+    resetResult(result);
+
+    workspace.edges.clear();
+    for (size_t i = 0; i < iou.rows; ++i) {
+        for (int k = iou.row_ptr[i]; k < iou.row_ptr[i + 1]; ++k) {
+            if (passesGate(iou.values[k], threshold)) {
+                workspace.edges.push_back(makeMatch(static_cast<int>(i), iou.col_index[k], iou.values[k]));
+            }
+        }
+    }
+
+    greedyFromEdges(iou.rows, iou.cols, workspace, result);
+    finalizeResult(iou.rows, iou.cols, workspace, result);
+}
+
+void hungarianAssignment(const SparseIoUMatrix& iou, float threshold, AssociationResult& result) {
+    AssignmentWorkspace workspace;
+    hungarianAssignment(iou, threshold, result, workspace);
+}
+
+void hungarianAssignment(const SparseIoUMatrix& iou, float threshold, AssociationResult& result,
+                         AssignmentWorkspace& workspace) {
+    resetResult(result);
+
+    // 节点0..rows-1为行，rows..rows+cols-1为列
+    std::vector<int>& parent = workspace.parent;
+    parent.resize(iou.rows + iou.cols);
+    for (size_t k = 0; k < parent.size(); ++k) {
+        parent[k] = static_cast<int>(k);
+    }
+
+    std::vector<Match>& edges = workspace.edges;
+    edges.clear();
+    for (size_t i = 0; i < iou.rows; ++i) {
+        for (int k = iou.row_ptr[i]; k < iou.row_ptr[i + 1]; ++k) {
+            if (!passesGate(iou.values[k], threshold)) {
+                continue;
+            }
+            Match edge = makeMatch(static_cast<int>(i), iou.col_index[k], iou.values[k]);
+            edges.push_back(edge);
+
+            int a = findRoot(parent, edge.detection);
+            int b = findRoot(parent, static_cast<int>(iou.rows) + edge.track);
+            if (a != b) {
+                parent[a] = b;
+            }
+        }
+    }
+
+    // 按连通分量分组，分量内保持行优先顺序
+    std::vector<int>& component = workspace.component;
+    std::vector<int>& order = workspace.order;
+    component.resize(edges.size());
+    order.resize(edges.size());
+    for (size_t k = 0; k < edges.size(); ++k) {
+        component[k] = findRoot(parent, edges[k].detection);
+        order[k] = static_cast<int>(k);
+    }
+    std::sort(order.begin(), order.end(), [&component](int a, int b) {
+        return component[a] != component[b] ? component[a] < component[b] : a < b;
+    });
+
+    std::vector<int>& local_row = workspace.local_row;
+    std::vector<int>& local_col = workspace.local_col;
+    std::vector<int>& rows = workspace.component_rows;
+    std::vector<int>& cols = workspace.component_cols;
+    std::vector<float>& values = workspace.component_values;
+    local_row.assign(iou.rows, -1);
+    local_col.assign(iou.cols, -1);
+
+    size_t begin = 0;
+    while (begin < order.size()) {
+        size_t end = begin;
+        while (end < order.size() && component[order[end]] == component[order[begin]]) {
+            ++end;
+        }
+
+        rows.clear();
+        cols.clear();
+        for (size_t k = begin; k < end; ++k) {
+            const Match& edge = edges[order[k]];
+            if (local_row[edge.detection] < 0) {
+                local_row[edge.detection] = static_cast<int>(rows.size());
+                rows.push_back(edge.detection);
+            }
+            if (local_col[edge.track] < 0) {
+                local_col[edge.track] = static_cast<int>(cols.size());
+                cols.push_back(edge.track);
+            }
+        }
+
+        values.assign(rows.size() * cols.size(), 0.0f);
+        for (size_t k = begin; k < end; ++k) {
+            const Match& edge = edges[order[k]];
+            values[local_row[edge.detection] * cols.size() + local_col[edge.track]] = edge.iou;
+        }
+
+        ComponentWeight weight;
+        weight.values = values.data();
+        weight.cols = cols.size();
+        solveMaxWeight(rows.size(), cols.size(), weight, workspace);
+
+        const std::vector<int>& row_match = workspace.row_match;
+        for (size_t r = 0; r < rows.size(); ++r) {
+            if (row_match[r] >= 0 && weight(r, row_match[r]) > 0.0f) {
+                result.matches.push_back(makeMatch(rows[r], cols[row_match[r]], weight(r, row_match[r])));
+            }
+        }
+
+        for (size_t r = 0; r < rows.size(); ++r) {
+            local_row[rows[r]] = -1;
+        }
+        for (size_t c = 0; c < cols.size(); ++c) {
+            local_col[cols[c]] = -1;
+        }
+        begin = end;
+    }
+
+    finalizeResult(iou.rows, iou.cols, workspace, result);
+}
+
+AssociationResult associate(const std::vector<Box>& detections, const std::vector<Box>& tracks,
+                            const AssociationConfig& config) {
+    SerialExecutor executor;
+    return associate(detections, tracks, config, executor);
+}
+
+AssociationResult associate(const std::vector<Box>& detections, const std::vector<Box>& tracks,
+                            const AssociationConfig& config, Executor& executor) {
+    IOU3D_STAGE_TIMER(Stage::ASSOCIATION);
+    if (config.sparse) {
+        return associateSparse(detections, tracks, config, executor);
+    }
+
+    // 分配器直接读取库计算的矩阵，不再拷贝
+    std::vector<float> iou(detections.size() * tracks.size());
+    if (config.iou_type == IoUType::IOU_3D) {
+        calculateIoU3DMatrix(detections, tracks, iou.data(), executor);
+    } else {
+        calculateBEVIoUMatrix(detections, tracks, iou.data(), executor);
+    }
+    if (config.class_aware) {
+        maskDenseByClass(detections, tracks, iou.data());
+    }
+
+    AssociationResult result;
+    solveDense(iou.data(), detections.size(), tracks.size(), config, result);
+    return result;
+}
+
+} // namespace nms
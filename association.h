@@ -0,0 +1,151 @@
+#pragma once
+
+#include "iou3d.h"
+#include "nms.h"
+#include "broad_phase.h"
+
+#include <vector>
+#include <cstddef>
+
+namespace nms {
+
+/**
+ * @brief 检测框与轨迹框的分配算法
+ */
+enum class AssignmentMethod {
+    GREEDY,    // 按IoU降序贪心匹配
+    HUNGARIAN  // 匈牙利算法（最短增广路），IoU总和最大
+};
+
+/**
+ * @brief 数据关联参数
+ */
+struct AssociationConfig {
+    // 门限：IoU低于该值的框对不参与匹配
+    float iou_threshold = 0.1f;
+    // 使用BEV IoU还是3D IoU作为匹配得分
+    IoUType iou_type = IoUType::IOU_3D;
+    // 为true时只在相同class_id的框之间匹配
+    bool class_aware = true;
+    AssignmentMethod method = AssignmentMethod::HUNGARIAN;
+    // 为true时通过网格粗筛只计算相交的框对（稀疏矩阵），并按连通分量分别求解
+    bool sparse = false;
+};
+
+/**
+ * @brief 一对匹配结果
+ */
+struct Match {
+    int detection;  // 检测框索引（IoU矩阵的行）
+    int track;      // 轨迹框索引（IoU矩阵的列）
+    float iou;
+};
+
+/**
+ * @brief 数据关联结果
+ * matches按检测框索引升序，未匹配的索引均为升序
+ */
+struct AssociationResult {
+    std::vector<Match> matches;
+    std::vector<int> unmatched_detections;
+    std::vector<int> unmatched_tracks;
+};
+
+/**
+ * @brief 分配算法使用的缓冲区
+ * 逐帧复用同一个工作区时，各缓冲区的容量达到峰值后不再重新分配内存
+ */
+struct AssignmentWorkspace {
+    // 高于门限的候选对
+    std::vector<Match> edges;
+    std::vector<char> row_used;
+    std::vector<char> col_used;
+    // 匈牙利算法的对偶变量与增广路
+    std::vector<double> u;
+    std::vector<double> v;
+    std::vector<double> min_slack;
+    std::vector<size_t> p;
+    std::vector<size_t> way;
+    std::vector<char> used;
+    std::vector<int> row_match;
+    // 稀疏模式的连通分量
+    std::vector<int> parent;
+    std::vector<int> component;
+    std::vector<int> order;
+    std::vector<int> local_row;
+    std::vector<int> local_col;
+    std::vector<int> component_rows;
+    std::vector<int> component_cols;
+    std::vector<float> component_values;
+};
+
+/**
+ * @brief 在行优先的稠密IoU矩阵上贪心分配
+ * 按IoU降序（相同时行号、列号小的优先）依次接受两端都未匹配且不低于门限的框对
+ * @param iou rows×cols的IoU矩阵（例如calculateIoU3DMatrix的输出）
+ * @param threshold 门限
+ * @param result 输出的分配结果
+ */
+void greedyAssignment(const float* iou, size_t rows, size_t cols, float threshold,
+                      AssociationResult& result);
+
+/**
+ * @brief 同上，使用调用方提供的工作区
+ */
+void greedyAssignment(const float* iou, size_t rows, size_t cols, float threshold,
+                      AssociationResult& result, AssignmentWorkspace& workspace);
+
+/**
+ * @brief 在行优先的稠密IoU矩阵上求IoU总和最大的分配（匈牙利算法）
+ * 低于门限的元素视为不可匹配，复杂度O(min(rows,cols)^2 * max(rows,cols))
+ */
+void hungarianAssignment(const float* iou, size_t rows, size_t cols, float threshold,
+                         AssociationResult& result);
+
+/**
+ * @brief 同上，使用调用方提供的工作区
+ */
+void hungarianAssignment(const float* iou, size_t rows, size_t cols, float threshold,
+                         AssociationResult& result, AssignmentWorkspace& workspace);
+
+/**
+ * @brief 在稀疏IoU矩阵上贪心分配，只遍历非零元素
+ */
+void greedyAssignment(const SparseIoUMatrix& iou, float threshold, AssociationResult& result);
+
+/**
+ * @brief 同上，使用调用方提供的工作区
+ */
+void greedyAssignment(const SparseIoUMatrix& iou, float threshold, AssociationResult& result,
+                      AssignmentWorkspace& workspace);
+
+/**
+ * @brief 在稀疏IoU矩阵上求最优分配
+ * 用并查集把高于门限的边划分为连通分量，每个分量单独运行匈牙利算法，
+ * 不同分量之间的框对从不生成稠密矩阵
+ */
+void hungarianAssignment(const SparseIoUMatrix& iou, float threshold, AssociationResult& result);
+
+/**
+ * @brief 同上，使用调用方提供的工作区
+ */
+void hungarianAssignment(const SparseIoUMatrix& iou, float threshold, AssociationResult& result,
+                         AssignmentWorkspace& workspace);
+
+/**
+ * @brief 计算检测框与轨迹框之间的IoU并完成分配
+ * @param detections 检测框（矩阵的行）
+ * @param tracks 轨迹框（矩阵的列）
+ * @param config 关联参数
+ * @return 分配结果
+ */
+AssociationResult associate(const std::vector<Box>& detections, const std::vector<Box>& tracks,
+                            const AssociationConfig& config = AssociationConfig());
+
+/**
+ * @brief 并行计算IoU矩阵（稠密或config.sparse时的稀疏矩阵）后完成分配（分配本身为串行）
+ */
+AssociationResult associate(const std::vector<Box>& detections, const std::vector<Box>& tracks,
+                            const AssociationConfig& config, Executor& executor);
+
+} // namespace nms
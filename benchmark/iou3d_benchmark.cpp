@@ -0,0 +1,527 @@
+#include "iou3d.h"
+#include "nms.h"
+#include "box_batch.h"
+#include "broad_phase.h"
+#include "executor.h"
+#include "iou_loss.h"
+#include "pipeline.h"
+#include "box6dof.h"
+#include "evaluation.h"
+#include "track_cache.h"
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+#include <random>
+#include <cmath>
+#include <algorithm>
+
+using namespace nms;
+
+namespace {
+
+// 重叠密度：场景边长越小，框对之间重叠越多
+enum Density { SPARSE = 0, DENSE = 1 };
+// 朝向分布：全部对齐坐标轴或均匀随机
+enum YawDistribution { ALIGNED = 0, RANDOM_YAW = 1 };
+
+const char* densityName(int density) { return density == DENSE ? "dense" : "sparse"; }
+const char* yawName(int yaw) { return yaw == RANDOM_YAW ? "random_yaw" : "aligned"; }
+
+/**
+ * @brief 生成测试场景
+ * 稀疏场景：200m×200m内均匀分布；密集场景：框聚集在少量簇中，簇内大量重叠
+ */
+std::vector<Box> generateScene(size_t count, int density, int yaw_distribution, unsigned seed = 1) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> jitter(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> angle(-3.14159265f, 3.14159265f);
+    std::uniform_real_distribution<float> score(0.0f, 1.0f);
+
+    const int cluster_size = density == DENSE ? 16 : 1;
+    std::vector<Box> boxes;
+    boxes.reserve(count);
+    while (boxes.size() < count) {
+        float cx = position(rng);
+        float cz = position(rng);
+        float yaw = yaw_distribution == RANDOM_YAW ? angle(rng) : 0.0f;
+        for (int k = 0; k < cluster_size && boxes.size() < count; ++k) {
+            Box box;
+            box.class_name = "car";
+            box.class_id = 0;
+            box.center_x = cx + (density == DENSE ? jitter(rng) : 0.0f);
+            box.center_y = 0.2f * jitter(rng);
+            box.center_z = cz + (density == DENSE ? jitter(rng) : 0.0f);
+            box.length = 4.2f + 0.3f * jitter(rng);
+            box.width = 1.8f + 0.2f * jitter(rng);
+            box.height = 1.6f;
+            box.yaw = yaw_distribution == RANDOM_YAW ? yaw + 0.2f * jitter(rng) : 0.0f;
+            box.confidence = score(rng);
+            boxes.push_back(box);
+        }
+    }
+    return boxes;
+}
+
+/**
+ * @brief 生成逐对测试用的框对，overlap_ratio比例的框对相互重叠
+ */
+void generatePairs(size_t count, int density, int yaw_distribution,
+                   std::vector<Box>& first, std::vector<Box>& second) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    first = generateScene(count, SPARSE, yaw_distribution, 3);
+    second = first;
+    // 密集：95%的框对重叠；稀疏：5%的框对重叠
+    const float overlap_ratio = density == DENSE ? 0.95f : 0.05f;
+    for (size_t i = 0; i < count; ++i) {
+        if (unit(rng) < overlap_ratio) {
+            second[i].center_x += 1.5f * (unit(rng) - 0.5f);
+            second[i].center_z += 1.5f * (unit(rng) - 0.5f);
+            if (yaw_distribution == RANDOM_YAW) {
+                second[i].yaw += unit(rng) - 0.5f;
+            }
+        } else {
+            second[i].center_x += 20.0f;
+        }
+    }
+}
+
+void setPairCounters(benchmark::State& state, double pairs_per_iteration) {
+    state.counters["pairs/s"] = benchmark::Counter(pairs_per_iteration, benchmark::Counter::kIsIterationInvariantRate);
+    state.counters["time/pair"] = benchmark::Counter(pairs_per_iteration,
+                                                     benchmark::Counter::kIsIterationInvariantRate |
+                                                     benchmark::Counter::kInvert);
+}
+
+void setLabel(benchmark::State& state, int density, int yaw_distribution) {
+    state.SetLabel(std::string(densityName(density)) + "/" + yawName(yaw_distribution));
+}
+
+// ---------------------------------------------------------------------------
+// 单框/单对内核
+// ---------------------------------------------------------------------------
+
+void BM_BoxToBEVPolygon(benchmark::State& state) {
+    std::vector<Box> boxes = generateScene(1024, SPARSE, RANDOM_YAW);
+    for (auto _ : state) {
+        for (size_t i = 0; i < boxes.size(); ++i) {
+            Polygon2D polygon = boxToBEVPolygon(boxes[i]);
+            benchmark::DoNotOptimize(polygon.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * boxes.size());
+}
+BENCHMARK(BM_BoxToBEVPolygon);
+
+void BM_ComputeBEVCorners(benchmark::State& state) {
+    // 第二个参数为availableSimdBackends()中的下标，当前CPU不支持的后端跳过
+    std::vector<std::string> backends = availableSimdBackends();
+    const size_t backend = static_cast<size_t>(state.range(1));
+    if (backend >= backends.size()) {
+        state.SkipWithError("backend not available");
+        return;
+    }
+    const std::string previous = simdBackendName();
+    setSimdBackend(backends[backend]);
+    BoxBatch batch = BoxBatch::fromBoxes(generateScene(state.range(0), SPARSE, RANDOM_YAW));
+    BEVCornerBatch corners;
+    for (auto _ : state) {
+        computeBEVCorners(batch, corners);
+        benchmark::DoNotOptimize(corners.x[0].data());
+    }
+    state.SetItemsProcessed(state.iterations() * batch.size());
+    state.SetLabel(simdBackendName());
+    setSimdBackend(previous);
+}
+BENCHMARK(BM_ComputeBEVCorners)->ArgsProduct({{1024, 16384}, {0, 1, 2, 3, 4}});
+
+void BM_BEVIoUOneToMany(benchmark::State& state) {
+    // 第二个参数为availableSimdBackends()中的下标，-1为逐对调用PreparedBox版本的calculateBEVIoU
+    // 稀疏：参考框对整个稀疏场景；密集：与NMS内层循环类似，候选框都在参考框附近且大部分重叠
+    const int density = static_cast<int>(state.range(0));
+    const Box ref = generateScene(1, SPARSE, RANDOM_YAW, 5)[0];
+    std::vector<Box> boxes = generateScene(1024, SPARSE, RANDOM_YAW);
+    if (density == DENSE) {
+        std::mt19937 rng(9);
+        std::uniform_real_distribution<float> jitter(-1.0f, 1.0f);
+        for (size_t i = 0; i < boxes.size(); ++i) {
+            boxes[i].center_x = ref.center_x + 1.5f * jitter(rng);
+            boxes[i].center_z = ref.center_z + 1.5f * jitter(rng);
+            boxes[i].yaw = ref.yaw + 0.5f * jitter(rng);
+        }
+    }
+    BoxBatch others = BoxBatch::fromBoxes(boxes);
+    std::vector<float> iou(others.size());
+
+    if (state.range(1) < 0) {
+        std::vector<PreparedBox> prepared(boxes.size());
+        for (size_t i = 0; i < boxes.size(); ++i) {
+            prepareBox(boxes[i], prepared[i]);
+        }
+        PreparedBox prepared_ref;
+        for (auto _ : state) {
+            prepareBox(ref, prepared_ref);
+            for (size_t i = 0; i < prepared.size(); ++i) {
+                iou[i] = calculateBEVIoU(prepared_ref, prepared[i]);
+            }
+            benchmark::DoNotOptimize(iou.data());
+        }
+        setPairCounters(state, static_cast<double>(others.size()));
+        state.SetLabel(std::string(densityName(density)) + "/pairwise");
+        return;
+    }
+
+    std::vector<std::string> backends = availableSimdBackends();
+    const size_t backend = static_cast<size_t>(state.range(1));
+    if (backend >= backends.size()) {
+        state.SkipWithError("backend not available");
+        return;
+    }
+    const std::string previous = simdBackendName();
+    setSimdBackend(backends[backend]);
+    for (auto _ : state) {
+        calculateBEVIoUOneToMany(ref, others, iou.data());
+        benchmark::DoNotOptimize(iou.data());
+    }
+    setPairCounters(state, static_cast<double>(others.size()));
+    state.SetLabel(std::string(densityName(density)) + "/" + simdBackendName());
+    setSimdBackend(previous);
+}
+BENCHMARK(BM_BEVIoUOneToMany)->ArgsProduct({{SPARSE, DENSE}, {-1, 0, 1, 2, 3, 4}});
+
+void BM_SutherlandHodgmanClip(benchmark::State& state) {
+    std::vector<Box> first, second;
+    generatePairs(1024, static_cast<int>(state.range(0)), static_cast<int>(state.range(1)), first, second);
+    std::vector<Polygon2D> polygons1, polygons2;
+    for (size_t i = 0; i < first.size(); ++i) {
+        polygons1.push_back(boxToBEVPolygon(first[i]));
+        polygons2.push_back(boxToBEVPolygon(second[i]));
+    }
+    for (auto _ : state) {
+        for (size_t i = 0; i < polygons1.size(); ++i) {
+            Polygon2D clipped = sutherlandHodgmanClip(polygons1[i], polygons2[i]);
+            benchmark::DoNotOptimize(clipped.data());
+        }
+    }
+    setPairCounters(state, static_cast<double>(polygons1.size()));
+    setLabel(state, static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+}
+BENCHMARK(BM_SutherlandHodgmanClip)->ArgsProduct({{SPARSE, DENSE}, {ALIGNED, RANDOM_YAW}});
+
+void BM_CalculateBEVIoU(benchmark::State& state) {
+    std::vector<Box> first, second;
+    generatePairs(1024, static_cast<int>(state.range(0)), static_cast<int>(state.range(1)), first, second);
+    for (auto _ : state) {
+        for (size_t i = 0; i < first.size(); ++i) {
+            benchmark::DoNotOptimize(calculateBEVIoU(first[i], second[i]));
+        }
+    }
+    setPairCounters(state, static_cast<double>(first.size()));
+    setLabel(state, static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+}
+BENCHMARK(BM_CalculateBEVIoU)->ArgsProduct({{SPARSE, DENSE}, {ALIGNED, RANDOM_YAW}});
+
+void BM_CalculateIoU3D(benchmark::State& state) {
+    std::vector<Box> first, second;
+    generatePairs(1024, static_cast<int>(state.range(0)), static_cast<int>(state.range(1)), first, second);
+    for (auto _ : state) {
+        for (size_t i = 0; i < first.size(); ++i) {
+            benchmark::DoNotOptimize(calculateIoU3D(first[i], second[i]));
+        }
+    }
+    setPairCounters(state, static_cast<double>(first.size()));
+    setLabel(state, static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+}
+BENCHMARK(BM_CalculateIoU3D)->ArgsProduct({{SPARSE, DENSE}, {ALIGNED, RANDOM_YAW}});
+
+// ---------------------------------------------------------------------------
+// 批量接口
+// ---------------------------------------------------------------------------
+
+void BM_IoU3DMatrix(benchmark::State& state) {
+    const size_t n = static_cast<size_t>(state.range(0));
+    std::vector<Box> boxes = generateScene(n, static_cast<int>(state.range(1)), RANDOM_YAW);
+    std::vector<float> matrix(n * n);
+    for (auto _ : state) {
+        calculateIoU3DMatrix(boxes, boxes, matrix.data());
+        benchmark::DoNotOptimize(matrix.data());
+    }
+    setPairCounters(state, static_cast<double>(n) * n);
+    setLabel(state, static_cast<int>(state.range(1)), RANDOM_YAW);
+}
+BENCHMARK(BM_IoU3DMatrix)->ArgsProduct({{64, 300, 1000}, {SPARSE, DENSE}})->Unit(benchmark::kMicrosecond);
+
+void BM_IoU6DoFMatrix(benchmark::State& state) {
+    const size_t n = static_cast<size_t>(state.range(0));
+    std::vector<Box> boxes = generateScene(n, static_cast<int>(state.range(1)), RANDOM_YAW);
+    std::vector<Box6DoF> boxes6(n);
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> tilt(-0.2f, 0.2f);
+    for (size_t i = 0; i < n; ++i) {
+        boxes6[i] = toBox6DoF(boxes[i]);
+        boxes6[i].pitch = tilt(rng);
+        boxes6[i].roll = tilt(rng);
+    }
+    std::vector<float> matrix(n * n);
+    for (auto _ : state) {
+        calculateIoU3DMatrix(boxes6, boxes6, matrix.data());
+        benchmark::DoNotOptimize(matrix.data());
+    }
+    setPairCounters(state, static_cast<double>(n) * n);
+    setLabel(state, static_cast<int>(state.range(1)), RANDOM_YAW);
+}
+BENCHMARK(BM_IoU6DoFMatrix)->ArgsProduct({{64, 300}, {SPARSE, DENSE}})->Unit(benchmark::kMicrosecond);
+
+void BM_BEVIoUMatrix(benchmark::State& state) {
+    const size_t n = static_cast<size_t>(state.range(0));
+    std::vector<Box> boxes = generateScene(n, static_cast<int>(state.range(1)), RANDOM_YAW);
+    std::vector<float> matrix(n * n);
+    for (auto _ : state) {
+        calculateBEVIoUMatrix(boxes, boxes, matrix.data());
+        benchmark::DoNotOptimize(matrix.data());
+    }
+    setPairCounters(state, static_cast<double>(n) * n);
+    setLabel(state, static_cast<int>(state.range(1)), RANDOM_YAW);
+}
+BENCHMARK(BM_BEVIoUMatrix)->ArgsProduct({{64, 300, 1000}, {SPARSE, DENSE}})->Unit(benchmark::kMicrosecond);
+
+void BM_BEVIoUMatrixParallel(benchmark::State& state) {
+    const size_t n = static_cast<size_t>(state.range(0));
+    std::vector<Box> boxes = generateScene(n, DENSE, RANDOM_YAW);
+    std::vector<float> matrix(n * n);
+    ThreadPool pool(static_cast<size_t>(state.range(1)));
+    for (auto _ : state) {
+        calculateBEVIoUMatrix(boxes, boxes, matrix.data(), pool);
+        benchmark::DoNotOptimize(matrix.data());
+    }
+    setPairCounters(state, static_cast<double>(n) * n);
+    state.SetLabel("threads=" + std::to_string(pool.concurrency()));
+}
+BENCHMARK(BM_BEVIoUMatrixParallel)->ArgsProduct({{1000}, {1, 2, 4, 8}})->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+void BM_SparseIoU3DMatrix(benchmark::State& state) {
+    const size_t n = static_cast<size_t>(state.range(0));
+    std::vector<Box> boxes = generateScene(n, static_cast<int>(state.range(1)), RANDOM_YAW);
+    SparseIoUMatrix matrix;
+    for (auto _ : state) {
+        calculateSparseIoU3DMatrix(boxes, boxes, matrix);
+        benchmark::DoNotOptimize(matrix.values.data());
+    }
+    setPairCounters(state, static_cast<double>(n) * n);
+    setLabel(state, static_cast<int>(state.range(1)), RANDOM_YAW);
+}
+BENCHMARK(BM_SparseIoU3DMatrix)->ArgsProduct({{1000, 5000}, {SPARSE, DENSE}})->Unit(benchmark::kMicrosecond);
+
+void BM_NMS(benchmark::State& state) {
+    const size_t n = static_cast<size_t>(state.range(0));
+    std::vector<Box> boxes = generateScene(n, DENSE, RANDOM_YAW);
+    NMSConfig config;
+    config.iou_type = state.range(1) ? IoUType::IOU_3D : IoUType::BEV;
+    for (auto _ : state) {
+        std::vector<int> keep = nonMaximumSuppression(boxes, config);
+        benchmark::DoNotOptimize(keep.data());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+    state.SetLabel(state.range(1) ? "3d" : "bev");
+}
+BENCHMARK(BM_NMS)->ArgsProduct({{1000, 10000}, {0, 1}})->Unit(benchmark::kMicrosecond);
+
+void BM_NMSParallel(benchmark::State& state) {
+    const size_t n = static_cast<size_t>(state.range(0));
+    std::vector<Box> boxes = generateScene(n, DENSE, RANDOM_YAW);
+    NMSConfig config;
+    ThreadPool pool(static_cast<size_t>(state.range(1)));
+    for (auto _ : state) {
+        std::vector<int> keep = nonMaximumSuppression(boxes, config, pool);
+        benchmark::DoNotOptimize(keep.data());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+    state.SetLabel("threads=" + std::to_string(pool.concurrency()));
+}
+BENCHMARK(BM_NMSParallel)->ArgsProduct({{10000}, {1, 4}})->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+void BM_NMSBitmask(benchmark::State& state) {
+    const size_t n = static_cast<size_t>(state.range(0));
+    std::vector<Box> boxes = generateScene(n, DENSE, RANDOM_YAW);
+    NMSConfig config;
+    ThreadPool pool(static_cast<size_t>(state.range(1)));
+    for (auto _ : state) {
+        std::vector<int> keep = bitmaskNonMaximumSuppression(boxes, config, pool);
+        benchmark::DoNotOptimize(keep.data());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+    state.SetLabel("threads=" + std::to_string(pool.concurrency()));
+}
+BENCHMARK(BM_NMSBitmask)->ArgsProduct({{1000, 10000}, {1, 4}})->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+void BM_NMSWorkspace(benchmark::State& state) {
+    const size_t n = static_cast<size_t>(state.range(0));
+    std::vector<Box> boxes = generateScene(n, DENSE, RANDOM_YAW);
+    NmsWorkspace workspace;
+    workspace.process(boxes);
+    for (auto _ : state) {
+        const std::vector<int>& keep = workspace.process(boxes);
+        benchmark::DoNotOptimize(keep.data());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_NMSWorkspace)->Arg(1000)->Arg(10000)->Unit(benchmark::kMicrosecond);
+
+void BM_FramePipeline(benchmark::State& state) {
+    const size_t n = static_cast<size_t>(state.range(0));
+    std::vector<Box> boxes = generateScene(n, DENSE, RANDOM_YAW);
+    std::vector<Box> tracks = generateScene(n / 4, DENSE, RANDOM_YAW, 7);
+    FramePipeline pipeline;
+    pipeline.associate(boxes, tracks);
+    for (auto _ : state) {
+        const AssociationResult& result = pipeline.associate(boxes, tracks);
+        benchmark::DoNotOptimize(result.matches.data());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_FramePipeline)->Arg(200)->Arg(1000)->Unit(benchmark::kMicrosecond);
+
+void BM_SoftNMS(benchmark::State& state) {
+    const size_t n = static_cast<size_t>(state.range(0));
+    std::vector<Box> boxes = generateScene(n, DENSE, RANDOM_YAW);
+    SoftNMSConfig config;
+    config.method = state.range(1) ? SoftNMSMethod::GAUSSIAN : SoftNMSMethod::LINEAR;
+    for (auto _ : state) {
+        SoftNMSResult result = softNonMaximumSuppression(boxes, config);
+        benchmark::DoNotOptimize(result.indices.data());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+    state.SetLabel(state.range(1) ? "gaussian" : "linear");
+}
+BENCHMARK(BM_SoftNMS)->ArgsProduct({{1000, 10000}, {0, 1}})->Unit(benchmark::kMicrosecond);
+
+void BM_WeightedBoxFusion(benchmark::State& state) {
+    const size_t n = static_cast<size_t>(state.range(0));
+    std::vector<Box> boxes = generateScene(n, DENSE, RANDOM_YAW);
+    for (auto _ : state) {
+        std::vector<Box> fused = weightedBoxFusion(boxes);
+        benchmark::DoNotOptimize(fused.data());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_WeightedBoxFusion)->Arg(1000)->Arg(10000)->Unit(benchmark::kMicrosecond);
+
+void BM_IoULossBatch(benchmark::State& state) {
+    const size_t n = static_cast<size_t>(state.range(0));
+    std::vector<Box> preds = generateScene(n, SPARSE, RANDOM_YAW, 1);
+    std::vector<Box> targets = preds;
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> jitter(-0.5f, 0.5f);
+    for (size_t i = 0; i < n; ++i) {
+        targets[i].center_x += jitter(rng);
+        targets[i].center_z += jitter(rng);
+        targets[i].yaw += jitter(rng);
+    }
+    std::vector<float> losses(n);
+    std::vector<BoxGradient> gradients(n);
+    const bool with_gradient = state.range(1) != 0;
+    for (auto _ : state) {
+        calculateIoULossBatch(preds, targets, IoULossType::GIOU, IoUType::IOU_3D, losses.data(),
+                              with_gradient ? gradients.data() : nullptr);
+        benchmark::DoNotOptimize(losses.data());
+    }
+    setPairCounters(state, static_cast<double>(n));
+    state.SetLabel(with_gradient ? "giou+grad" : "giou");
+}
+BENCHMARK(BM_IoULossBatch)->ArgsProduct({{100000}, {0, 1}})->Unit(benchmark::kMillisecond);
+
+void BM_SortByConfidence(benchmark::State& state) {
+    // 0: Box（含std::string），1: BoxPOD
+    const size_t n = 50000;
+    std::vector<Box> boxes = generateScene(n, SPARSE, RANDOM_YAW);
+    for (size_t i = 0; i < n; ++i) {
+        boxes[i].class_name = "Pedestrian_with_long_name";
+    }
+    std::vector<BoxPOD> pods = toBoxPODs(boxes);
+    const bool pod = state.range(0) != 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::vector<Box> box_copy = pod ? std::vector<Box>() : boxes;
+        std::vector<BoxPOD> pod_copy = pod ? pods : std::vector<BoxPOD>();
+        state.ResumeTiming();
+        if (pod) {
+            std::sort(pod_copy.begin(), pod_copy.end(),
+                      [](const BoxPOD& a, const BoxPOD& b) { return a.confidence > b.confidence; });
+            benchmark::DoNotOptimize(pod_copy.data());
+        } else {
+            std::sort(box_copy.begin(), box_copy.end(),
+                      [](const Box& a, const Box& b) { return a.confidence > b.confidence; });
+            benchmark::DoNotOptimize(box_copy.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+    state.SetLabel(pod ? "BoxPOD" : "Box");
+}
+BENCHMARK(BM_SortByConfidence)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+void BM_Evaluate(benchmark::State& state) {
+    // 每帧100个真值框，检测框为带噪声的真值加上误检
+    const size_t num_frames = 1000;
+    std::vector<EvalFrame> frames(num_frames);
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> jitter(-0.5f, 0.5f);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    for (size_t f = 0; f < num_frames; ++f) {
+        frames[f].ground_truth = generateScene(100, SPARSE, RANDOM_YAW, static_cast<unsigned>(f));
+        frames[f].detections = generateScene(20, SPARSE, RANDOM_YAW, static_cast<unsigned>(f + num_frames));
+        for (size_t i = 0; i < frames[f].ground_truth.size(); ++i) {
+            Box det = frames[f].ground_truth[i];
+            det.center_x += jitter(rng);
+            det.center_z += jitter(rng);
+            det.confidence = unit(rng);
+            frames[f].detections.push_back(det);
+        }
+    }
+    EvalConfig config;
+    config.iou_thresholds = {0.5f, 0.55f, 0.6f, 0.65f, 0.7f, 0.75f, 0.8f, 0.85f, 0.9f, 0.95f};
+    ThreadPool pool(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        EvaluationResult result = evaluate(frames, config, pool);
+        benchmark::DoNotOptimize(result.classes.data());
+    }
+    state.SetItemsProcessed(state.iterations() * num_frames);
+}
+BENCHMARK(BM_Evaluate)->Arg(1)->Arg(4)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+void BM_TrackIoU(benchmark::State& state) {
+    // 0: 每帧从头计算，1: TrackIoUCache；每帧5%的轨迹移动
+    const size_t n = static_cast<size_t>(state.range(0));
+    const bool cached = state.range(1) != 0;
+    std::vector<Box> tracks = generateScene(n, DENSE, RANDOM_YAW);
+    std::vector<Box> detections = generateScene(n, DENSE, RANDOM_YAW, 5);
+    std::vector<int> ids(n);
+    for (size_t i = 0; i < n; ++i) ids[i] = static_cast<int>(i);
+    TrackIoUCache cache;
+    cache.update(ids, tracks);
+    SparseIoUMatrix track_pairs;
+    SparseIoUMatrix result;
+    size_t frame = 0;
+    for (auto _ : state) {
+        for (size_t i = frame % 20; i < n; i += 20) {
+            tracks[i].center_x += (frame / 20) % 2 == 0 ? 0.1f : -0.1f;
+        }
+        ++frame;
+        if (cached) {
+            cache.update(ids, tracks);
+            cache.computeIoU(detections, result);
+        } else {
+            calculateSparseIoU3DMatrix(tracks, tracks, track_pairs);
+            calculateSparseIoU3DMatrix(detections, tracks, result);
+        }
+        benchmark::DoNotOptimize(result.values.data());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+    state.SetLabel(cached ? "cached" : "full");
+}
+BENCHMARK(BM_TrackIoU)->ArgsProduct({{200, 1000}, {0, 1}})->Unit(benchmark::kMicrosecond);
+
+} // namespace
+
+BENCHMARK_MAIN();
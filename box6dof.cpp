@@ -0,0 +1,380 @@
+#include "box6dof.h"
+#include "executor.h"
+#include <cmath>
+#include <algorithm>
+
+namespace nms {
+
+namespace {
+
+struct Vec3 {
+    double x;
+    double y;
+    double z;
+};
+
+inline double coordinate(const Vec3& p, int axis) {
+    return axis == 0 ? p.x : (axis == 1 ? p.y : p.z);
+}
+
+inline double det3(const Vec3& a, const Vec3& b, const Vec3& c) {
+    return a.x * (b.y * c.z - b.z * c.y) - a.y * (b.x * c.z - b.z * c.x) + a.z * (b.x * c.y - b.y * c.x);
+}
+
+// 立方体被6个平面裁剪后最多12个面，每个面最多10个顶点，留出余量
+const int kMaxFaces = 16;
+const int kMaxFaceVertices = 16;
+
+/**
+ * @brief 凸多面体的一个面，从外侧看顶点按逆时针排列
+ */
+struct Face {
+    Vec3 points[kMaxFaceVertices];
+    int count;
+
+    void push(const Vec3& p) {
+        if (count < kMaxFaceVertices) {
+            points[count++] = p;
+        }
+    }
+};
+
+struct Polyhedron {
+    Face faces[kMaxFaces];
+    int count;
+};
+
+/**
+ * @brief 裁剪平面上新产生的一条边
+ */
+struct CapEdge {
+    Vec3 from;
+    Vec3 to;
+};
+
+/**
+ * @brief 交点总是从内侧顶点出发计算，相邻两个面对同一条边得到完全相同的交点
+ */
+inline Vec3 crossing(const Vec3& inside, double d_inside, const Vec3& outside, double d_outside) {
+    double t = d_inside / (d_inside - d_outside);
+    Vec3 p = {inside.x + (outside.x - inside.x) * t,
+              inside.y + (outside.y - inside.y) * t,
+              inside.z + (outside.z - inside.z) * t};
+    return p;
+}
+
+inline double distance2(const Vec3& a, const Vec3& b) {
+    double dx = a.x - b.x;
+    double dy = a.y - b.y;
+    double dz = a.z - b.z;
+    return dx * dx + dy * dy + dz * dz;
+}
+
+/**
+ * @brief 用半空间 sign · p[axis] <= bound 裁剪凸多面体
+ * 每个面单独做Sutherland-Hodgman裁剪，被切开的面在平面上留下一条边，
+ * 这些边反向后首尾相连即为新的封闭面
+ * @return 裁剪后是否仍有面
+ */
+bool clipPolyhedron(const Polyhedron& input, int axis, double sign, double bound, Polyhedron& output) {
+    CapEdge edges[kMaxFaces];
+    int edge_count = 0;
+    output.count = 0;
+
+    for (int f = 0; f < input.count; ++f) {
+        const Face& face = input.faces[f];
+        Face& clipped = output.faces[output.count];
+        clipped.count = 0;
+
+        bool has_exit = false;
+        bool has_entry = false;
+        Vec3 exit_point = {0.0, 0.0, 0.0};
+        Vec3 entry_point = {0.0, 0.0, 0.0};
+        for (int k = 0; k < face.count; ++k) {
+            const Vec3& current = face.points[k];
+            const Vec3& next = face.points[(k + 1) % face.count];
+            double d_current = sign * coordinate(current, axis) - bound;
+            double d_next = sign * coordinate(next, axis) - bound;
+
+            if (d_current <= 0.0) {
+                clipped.push(current);
+                if (d_next > 0.0) {
+                    exit_point = crossing(current, d_current, next, d_next);
+                    clipped.push(exit_point);
+                    has_exit = true;
+                }
+            } else if (d_next <= 0.0) {
+                entry_point = crossing(next, d_next, current, d_current);
+                clipped.push(entry_point);
+                has_entry = true;
+            }
+        }
+
+        if (clipped.count >= 3) {
+            ++output.count;
+        }
+        // 面上的边为exit -> entry，封闭面上同一条边方向相反
+        if (has_exit && has_entry && edge_count < kMaxFaces) {
+            edges[edge_count].from = entry_point;
+            edges[edge_count].to = exit_point;
+            ++edge_count;
+        }
+    }
+
+    if (edge_count >= 3 && output.count < kMaxFaces) {
+        // 按首尾相接的顺序串起新边，交点一般逐位相同，否则取最近的起点
+        Face& cap = output.faces[output.count];
+        cap.count = 0;
+        bool used[kMaxFaces] = {false};
+        int current = 0;
+        used[0] = true;
+        cap.push(edges[0].from);
+        for (int step = 1; step < edge_count; ++step) {
+            int best = -1;
+            double best_distance = 0.0;
+            for (int e = 0; e < edge_count; ++e) {
+                if (used[e]) {
+                    continue;
+                }
+                double d = distance2(edges[e].from, edges[current].to);
+                if (best < 0 || d < best_distance) {
+                    best = e;
+                    best_distance = d;
+                }
+            }
+            used[best] = true;
+            current = best;
+            cap.push(edges[best].from);
+        }
+        ++output.count;
+    }
+
+    return output.count > 0;
+}
+
+/**
+ * @brief 由散度定理计算闭合多面体的体积：对每个面的扇形三角形累加det(p0, pk, pk+1) / 6
+ */
+double polyhedronVolume(const Polyhedron& polyhedron) {
+    double volume = 0.0;
+    for (int f = 0; f < polyhedron.count; ++f) {
+        const Face& face = polyhedron.faces[f];
+        for (int k = 1; k + 1 < face.count; ++k) {
+            volume += det3(face.points[0], face.points[k], face.points[k + 1]);
+        }
+    }
+    return volume / 6.0;
+}
+
+/**
+ * @brief 在box2的局部坐标系中求两个长方体的交集体积
+ */
+double intersectionVolume(const PreparedBox6DoF& box1, const PreparedBox6DoF& box2) {
+    const double* r1 = box1.rotation;
+    const double* r2 = box2.rotation;
+
+    // box1的中心和坐标轴变换到box2的局部坐标系：R2^T (c1 - c2)，R2^T R1
+    double d[3] = {box1.center[0] - box2.center[0], box1.center[1] - box2.center[1],
+                   box1.center[2] - box2.center[2]};
+    double center[3];
+    double axes[9];
+    for (int i = 0; i < 3; ++i) {
+        center[i] = r2[i] * d[0] + r2[3 + i] * d[1] + r2[6 + i] * d[2];
+        for (int j = 0; j < 3; ++j) {
+            axes[i * 3 + j] = r2[i] * r1[j] + r2[3 + i] * r1[3 + j] + r2[6 + i] * r1[6 + j];
+        }
+    }
+
+    // 顶点编号的第0、1、2位分别表示局部x、y、z取正半尺寸
+    Vec3 corners[8];
+    for (int c = 0; c < 8; ++c) {
+        double local[3] = {(c & 1) ? box1.half_extent[0] : -box1.half_extent[0],
+                           (c & 2) ? box1.half_extent[1] : -box1.half_extent[1],
+                           (c & 4) ? box1.half_extent[2] : -box1.half_extent[2]};
+        corners[c].x = center[0] + axes[0] * local[0] + axes[1] * local[1] + axes[2] * local[2];
+        corners[c].y = center[1] + axes[3] * local[0] + axes[4] * local[1] + axes[5] * local[2];
+        corners[c].z = center[2] + axes[6] * local[0] + axes[7] * local[1] + axes[8] * local[2];
+    }
+
+    // 任一半空间把box1的全部顶点排除在外时不相交；全部在内时不需要裁剪
+    bool needs_clip[6];
+    bool any_clip = false;
+    for (int plane = 0; plane < 6; ++plane) {
+        int axis = plane / 2;
+        double sign = (plane % 2) ? 1.0 : -1.0;
+        double bound = box2.half_extent[axis];
+        int outside = 0;
+        for (int c = 0; c < 8; ++c) {
+            if (sign * coordinate(corners[c], axis) > bound) {
+                ++outside;
+            }
+        }
+        if (outside == 8) {
+            return 0.0;
+        }
+        needs_clip[plane] = outside > 0;
+        any_clip = any_clip || needs_clip[plane];
+    }
+    if (!any_clip) {
+        return box1.volume;
+    }
+
+    // 6个面，从外侧看逆时针
+    static const int kFaceCorners[6][4] = {
+        {0, 4, 6, 2}, {1, 3, 7, 5},  // -x, +x
+        {0, 1, 5, 4}, {2, 6, 7, 3},  // -y, +y
+        {0, 2, 3, 1}, {4, 5, 7, 6}   // -z, +z
+    };
+    Polyhedron buffers[2];
+    Polyhedron* current = &buffers[0];
+    Polyhedron* next = &buffers[1];
+    current->count = 6;
+    for (int f = 0; f < 6; ++f) {
+        current->faces[f].count = 4;
+        for (int k = 0; k < 4; ++k) {
+            current->faces[f].points[k] = corners[kFaceCorners[f][k]];
+        }
+    }
+
+    for (int plane = 0; plane < 6; ++plane) {
+        if (!needs_clip[plane]) {
+            continue;
+        }
+        int axis = plane / 2;
+        double sign = (plane % 2) ? 1.0 : -1.0;
+        if (!clipPolyhedron(*current, axis, sign, box2.half_extent[axis], *next)) {
+            return 0.0;
+        }
+        std::swap(current, next);
+    }
+
+    return std::max(0.0, polyhedronVolume(*current));
+}
+
+void prepareBoxes(const std::vector<Box6DoF>& boxes, std::vector<PreparedBox6DoF>& prepared,
+                  Executor& executor) {
+    prepared.resize(boxes.size());
+    executor.parallelFor(boxes.size(), 256, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            prepareBox(boxes[i], prepared[i]);
+        }
+    });
+}
+
+} // namespace
+
+Box6DoF toBox6DoF(const Box& box) {
+    Box6DoF result;
+    result.class_id = box.class_id;
+    result.center_x = box.center_x;
+    result.center_y = box.center_y;
+    result.center_z = box.center_z;
+    result.length = box.length;
+    result.width = box.width;
+    result.height = box.height;
+    result.yaw = box.yaw;
+    result.pitch = 0.0f;
+    result.roll = 0.0f;
+    result.confidence = box.confidence;
+    return result;
+}
+
+void prepareBox(const Box6DoF& box, PreparedBox6DoF& prepared) {
+    double cy = std::cos(static_cast<double>(box.yaw));
+    double sy = std::sin(static_cast<double>(box.yaw));
+    double cp = std::cos(static_cast<double>(box.pitch));
+    double sp = std::sin(static_cast<double>(box.pitch));
+    double cr = std::cos(static_cast<double>(box.roll));
+    double sr = std::sin(static_cast<double>(box.roll));
+
+    // R = Ry(yaw) · Rz(pitch) · Rx(roll)
+    double* r = prepared.rotation;
+    r[0] = cy * cp;
+    r[1] = -cy * sp * cr + sy * sr;
+    r[2] = cy * sp * sr + sy * cr;
+    r[3] = sp;
+    r[4] = cp * cr;
+    r[5] = -cp * sr;
+    r[6] = -sy * cp;
+    r[7] = sy * sp * cr + cy * sr;
+    r[8] = -sy * sp * sr + cy * cr;
+
+    prepared.center[0] = box.center_x;
+    prepared.center[1] = box.center_y;
+    prepared.center[2] = box.center_z;
+    prepared.half_extent[0] = 0.5 * std::abs(static_cast<double>(box.length));
+    prepared.half_extent[1] = 0.5 * std::abs(static_cast<double>(box.height));
+    prepared.half_extent[2] = 0.5 * std::abs(static_cast<double>(box.width));
+    prepared.radius = std::sqrt(prepared.half_extent[0] * prepared.half_extent[0] +
+                                prepared.half_extent[1] * prepared.half_extent[1] +
+                                prepared.half_extent[2] * prepared.half_extent[2]);
+    prepared.volume = 8.0 * prepared.half_extent[0] * prepared.half_extent[1] * prepared.half_extent[2];
+
+    prepared.yaw_only = box.pitch == 0.0f && box.roll == 0.0f;
+    if (prepared.yaw_only) {
+        Box flat;
+        flat.class_id = box.class_id;
+        flat.center_x = box.center_x;
+        flat.center_y = box.center_y;
+        flat.center_z = box.center_z;
+        flat.length = box.length;
+        flat.width = box.width;
+        flat.height = box.height;
+        flat.yaw = box.yaw;
+        flat.confidence = box.confidence;
+        prepareBox(flat, prepared.prism);
+    }
+}
+
+float calculateIoU3D(const PreparedBox6DoF& box1, const PreparedBox6DoF& box2) {
+    if (box1.yaw_only && box2.yaw_only) {
+        return calculateIoU3D(box1.prism, box2.prism);
+    }
+
+    double dx = box1.center[0] - box2.center[0];
+    double dy = box1.center[1] - box2.center[1];
+    double dz = box1.center[2] - box2.center[2];
+    double radius_sum = box1.radius + box2.radius;
+    if (dx * dx + dy * dy + dz * dz >= radius_sum * radius_sum) {
+        return 0.0f;
+    }
+
+    double intersection = std::min(intersectionVolume(box1, box2), std::min(box1.volume, box2.volume));
+    double union_volume = box1.volume + box2.volume - intersection;
+    if (union_volume <= 0.0) {
+        return 0.0f;
+    }
+    return static_cast<float>(intersection / union_volume);
+}
+
+float calculateIoU3D(const Box6DoF& box1, const Box6DoF& box2) {
+    PreparedBox6DoF prepared1, prepared2;
+    prepareBox(box1, prepared1);
+    prepareBox(box2, prepared2);
+    return calculateIoU3D(prepared1, prepared2);
+}
+
+void calculateIoU3DMatrix(const std::vector<Box6DoF>& boxes1, const std::vector<Box6DoF>& boxes2, float* out) {
+    SerialExecutor serial;
+    calculateIoU3DMatrix(boxes1, boxes2, out, serial);
+}
+
+void calculateIoU3DMatrix(const std::vector<Box6DoF>& boxes1, const std::vector<Box6DoF>& boxes2, float* out,
+                          Executor& executor) {
+    std::vector<PreparedBox6DoF> prepared1;
+    std::vector<PreparedBox6DoF> prepared2;
+    prepareBoxes(boxes1, prepared1, executor);
+    prepareBoxes(boxes2, prepared2, executor);
+
+    const size_t cols = prepared2.size();
+    executor.parallelFor(prepared1.size(), 16, [&](size_t row_begin, size_t row_end) {
+        for (size_t i = row_begin; i < row_end; ++i) {
+            float* row = out + i * cols;
+            for (size_t j = 0; j < cols; ++j) {
+                row[j] = calculateIoU3D(prepared1[i], prepared2[j]);
+            }
+        }
+    });
+}
+
+} // namespace nms
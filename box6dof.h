@@ -0,0 +1,88 @@
+#pragma once
+
+#include "iou3d.h"
+
+#include <vector>
+
+namespace nms {
+
+/**
+ * @brief 具有完整朝向（yaw、pitch、roll）的3D包围盒
+ * 坐标系与Box相同。局部坐标系中length沿x轴、height沿y轴、width沿z轴，
+ * 局部点p变换到相机坐标系为 center + Ry(yaw) · Rz(pitch) · Rx(roll) · p，其中
+ * - Ry(yaw)：x' = x·cos + z·sin，z' = -x·sin + z·cos（与Box的yaw一致）
+ * - Rz(pitch)：x' = x·cos - y·sin，y' = x·sin + y·cos（正值使+x端朝+y，即向下）
+ * - Rx(roll)：y' = y·cos - z·sin，z' = y·sin + z·cos
+ * pitch与roll均为0时与同参数的Box完全等价
+ */
+struct Box6DoF {
+    int class_id;
+    float center_x;
+    float center_y;
+    float center_z;
+    // x方向尺寸
+    float length;
+    // z方向尺寸
+    float width;
+    // y方向尺寸
+    float height;
+    float yaw;
+    float pitch;
+    float roll;
+    float confidence;
+};
+
+/**
+ * @brief 由只有yaw的Box构造Box6DoF（pitch和roll为0）
+ */
+Box6DoF toBox6DoF(const Box& box);
+
+/**
+ * @brief 预先计算的6自由度包围盒几何信息
+ */
+struct PreparedBox6DoF {
+    // 中心与旋转矩阵（行优先，列为局部坐标轴在相机坐标系中的方向）
+    double center[3];
+    double rotation[9];
+    // 局部x、y、z方向的半尺寸
+    double half_extent[3];
+    // 外接球半径与体积
+    double radius;
+    double volume;
+    // pitch与roll均为0时为true，此时与其他同类框的IoU使用棱柱路径
+    bool yaw_only;
+    // yaw_only时的BEV预计算信息
+    PreparedBox prism;
+};
+
+/**
+ * @brief 预先计算旋转矩阵、半尺寸、外接球和体积
+ */
+void prepareBox(const Box6DoF& box, PreparedBox6DoF& prepared);
+
+/**
+ * @brief 计算两个6自由度包围盒的3D IoU
+ * 在box2的局部坐标系中用box2的6个半空间依次裁剪box1（凸多面体），
+ * 由散度定理求交集体积，内部使用double，结果为精确的凸多面体交集。
+ * 两个框的pitch与roll均为0时退化为calculateIoU3D(Box)的BEV多边形×y重叠路径。
+ */
+float calculateIoU3D(const Box6DoF& box1, const Box6DoF& box2);
+
+/**
+ * @brief 计算两个预处理6自由度包围盒的3D IoU（先进行外接球排除）
+ */
+float calculateIoU3D(const PreparedBox6DoF& box1, const PreparedBox6DoF& box2);
+
+/**
+ * @brief 批量计算两组6自由度包围盒之间的3D IoU矩阵（行优先，out[i*M + j]）
+ * 每个框的旋转矩阵等信息只计算一次
+ */
+void calculateIoU3DMatrix(const std::vector<Box6DoF>& boxes1, const std::vector<Box6DoF>& boxes2, float* out);
+
+/**
+ * @brief 并行计算6自由度包围盒的3D IoU矩阵，结果与串行版本完全一致
+ */
+void calculateIoU3DMatrix(const std::vector<Box6DoF>& boxes1, const std::vector<Box6DoF>& boxes2, float* out,
+                          Executor& executor);
+
+} // namespace nms
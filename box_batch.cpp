@@ -0,0 +1,211 @@
+#include "box_batch.h"
+#include "cpu_dispatch.h"
+#include "executor.h"
+#include <algorithm>
+#include <cmath>
+
+namespace nms {
+
+void BoxBatch::reserve(size_t n) {
+    center_x.reserve(n);
+    center_y.reserve(n);
+    center_z.reserve(n);
+    length.reserve(n);
+    width.reserve(n);
+    height.reserve(n);
+    yaw.reserve(n);
+    confidence.reserve(n);
+    class_id.reserve(n);
+}
+
+void BoxBatch::resize(size_t n) {
+    center_x.resize(n);
+    center_y.resize(n);
+    center_z.resize(n);
+    length.resize(n);
+    width.resize(n);
+    height.resize(n);
+    yaw.resize(n);
+    confidence.resize(n);
+    class_id.resize(n);
+}
+
+void BoxBatch::clear() {
+    resize(0);
+}
+
+void BoxBatch::push_back(const Box& box) {
+    center_x.push_back(box.center_x);
+    center_y.push_back(box.center_y);
+    center_z.push_back(box.center_z);
+    length.push_back(box.length);
+    width.push_back(box.width);
+    height.push_back(box.height);
+    yaw.push_back(box.yaw);
+    confidence.push_back(box.confidence);
+    class_id.push_back(box.class_id);
+}
+
+Box BoxBatch::box(size_t i) const {
+    Box box;
+    box.class_id = class_id[i];
+    box.center_x = center_x[i];
+    box.center_y = center_y[i];
+    box.center_z = center_z[i];
+    box.length = length[i];
+    box.width = width[i];
+    box.height = height[i];
+    box.yaw = yaw[i];
+    box.confidence = confidence[i];
+    return box;
+}
+
+Box BoxBatchView::box(size_t i) const {
+    Box box;
+    box.class_id = class_id[i];
+    box.center_x = center_x[i];
+    box.center_y = center_y[i];
+    box.center_z = center_z[i];
+    box.length = length[i];
+    box.width = width[i];
+    box.height = height[i];
+    box.yaw = yaw[i];
+    box.confidence = confidence[i];
+    return box;
+}
+
+BoxBatchView BoxBatch::view() const {
+    BoxBatchView view;
+    view.center_x = center_x.data();
+    view.center_y = center_y.data();
+    view.center_z = center_z.data();
+    view.length = length.data();
+    view.width = width.data();
+    view.height = height.data();
+    view.yaw = yaw.data();
+    view.confidence = confidence.data();
+    view.class_id = class_id.data();
+    view.count = size();
+    return view;
+}
+
+BoxBatch BoxBatch::fromBoxes(const std::vector<Box>& boxes) {
+    BoxBatch batch;
+    batch.reserve(boxes.size());
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        batch.push_back(boxes[i]);
+    }
+    return batch;
+}
+
+void BEVCornerBatch::resize(size_t n) {
+    for (int k = 0; k < 4; ++k) {
+        x[k].resize(n);
+        z[k].resize(n);
+    }
+}
+
+void computeBEVCorners(const float* center_x, const float* center_z,
+                       const float* length, const float* width, const float* yaw,
+                       size_t n, float* const corners_x[4], float* const corners_z[4]) {
+    detail::activeKernels().bev_corners(center_x, center_z, length, width, yaw, n, corners_x, corners_z);
+}
+
+void computeBEVCorners(const BoxBatch& batch, BEVCornerBatch& corners) {
+    computeBEVCorners(batch.view(), corners);
+}
+
+void computeBEVCorners(const BoxBatchView& batch, BEVCornerBatch& corners) {
+    const size_t n = batch.size();
+    corners.resize(n);
+    if (n == 0) {
+        return;
+    }
+
+    float* corners_x[4] = {corners.x[0].data(), corners.x[1].data(), corners.x[2].data(), corners.x[3].data()};
+    float* corners_z[4] = {corners.z[0].data(), corners.z[1].data(), corners.z[2].data(), corners.z[3].data()};
+    computeBEVCorners(batch.center_x, batch.center_z, batch.length, batch.width, batch.yaw,
+                      n, corners_x, corners_z);
+}
+
+void prepareBox(const BoxBatchView& batch, size_t i, PreparedBox& prepared) {
+    const float params[7] = {batch.center_x[i], batch.center_y[i], batch.center_z[i],
+                             batch.length[i], batch.width[i], batch.height[i], batch.yaw[i]};
+    prepareBox(params, prepared);
+}
+
+void prepareBoxes(const BoxBatchView& batch, std::vector<PreparedBox>& prepared, Executor& executor) {
+    prepared.resize(batch.size());
+    PreparedBox* output = prepared.data();
+    executor.parallelFor(batch.size(), 256, [&batch, output](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            prepareBox(batch, i, output[i]);
+        }
+    });
+}
+
+void calculateIoU3DMatrix(const BoxBatchView& boxes1, const BoxBatchView& boxes2, float* out) {
+    SerialExecutor serial;
+    calculateIoU3DMatrix(boxes1, boxes2, out, serial);
+}
+
+void calculateIoU3DMatrix(const BoxBatchView& boxes1, const BoxBatchView& boxes2, float* out,
+                          Executor& executor) {
+    std::vector<PreparedBox> prepared1;
+    std::vector<PreparedBox> prepared2;
+    prepareBoxes(boxes1, prepared1, executor);
+    prepareBoxes(boxes2, prepared2, executor);
+    calculateIoU3DMatrix(prepared1, prepared2, out, executor);
+}
+
+void calculateBEVIoUMatrix(const BoxBatchView& boxes1, const BoxBatchView& boxes2, float* out) {
+    SerialExecutor serial;
+    calculateBEVIoUMatrix(boxes1, boxes2, out, serial);
+}
+
+void calculateBEVIoUMatrix(const BoxBatchView& boxes1, const BoxBatchView& boxes2, float* out,
+                           Executor& executor) {
+    std::vector<PreparedBox> prepared1;
+    std::vector<PreparedBox> prepared2;
+    prepareBoxes(boxes1, prepared1, executor);
+    prepareBoxes(boxes2, prepared2, executor);
+    calculateBEVIoUMatrix(prepared1, prepared2, out, executor);
+}
+
+void calculateBEVIoUOneToMany(const Box& ref, const BoxBatch& others, float* out) {
+    calculateBEVIoUOneToMany(ref, others.view(), out);
+}
+
+void calculateBEVIoUOneToMany(const Box& ref, const BoxBatchView& others, float* out) {
+    if (others.empty()) {
+        return;
+    }
+
+    detail::BEVReference reference;
+    reference.origin_x = ref.center_x;
+    reference.origin_z = ref.center_z;
+    BasicPoint2D<float> corners[4];
+    boxToBEVCorners<float>(ref, corners, ref.center_x, ref.center_z);
+    reference.min_x = reference.max_x = corners[0].x;
+    reference.min_z = reference.max_z = corners[0].z;
+    for (int k = 0; k < 4; ++k) {
+        const BasicPoint2D<float>& next = corners[(k + 1) & 3];
+        reference.corner_x[k] = corners[k].x;
+        reference.corner_z[k] = corners[k].z;
+        reference.edge_x[k] = next.x - corners[k].x;
+        reference.edge_z[k] = next.z - corners[k].z;
+        // 与calculateQuadIntersectionArea的点在四边形内判断使用相同的相对容差
+        reference.collinear_tolerance[k] = 1e-5f * (reference.edge_x[k] * reference.edge_x[k] +
+                                                    reference.edge_z[k] * reference.edge_z[k]);
+        reference.min_x = std::min(reference.min_x, corners[k].x);
+        reference.min_z = std::min(reference.min_z, corners[k].z);
+        reference.max_x = std::max(reference.max_x, corners[k].x);
+        reference.max_z = std::max(reference.max_z, corners[k].z);
+    }
+    reference.area = std::abs(ref.length * ref.width);
+
+    detail::activeKernels().bev_iou_one_to_many(reference, others.center_x, others.center_z,
+                                                others.length, others.width, others.yaw, others.size(), out);
+}
+
+} // namespace nms
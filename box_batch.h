@@ -0,0 +1,176 @@
+#pragma once
+
+#include "iou3d.h"
+
+#include <vector>
+#include <string>
+#include <cstddef>
+
+namespace nms {
+
+class Executor;
+
+/**
+ * @brief 只读的SoA包围盒视图，不持有内存
+ * 各指针指向长度为size()的列，可以来自BoxBatch，也可以直接指向内存映射文件中的列（见box_io.h）
+ */
+struct BoxBatchView {
+    const float* center_x = nullptr;
+    const float* center_y = nullptr;
+    const float* center_z = nullptr;
+    const float* length = nullptr;
+    const float* width = nullptr;
+    const float* height = nullptr;
+    const float* yaw = nullptr;
+    const float* confidence = nullptr;
+    const int* class_id = nullptr;
+    size_t count = 0;
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    /**
+     * @brief 取出第i个包围盒，class_name为空
+     */
+    Box box(size_t i) const;
+};
+
+/**
+ * @brief 结构数组（SoA）形式的包围盒批量容器
+ * 每个字段单独存储为连续的数组，便于向量化处理，且不包含每个框的字符串。
+ * 所有数组长度始终相等。
+ */
+struct BoxBatch {
+    std::vector<float> center_x;
+    std::vector<float> center_y;
+    std::vector<float> center_z;
+    // x方向尺寸
+    std::vector<float> length;
+    // z方向尺寸
+    std::vector<float> width;
+    // y方向尺寸
+    std::vector<float> height;
+    std::vector<float> yaw;
+    std::vector<float> confidence;
+    std::vector<int> class_id;
+
+    size_t size() const { return center_x.size(); }
+    bool empty() const { return center_x.empty(); }
+
+    void reserve(size_t n);
+    void resize(size_t n);
+    void clear();
+
+    /**
+     * @brief 追加一个包围盒（class_name不保存）
+     */
+    void push_back(const Box& box);
+
+    /**
+     * @brief 取出第i个包围盒，class_name为空
+     */
+    Box box(size_t i) const;
+
+    /**
+     * @brief 从AoS形式的包围盒数组构造
+     */
+    static BoxBatch fromBoxes(const std::vector<Box>& boxes);
+
+    /**
+     * @brief 指向本容器各列的视图，容器被修改后失效
+     */
+    BoxBatchView view() const;
+};
+
+/**
+ * @brief 批量BEV顶点（SoA布局）
+ * 第i个框的第k个顶点为 (x[k][i], z[k][i])，顶点顺序与boxToBEVPolygon一致（逆时针）
+ */
+struct BEVCornerBatch {
+    std::vector<float> x[4];
+    std::vector<float> z[4];
+
+    size_t size() const { return x[0].size(); }
+    void resize(size_t n);
+};
+
+/**
+ * @brief 批量计算BEV顶点（向量化的sin/cos与旋转）
+ * 每次处理一个SIMD寄存器宽度的包围盒（AVX-512为16个，AVX2为8个，SSE/NEON为4个），后端见simdBackendName()
+ * @param center_x, center_z, length, width, yaw 长度为n的输入数组
+ * @param n 包围盒数量
+ * @param corners_x, corners_z 4个长度至少为n的输出数组，对应4个顶点
+ */
+void computeBEVCorners(const float* center_x, const float* center_z,
+                       const float* length, const float* width, const float* yaw,
+                       size_t n, float* const corners_x[4], float* const corners_z[4]);
+
+/**
+ * @brief 批量计算BoxBatch中所有包围盒的BEV顶点
+ * @param batch 输入包围盒
+ * @param corners 输出顶点，会被调整为batch.size()大小
+ */
+void computeBEVCorners(const BoxBatch& batch, BEVCornerBatch& corners);
+
+/**
+ * @brief 批量计算视图中所有包围盒的BEV顶点
+ */
+void computeBEVCorners(const BoxBatchView& batch, BEVCornerBatch& corners);
+
+/**
+ * @brief 预处理视图中的第i个包围盒，结果与prepareBox(batch.box(i))相同
+ */
+void prepareBox(const BoxBatchView& batch, size_t i, PreparedBox& prepared);
+
+/**
+ * @brief 并行预处理视图中的所有包围盒
+ * @param prepared 输出，会被调整为batch.size()大小
+ */
+void prepareBoxes(const BoxBatchView& batch, std::vector<PreparedBox>& prepared, Executor& executor);
+
+/**
+ * @brief 计算两个视图之间的3D IoU矩阵，结果与对应Box数组的calculateIoU3DMatrix完全一致
+ * @param out 至少N*M个元素，按行优先存储
+ */
+void calculateIoU3DMatrix(const BoxBatchView& boxes1, const BoxBatchView& boxes2, float* out);
+void calculateIoU3DMatrix(const BoxBatchView& boxes1, const BoxBatchView& boxes2, float* out,
+                          Executor& executor);
+
+/**
+ * @brief 计算两个视图之间的BEV IoU矩阵
+ */
+void calculateBEVIoUMatrix(const BoxBatchView& boxes1, const BoxBatchView& boxes2, float* out);
+void calculateBEVIoUMatrix(const BoxBatchView& boxes1, const BoxBatchView& boxes2, float* out,
+                           Executor& executor);
+
+/**
+ * @brief 一个参考框与一批候选框的BEV IoU（向量化的一对多内核）
+ * 每个SIMD通道处理一个候选框，所有通道同步地用参考框的4个半平面裁剪，适合NMS与关联中
+ * “一个框对后续K个框”的内层循环。交集面积用格林公式计算，与calculateBEVIoU的结果
+ * 不逐位相同（差异在1e-5量级），各SIMD后端之间逐位一致。
+ * @param ref 参考框，其顶点只计算一次
+ * @param others 候选框
+ * @param out 至少others.size()个元素，out[i]为ref与第i个候选框的BEV IoU
+ */
+void calculateBEVIoUOneToMany(const Box& ref, const BoxBatch& others, float* out);
+void calculateBEVIoUOneToMany(const Box& ref, const BoxBatchView& others, float* out);
+
+/**
+ * @brief 返回当前使用的SIMD后端名称（"avx512"、"avx2"、"sse41"、"sse2"、"neon"或"scalar"）
+ * 首次使用时按CPU支持的指令集选择最高级别；环境变量IOU3D_FORCE_ISA可以指定后端，
+ * 指定的后端不可用时使用不高于它的最高级别
+ */
+const char* simdBackendName();
+
+/**
+ * @brief 编译进库且当前CPU支持的SIMD后端，按级别从低到高排列
+ */
+std::vector<std::string> availableSimdBackends();
+
+/**
+ * @brief 切换SIMD后端，名称不在availableSimdBackends()中时返回false且不做修改
+ * 各后端的计算结果逐位一致，主要用于测试与性能对比
+ */
+bool setSimdBackend(const std::string& name);
+
+} // namespace nms
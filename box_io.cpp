@@ -0,0 +1,327 @@
+#include "box_io.h"
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace nms {
+
+namespace {
+
+const char kMagic[8] = {'I', 'O', 'U', '3', 'D', 'B', 'O', 'X'};
+const uint32_t kVersion = 1;
+const uint32_t kByteOrder = 0x01020304u;
+const size_t kNumColumns = 9;
+// 每列补齐到16个元素（64字节）
+const size_t kColumnAlignment = 16;
+
+static_assert(sizeof(float) == 4 && sizeof(int) == 4, "columns are stored as 32-bit values");
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint64_t num_frames;
+    uint64_t num_boxes;
+    uint64_t frame_index_offset;
+    uint64_t class_table_offset;
+    uint32_t num_classes;
+    uint32_t byte_order;
+    uint64_t reserved;
+};
+
+static_assert(sizeof(FileHeader) == 64, "header layout must match the file format");
+
+size_t paddedCount(size_t count) {
+    return (count + kColumnAlignment - 1) / kColumnAlignment * kColumnAlignment;
+}
+
+FileHeader makeHeader() {
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.header_size = sizeof(FileHeader);
+    header.byte_order = kByteOrder;
+    return header;
+}
+
+template <typename T>
+T load(const unsigned char* data) {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+} // namespace
+
+BoxFileWriter::BoxFileWriter() : file_(nullptr), position_(0), num_boxes_(0) {}
+
+BoxFileWriter::~BoxFileWriter() {
+    close();
+}
+
+bool BoxFileWriter::open(const std::string& path) {
+    close();
+    error_.clear();
+    frame_index_.clear();
+    class_names_.clear();
+    num_boxes_ = 0;
+    position_ = 0;
+    path_ = path;
+
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) {
+        return fail("cannot open " + path + " for writing");
+    }
+    // 先写入未完成的文件头（frame_index_offset为0），close()时回填
+    FileHeader header = makeHeader();
+    return writeBytes(&header, sizeof(header));
+}
+
+bool BoxFileWriter::writeBytes(const void* data, size_t size) {
+    if (size > 0 && std::fwrite(data, 1, size, file_) != size) {
+        return fail("write to " + path_ + " failed");
+    }
+    position_ += size;
+    return true;
+}
+
+bool BoxFileWriter::writeColumn(const void* data, size_t count) {
+    static const unsigned char zeros[kColumnAlignment * 4] = {0};
+    return writeBytes(data, count * 4) && writeBytes(zeros, (paddedCount(count) - count) * 4);
+}
+
+bool BoxFileWriter::fail(const std::string& message) {
+    error_ = message;
+    if (file_) {
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+    return false;
+}
+
+bool BoxFileWriter::writeFrame(const BoxBatchView& boxes) {
+    if (!file_) {
+        return fail("file is not open");
+    }
+    const size_t n = boxes.size();
+    frame_index_.push_back(position_);
+    frame_index_.push_back(n);
+    num_boxes_ += n;
+
+    const void* columns[kNumColumns] = {boxes.center_x, boxes.center_y, boxes.center_z,
+                                        boxes.length, boxes.width, boxes.height,
+                                        boxes.yaw, boxes.confidence, boxes.class_id};
+    for (size_t c = 0; c < kNumColumns; ++c) {
+        if (!writeColumn(columns[c], n)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool BoxFileWriter::writeFrame(const BoxBatch& boxes) {
+    return writeFrame(boxes.view());
+}
+
+bool BoxFileWriter::writeFrame(const std::vector<Box>& boxes) {
+    batch_.clear();
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        batch_.push_back(boxes[i]);
+        if (!boxes[i].class_name.empty() && class_names_.find(boxes[i].class_id) == class_names_.end()) {
+            class_names_[boxes[i].class_id] = boxes[i].class_name;
+        }
+    }
+    return writeFrame(batch_.view());
+}
+
+void BoxFileWriter::setClassName(int class_id, const std::string& name) {
+    class_names_[class_id] = name;
+}
+
+bool BoxFileWriter::close() {
+    if (!file_) {
+        return error_.empty();
+    }
+
+    FileHeader header = makeHeader();
+    header.num_frames = frame_index_.size() / 2;
+    header.num_boxes = num_boxes_;
+    header.frame_index_offset = position_;
+    if (!writeBytes(frame_index_.data(), frame_index_.size() * sizeof(uint64_t))) {
+        return false;
+    }
+
+    header.class_table_offset = position_;
+    header.num_classes = static_cast<uint32_t>(class_names_.size());
+    for (std::map<int, std::string>::const_iterator it = class_names_.begin(); it != class_names_.end(); ++it) {
+        int32_t class_id = it->first;
+        uint32_t length = static_cast<uint32_t>(it->second.size());
+        if (!writeBytes(&class_id, sizeof(class_id)) || !writeBytes(&length, sizeof(length)) ||
+            !writeBytes(it->second.data(), length)) {
+            return false;
+        }
+    }
+
+    // 最后回填文件头，中途失败的文件不会被读取器接受
+    if (std::fseek(file_, 0, SEEK_SET) != 0) {
+        return fail("seek in " + path_ + " failed");
+    }
+    if (!writeBytes(&header, sizeof(header))) {
+        return false;
+    }
+    bool ok = std::fclose(file_) == 0;
+    file_ = nullptr;
+    if (!ok) {
+        error_ = "closing " + path_ + " failed";
+    }
+    return ok;
+}
+
+BoxFileReader::BoxFileReader()
+    : data_(nullptr), size_(0), num_frames_(0), num_boxes_(0), frame_index_(nullptr) {}
+
+BoxFileReader::~BoxFileReader() {
+    close();
+}
+
+void BoxFileReader::close() {
+    if (data_) {
+        munmap(const_cast<unsigned char*>(data_), size_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+    num_frames_ = 0;
+    num_boxes_ = 0;
+    frame_index_ = nullptr;
+    class_names_.clear();
+}
+
+bool BoxFileReader::fail(const std::string& message) {
+    close();
+    error_ = message;
+    return false;
+}
+
+bool BoxFileReader::open(const std::string& path) {
+    close();
+    error_.clear();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return fail("cannot open " + path);
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(FileHeader))) {
+        ::close(fd);
+        return fail(path + " is too small to be a box file");
+    }
+    size_t size = static_cast<size_t>(info.st_size);
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        return fail("cannot map " + path);
+    }
+    data_ = static_cast<const unsigned char*>(mapped);
+    size_ = size;
+
+    FileHeader header;
+    std::memcpy(&header, data_, sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+        return fail(path + " is not a box file");
+    }
+    if (header.byte_order != kByteOrder) {
+        return fail(path + " was written with a different byte order");
+    }
+    if (header.version != kVersion || header.header_size != sizeof(FileHeader)) {
+        return fail(path + " has an unsupported version");
+    }
+    if (header.frame_index_offset == 0) {
+        return fail(path + " was not closed properly");
+    }
+
+    // 帧索引表与类别字典必须完整位于文件内
+    const uint64_t file_size = size_;
+    if (header.frame_index_offset % sizeof(uint64_t) != 0 || header.frame_index_offset > file_size ||
+        header.num_frames > (file_size - header.frame_index_offset) / (2 * sizeof(uint64_t))) {
+        return fail(path + " has a corrupt frame index");
+    }
+    frame_index_ = data_ + header.frame_index_offset;
+
+    uint64_t total = 0;
+    for (uint64_t f = 0; f < header.num_frames; ++f) {
+        uint64_t offset = load<uint64_t>(frame_index_ + f * 2 * sizeof(uint64_t));
+        uint64_t count = load<uint64_t>(frame_index_ + (f * 2 + 1) * sizeof(uint64_t));
+        if (offset < sizeof(FileHeader) || offset % (kColumnAlignment * 4) != 0 || offset > file_size ||
+            count > (file_size - offset) / (kNumColumns * 4)) {
+            return fail(path + " has a corrupt frame index");
+        }
+        if (paddedCount(count) * kNumColumns * 4 > file_size - offset) {
+            return fail(path + " has a truncated frame");
+        }
+        total += count;
+    }
+    if (total != header.num_boxes) {
+        return fail(path + " has an inconsistent box count");
+    }
+
+    uint64_t position = header.class_table_offset;
+    for (uint32_t c = 0; c < header.num_classes; ++c) {
+        if (position > file_size || file_size - position < 8) {
+            return fail(path + " has a corrupt class table");
+        }
+        int32_t class_id = load<int32_t>(data_ + position);
+        uint32_t length = load<uint32_t>(data_ + position + 4);
+        position += 8;
+        if (length > file_size - position) {
+            return fail(path + " has a corrupt class table");
+        }
+        class_names_[class_id].assign(reinterpret_cast<const char*>(data_ + position), length);
+        position += length;
+    }
+
+    num_frames_ = static_cast<size_t>(header.num_frames);
+    num_boxes_ = static_cast<size_t>(header.num_boxes);
+    return true;
+}
+
+BoxBatchView BoxFileReader::frame(size_t i) const {
+    BoxBatchView view;
+    if (i >= num_frames_) {
+        return view;
+    }
+    uint64_t offset = load<uint64_t>(frame_index_ + i * 2 * sizeof(uint64_t));
+    size_t count = static_cast<size_t>(load<uint64_t>(frame_index_ + (i * 2 + 1) * sizeof(uint64_t)));
+    size_t column_bytes = paddedCount(count) * 4;
+    const unsigned char* block = data_ + offset;
+
+    // 数据块按64字节对齐，可以直接按float/int访问
+    view.center_x = reinterpret_cast<const float*>(block);
+    view.center_y = reinterpret_cast<const float*>(block + column_bytes);
+    view.center_z = reinterpret_cast<const float*>(block + 2 * column_bytes);
+    view.length = reinterpret_cast<const float*>(block + 3 * column_bytes);
+    view.width = reinterpret_cast<const float*>(block + 4 * column_bytes);
+    view.height = reinterpret_cast<const float*>(block + 5 * column_bytes);
+    view.yaw = reinterpret_cast<const float*>(block + 6 * column_bytes);
+    view.confidence = reinterpret_cast<const float*>(block + 7 * column_bytes);
+    view.class_id = reinterpret_cast<const int*>(block + 8 * column_bytes);
+    view.count = count;
+    return view;
+}
+
+Box BoxFileReader::box(size_t frame_index, size_t i) const {
+    Box box = frame(frame_index).box(i);
+    box.class_name = className(box.class_id);
+    return box;
+}
+
+const std::string& BoxFileReader::className(int class_id) const {
+    static const std::string empty;
+    std::map<int, std::string>::const_iterator it = class_names_.find(class_id);
+    return it != class_names_.end() ? it->second : empty;
+}
+
+} // namespace nms
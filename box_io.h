@@ -0,0 +1,150 @@
+#pragma once
+
+#include "box_batch.h"
+
+#include <vector>
+#include <map>
+#include <string>
+#include <cstdio>
+#include <cstddef>
+#include <cstdint>
+
+namespace nms {
+
+/*
+ * 二进制包围盒文件格式（版本1）
+ * 所有整数和浮点数按写入机器的字节序存放，偏移量以字节计、从文件开头算起。
+ *
+ *   文件头（64字节）
+ *     char     magic[8]            "IOU3DBOX"
+ *     uint32_t version             1
+ *     uint32_t header_size         64
+ *     uint64_t num_frames
+ *     uint64_t num_boxes
+ *     uint64_t frame_index_offset  帧索引表的位置，0表示文件没有正常关闭
+ *     uint64_t class_table_offset  类别字典的位置
+ *     uint32_t num_classes
+ *     uint32_t byte_order          0x01020304，读取时用于检查字节序
+ *     uint64_t reserved
+ *
+ *   帧数据块，每帧一个，紧接在文件头之后依次存放
+ *     9列依次为center_x, center_y, center_z, length, width, height, yaw, confidence（float32）
+ *     和class_id（int32）。每列count个元素，补零到16的倍数，因此每列都按64字节对齐
+ *
+ *   帧索引表，每帧16字节：uint64_t offset（帧数据块的位置）, uint64_t count（框数）
+ *
+ *   类别字典，每个类别：int32_t class_id, uint32_t name_length, char name[name_length]
+ */
+
+/**
+ * @brief 流式写入包围盒文件
+ * 每帧直接写入文件，内存中只保留帧索引和类别字典；close()时写入索引表和字典并回填文件头。
+ * 所有函数出错时返回false，error()给出原因。
+ */
+class BoxFileWriter {
+public:
+    BoxFileWriter();
+    ~BoxFileWriter();
+
+    BoxFileWriter(const BoxFileWriter&) = delete;
+    BoxFileWriter& operator=(const BoxFileWriter&) = delete;
+
+    bool open(const std::string& path);
+
+    /**
+     * @brief 写入一帧
+     */
+    bool writeFrame(const BoxBatchView& boxes);
+    bool writeFrame(const BoxBatch& boxes);
+
+    /**
+     * @brief 写入一帧，非空的class_name记入类别字典（同一class_id以第一次出现的名称为准）
+     */
+    bool writeFrame(const std::vector<Box>& boxes);
+
+    /**
+     * @brief 设置类别名称，覆盖已有的名称
+     */
+    void setClassName(int class_id, const std::string& name);
+
+    /**
+     * @brief 写入索引表和类别字典并关闭文件，析构时会自动调用
+     */
+    bool close();
+
+    bool isOpen() const { return file_ != nullptr; }
+    size_t numFrames() const { return frame_index_.size() / 2; }
+    const std::string& error() const { return error_; }
+
+private:
+    bool writeBytes(const void* data, size_t size);
+    bool writeColumn(const void* data, size_t count);
+    bool fail(const std::string& message);
+
+    std::FILE* file_;
+    std::string path_;
+    uint64_t position_;
+    uint64_t num_boxes_;
+    // 每帧两个元素：offset, count
+    std::vector<uint64_t> frame_index_;
+    std::map<int, std::string> class_names_;
+    // writeFrame(std::vector<Box>)的转换缓冲区，逐帧复用
+    BoxBatch batch_;
+    std::string error_;
+};
+
+/**
+ * @brief 通过mmap只读打开包围盒文件
+ * frame()返回直接指向映射内存的视图，可以直接传给NmsWorkspace::process、
+ * calculateIoU3DMatrix(BoxBatchView...)等批量接口，不做任何拷贝。
+ * 视图在close()或读取器析构之前有效。
+ */
+class BoxFileReader {
+public:
+    BoxFileReader();
+    ~BoxFileReader();
+
+    BoxFileReader(const BoxFileReader&) = delete;
+    BoxFileReader& operator=(const BoxFileReader&) = delete;
+
+    /**
+     * @brief 映射并校验文件（文件头、字节序、所有帧和表的范围），失败时返回false
+     */
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return data_ != nullptr; }
+    size_t numFrames() const { return num_frames_; }
+    size_t numBoxes() const { return num_boxes_; }
+
+    /**
+     * @brief 第i帧的零拷贝视图
+     */
+    BoxBatchView frame(size_t i) const;
+
+    /**
+     * @brief 取出第frame_index帧的第i个框，class_name从类别字典中查找
+     */
+    Box box(size_t frame_index, size_t i) const;
+
+    /**
+     * @brief 类别名称，字典中没有时返回空字符串
+     */
+    const std::string& className(int class_id) const;
+    const std::map<int, std::string>& classNames() const { return class_names_; }
+
+    const std::string& error() const { return error_; }
+
+private:
+    bool fail(const std::string& message);
+
+    const unsigned char* data_;
+    size_t size_;
+    size_t num_frames_;
+    size_t num_boxes_;
+    const unsigned char* frame_index_;
+    std::map<int, std::string> class_names_;
+    std::string error_;
+};
+
+} // namespace nms
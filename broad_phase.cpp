@@ -0,0 +1,289 @@
+#include "broad_phase.h"
+#include "executor.h"
+#include "stats_hooks.h"
+#include <cmath>
+#include <algorithm>
+
+namespace nms {
+
+BEVBounds computeBEVBounds(const Box& box) {
+    Point2D corners[4];
+    boxToBEVCorners(box, corners);
+
+    BEVBounds bounds = {corners[0].x, corners[0].z, corners[0].x, corners[0].z};
+    for (int k = 1; k < 4; ++k) {
+        bounds.min_x = std::min(bounds.min_x, corners[k].x);
+        bounds.min_z = std::min(bounds.min_z, corners[k].z);
+        bounds.max_x = std::max(bounds.max_x, corners[k].x);
+        bounds.max_z = std::max(bounds.max_z, corners[k].z);
+    }
+    return bounds;
+}
+
+BEVGrid::BEVGrid(float cell_size)
+    : requested_cell_size_(cell_size), cell_size_(1.0f), origin_x_(0.0f), origin_z_(0.0f),
+      cols_(0), rows_(0) {}
+
+void BEVGrid::build(const std::vector<Box>& boxes) {
+    std::vector<BEVBounds> bounds(boxes.size());
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        bounds[i] = computeBEVBounds(boxes[i]);
+    }
+    build(bounds);
+}
+
+void BEVGrid::build(const std::vector<BEVBounds>& bounds) {
+    bounds_ = bounds;
+    cell_start_.clear();
+    cell_items_.clear();
+    cols_ = 0;
+    rows_ = 0;
+    if (bounds_.empty()) {
+        return;
+    }
+
+    // 场景范围与平均框尺寸
+    BEVBounds extent = bounds_[0];
+    double extent_sum = 0.0;
+    for (size_t i = 0; i < bounds_.size(); ++i) {
+        const BEVBounds& b = bounds_[i];
+        extent.min_x = std::min(extent.min_x, b.min_x);
+        extent.min_z = std::min(extent.min_z, b.min_z);
+        extent.max_x = std::max(extent.max_x, b.max_x);
+        extent.max_z = std::max(extent.max_z, b.max_z);
+        extent_sum += std::max(b.max_x - b.min_x, b.max_z - b.min_z);
+    }
+
+    cell_size_ = requested_cell_size_;
+    if (cell_size_ <= 0.0f) {
+        cell_size_ = static_cast<float>(extent_sum / bounds_.size());
+    }
+    cell_size_ = std::max(cell_size_, 1e-3f);
+
+    // 限制单元总数，避免稀疏场景中网格过大
+    const double max_cells = 4.0 * bounds_.size() + 64.0;
+    double width = std::max(extent.max_x - extent.min_x, 1e-3f);
+    double depth = std::max(extent.max_z - extent.min_z, 1e-3f);
+    while ((std::floor(width / cell_size_) + 1.0) * (std::floor(depth / cell_size_) + 1.0) > max_cells) {
+        cell_size_ *= 2.0f;
+    }
+
+    origin_x_ = extent.min_x;
+    origin_z_ = extent.min_z;
+    cols_ = static_cast<int>(width / cell_size_) + 1;
+    rows_ = static_cast<int>(depth / cell_size_) + 1;
+
+    // 计数排序构建CSR
+    cell_start_.assign(static_cast<size_t>(cols_) * rows_ + 1, 0);
+    for (size_t i = 0; i < bounds_.size(); ++i) {
+        const BEVBounds& b = bounds_[i];
+        for (int cz = cellZ(b.min_z); cz <= cellZ(b.max_z); ++cz) {
+            for (int cx = cellX(b.min_x); cx <= cellX(b.max_x); ++cx) {
+                ++cell_start_[static_cast<size_t>(cz) * cols_ + cx + 1];
+            }
+        }
+    }
+    for (size_t c = 1; c < cell_start_.size(); ++c) {
+        cell_start_[c] += cell_start_[c - 1];
+    }
+
+    cell_items_.resize(cell_start_.back());
+    cell_fill_.assign(cell_start_.begin(), cell_start_.end() - 1);
+    for (size_t i = 0; i < bounds_.size(); ++i) {
+        const BEVBounds& b = bounds_[i];
+        for (int cz = cellZ(b.min_z); cz <= cellZ(b.max_z); ++cz) {
+            for (int cx = cellX(b.min_x); cx <= cellX(b.max_x); ++cx) {
+                cell_items_[cell_fill_[static_cast<size_t>(cz) * cols_ + cx]++] = static_cast<int>(i);
+            }
+        }
+    }
+}
+
+int BEVGrid::cellX(float x) const {
+    int c = static_cast<int>(std::floor((x - origin_x_) / cell_size_));
+    return std::min(std::max(c, 0), cols_ - 1);
+}
+
+int BEVGrid::cellZ(float z) const {
+    int c = static_cast<int>(std::floor((z - origin_z_) / cell_size_));
+    return std::min(std::max(c, 0), rows_ - 1);
+}
+
+void BEVGrid::query(const BEVBounds& bounds, std::vector<int>& result) const {
+    result.clear();
+    if (bounds_.empty()) {
+        return;
+    }
+
+    for (int cz = cellZ(bounds.min_z); cz <= cellZ(bounds.max_z); ++cz) {
+        for (int cx = cellX(bounds.min_x); cx <= cellX(bounds.max_x); ++cx) {
+            size_t cell = static_cast<size_t>(cz) * cols_ + cx;
+            for (int k = cell_start_[cell]; k < cell_start_[cell + 1]; ++k) {
+                int item = cell_items_[k];
+                const BEVBounds& other = bounds_[item];
+                if (!bounds.overlaps(other)) {
+                    continue;
+                }
+                // 只在交集左下角所在的单元报告
+                if (cellX(std::max(bounds.min_x, other.min_x)) == cx &&
+                    cellZ(std::max(bounds.min_z, other.min_z)) == cz) {
+                    result.push_back(item);
+                }
+            }
+        }
+    }
+
+    std::sort(result.begin(), result.end());
+}
+
+void BEVGrid::selfPairs(std::vector<CandidatePair>& pairs) const {
+    pairs.clear();
+    for (int cz = 0; cz < rows_; ++cz) {
+        for (int cx = 0; cx < cols_; ++cx) {
+            size_t cell = static_cast<size_t>(cz) * cols_ + cx;
+            for (int a = cell_start_[cell]; a < cell_start_[cell + 1]; ++a) {
+                int first = cell_items_[a];
+                const BEVBounds& b1 = bounds_[first];
+                for (int b = a + 1; b < cell_start_[cell + 1]; ++b) {
+                    int second = cell_items_[b];
+                    const BEVBounds& b2 = bounds_[second];
+                    if (!b1.overlaps(b2)) {
+                        continue;
+                    }
+                    if (cellX(std::max(b1.min_x, b2.min_x)) == cx &&
+                        cellZ(std::max(b1.min_z, b2.min_z)) == cz) {
+                        CandidatePair pair = {std::min(first, second), std::max(first, second)};
+                        pairs.push_back(pair);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void BEVGrid::crossPairs(const std::vector<BEVBounds>& others, std::vector<CandidatePair>& pairs) const {
+    pairs.clear();
+    std::vector<int> matches;
+    for (size_t i = 0; i < others.size(); ++i) {
+        query(others[i], matches);
+        for (size_t k = 0; k < matches.size(); ++k) {
+            CandidatePair pair = {static_cast<int>(i), matches[k]};
+            pairs.push_back(pair);
+        }
+    }
+}
+
+float SparseIoUMatrix::at(size_t row, size_t col) const {
+    if (row >= rows || row + 1 >= row_ptr.size()) {
+        return 0.0f;
+    }
+    std::vector<int>::const_iterator begin = col_index.begin() + row_ptr[row];
+    std::vector<int>::const_iterator end = col_index.begin() + row_ptr[row + 1];
+    std::vector<int>::const_iterator it = std::lower_bound(begin, end, static_cast<int>(col));
+    if (it == end || *it != static_cast<int>(col)) {
+        return 0.0f;
+    }
+    return values[it - col_index.begin()];
+}
+
+namespace {
+
+// 每个任务处理的行数
+const size_t kSparseRowGrain = 64;
+
+void prepareSparseBoxes(const std::vector<Box>& boxes, std::vector<PreparedBox>& prepared,
+                        std::vector<BEVBounds>& bounds, Executor& executor) {
+    prepared.resize(boxes.size());
+    bounds.resize(boxes.size());
+    executor.parallelFor(boxes.size(), 256, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            prepareBox(boxes[i], prepared[i]);
+            BEVBounds b = {prepared[i].min_x, prepared[i].min_z, prepared[i].max_x, prepared[i].max_z};
+            bounds[i] = b;
+        }
+    });
+}
+
+/**
+ * @brief 一个行块的非零元素，按行顺序存放
+ */
+struct SparseRowBlock {
+    std::vector<int> col_index;
+    std::vector<float> values;
+};
+
+void calculateSparseMatrix(const std::vector<Box>& boxes1, const std::vector<Box>& boxes2,
+                           SparseIoUMatrix& out, float cell_size, bool use_3d, Executor& executor) {
+    IOU3D_STAGE_TIMER(Stage::SPARSE_MATRIX);
+    std::vector<PreparedBox> prepared1, prepared2;
+    std::vector<BEVBounds> bounds1, bounds2;
+    prepareSparseBoxes(boxes1, prepared1, bounds1, executor);
+    prepareSparseBoxes(boxes2, prepared2, bounds2, executor);
+
+    BEVGrid grid(cell_size);
+    grid.build(bounds2);
+
+    // 各任务把行块的结果写入自己的缓冲区，每行的元素数单独记录，最后按行顺序拼接
+    const size_t rows = boxes1.size();
+    std::vector<SparseRowBlock> blocks((rows + kSparseRowGrain - 1) / kSparseRowGrain);
+    std::vector<int> row_count(rows, 0);
+    executor.parallelFor(rows, kSparseRowGrain, [&](size_t row_begin, size_t row_end) {
+        SparseRowBlock& block = blocks[row_begin / kSparseRowGrain];
+        std::vector<int> candidates;
+        for (size_t i = row_begin; i < row_end; ++i) {
+            grid.query(bounds1[i], candidates);
+            for (size_t k = 0; k < candidates.size(); ++k) {
+                int j = candidates[k];
+                float iou = use_3d ? calculateIoU3D(prepared1[i], prepared2[j])
+                                   : calculateBEVIoU(prepared1[i], prepared2[j]);
+                if (iou > 0.0f) {
+                    block.col_index.push_back(j);
+                    block.values.push_back(iou);
+                    ++row_count[i];
+                }
+            }
+        }
+    });
+
+    out.rows = rows;
+    out.cols = boxes2.size();
+    out.row_ptr.resize(rows + 1);
+    out.row_ptr[0] = 0;
+    for (size_t i = 0; i < rows; ++i) {
+        out.row_ptr[i + 1] = out.row_ptr[i] + row_count[i];
+    }
+    out.col_index.clear();
+    out.values.clear();
+    out.col_index.reserve(out.row_ptr[rows]);
+    out.values.reserve(out.row_ptr[rows]);
+    for (size_t b = 0; b < blocks.size(); ++b) {
+        out.col_index.insert(out.col_index.end(), blocks[b].col_index.begin(), blocks[b].col_index.end());
+        out.values.insert(out.values.end(), blocks[b].values.begin(), blocks[b].values.end());
+    }
+}
+
+} // namespace
+
+void calculateSparseIoU3DMatrix(const std::vector<Box>& boxes1, const std::vector<Box>& boxes2,
+                                SparseIoUMatrix& out, float cell_size) {
+    SerialExecutor serial;
+    calculateSparseMatrix(boxes1, boxes2, out, cell_size, true, serial);
+}
+
+void calculateSparseBEVIoUMatrix(const std::vector<Box>& boxes1, const std::vector<Box>& boxes2,
+                                 SparseIoUMatrix& out, float cell_size) {
+    SerialExecutor serial;
+    calculateSparseMatrix(boxes1, boxes2, out, cell_size, false, serial);
+}
+
+void calculateSparseIoU3DMatrix(const std::vector<Box>& boxes1, const std::vector<Box>& boxes2,
+                                SparseIoUMatrix& out, Executor& executor, float cell_size) {
+    calculateSparseMatrix(boxes1, boxes2, out, cell_size, true, executor);
+}
+
+void calculateSparseBEVIoUMatrix(const std::vector<Box>& boxes1, const std::vector<Box>& boxes2,
+                                 SparseIoUMatrix& out, Executor& executor, float cell_size) {
+    calculateSparseMatrix(boxes1, boxes2, out, cell_size, false, executor);
+}
+
+} // namespace nms
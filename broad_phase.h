@@ -0,0 +1,138 @@
+#pragma once
+
+#include "iou3d.h"
+
+#include <vector>
+#include <cstddef>
+
+namespace nms {
+
+/**
+ * @brief BEV平面（xoz）的轴对齐包围矩形
+ */
+struct BEVBounds {
+    float min_x;
+    float min_z;
+    float max_x;
+    float max_z;
+
+    // 严格相交判断，只接触边界时面积为0，视为不相交
+    bool overlaps(const BEVBounds& other) const {
+        return min_x < other.max_x && other.min_x < max_x &&
+               min_z < other.max_z && other.min_z < max_z;
+    }
+};
+
+/**
+ * @brief 计算包围盒BEV投影的轴对齐包围矩形
+ */
+BEVBounds computeBEVBounds(const Box& box);
+
+/**
+ * @brief 候选框对
+ */
+struct CandidatePair {
+    int first;
+    int second;
+};
+
+/**
+ * @brief 基于均匀网格的粗筛索引
+ * 每个框按其BEV包围矩形登记到覆盖的所有网格单元中（CSR存储）。
+ * 对于跨越多个单元的框对，只在两者包围矩形交集左下角所在的单元报告一次，因此无需去重。
+ */
+class BEVGrid {
+public:
+    /**
+     * @param cell_size 网格单元边长，<=0时根据框的平均尺寸自动选择
+     */
+    explicit BEVGrid(float cell_size = 0.0f);
+
+    /**
+     * @brief 重新建立索引，各缓冲区的容量在多次build之间保留
+     */
+    void build(const std::vector<Box>& boxes);
+    void build(const std::vector<BEVBounds>& bounds);
+
+    size_t size() const { return bounds_.size(); }
+    float cellSize() const { return cell_size_; }
+    const std::vector<BEVBounds>& bounds() const { return bounds_; }
+
+    /**
+     * @brief 查询包围矩形与bounds相交的所有框，结果按索引升序
+     */
+    void query(const BEVBounds& bounds, std::vector<int>& result) const;
+
+    /**
+     * @brief 网格内包围矩形相交的所有框对（first < second）
+     */
+    void selfPairs(std::vector<CandidatePair>& pairs) const;
+
+    /**
+     * @brief 另一组框与网格内框的候选对，first为others中的索引，second为网格内的索引
+     */
+    void crossPairs(const std::vector<BEVBounds>& others, std::vector<CandidatePair>& pairs) const;
+
+private:
+    int cellX(float x) const;
+    int cellZ(float z) const;
+
+    float requested_cell_size_;
+    float cell_size_;
+    float origin_x_;
+    float origin_z_;
+    int cols_;
+    int rows_;
+    std::vector<BEVBounds> bounds_;
+    // CSR：单元c中的框为cell_items_[cell_start_[c] .. cell_start_[c+1])
+    std::vector<int> cell_start_;
+    std::vector<int> cell_items_;
+    // 构建CSR时的写入位置，作为成员保留以便重复build时不再分配
+    std::vector<int> cell_fill_;
+};
+
+/**
+ * @brief CSR格式的稀疏IoU矩阵，只保存IoU大于0的元素
+ */
+struct SparseIoUMatrix {
+    size_t rows = 0;
+    size_t cols = 0;
+    // 长度为rows+1，第i行的元素为[row_ptr[i], row_ptr[i+1])
+    std::vector<int> row_ptr;
+    // 每行内按列号升序
+    std::vector<int> col_index;
+    std::vector<float> values;
+
+    size_t nonZeros() const { return values.size(); }
+
+    /**
+     * @brief 读取(row, col)处的IoU，不存在时返回0
+     */
+    float at(size_t row, size_t col) const;
+};
+
+/**
+ * @brief 通过网格粗筛计算稀疏3D IoU矩阵
+ * @param boxes1 行对应的包围盒
+ * @param boxes2 列对应的包围盒（在其上建立网格）
+ * @param out 输出的稀疏矩阵
+ * @param cell_size 网格单元边长，<=0时自动选择
+ */
+void calculateSparseIoU3DMatrix(const std::vector<Box>& boxes1, const std::vector<Box>& boxes2,
+                                SparseIoUMatrix& out, float cell_size = 0.0f);
+
+/**
+ * @brief 通过网格粗筛计算稀疏BEV IoU矩阵
+ */
+void calculateSparseBEVIoUMatrix(const std::vector<Box>& boxes1, const std::vector<Box>& boxes2,
+                                 SparseIoUMatrix& out, float cell_size = 0.0f);
+
+/**
+ * @brief 并行计算稀疏3D/BEV IoU矩阵，行分块到各任务，结果与串行版本完全一致
+ */
+void calculateSparseIoU3DMatrix(const std::vector<Box>& boxes1, const std::vector<Box>& boxes2,
+                                SparseIoUMatrix& out, Executor& executor, float cell_size = 0.0f);
+void calculateSparseBEVIoUMatrix(const std::vector<Box>& boxes1, const std::vector<Box>& boxes2,
+                                 SparseIoUMatrix& out, Executor& executor, float cell_size = 0.0f);
+
+} // namespace nms
@@ -0,0 +1,146 @@
+#include "cpu_dispatch.h"
+#include "box_batch.h"
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+namespace nms {
+
+namespace {
+
+/**
+ * @brief 后端名称与级别，级别越高指令集越新
+ */
+struct BackendLevel {
+    const char* name;
+    int level;
+};
+
+const BackendLevel kLevels[] = {
+    {"scalar", 0}, {"sse2", 1}, {"neon", 1}, {"sse41", 2}, {"avx2", 3}, {"avx512", 4}
+};
+
+int levelOf(const char* name) {
+    for (size_t i = 0; i < sizeof(kLevels) / sizeof(kLevels[0]); ++i) {
+        if (std::strcmp(kLevels[i].name, name) == 0) {
+            return kLevels[i].level;
+        }
+    }
+    return -1;
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define IOU3D_X86_CPUID 1
+#endif
+
+/**
+ * @brief 编译进库且当前CPU支持的内核表，按级别从低到高排列
+ */
+struct SupportedTables {
+    const detail::KernelTable* tables[6];
+    size_t count;
+
+    SupportedTables() : count(0) {
+        tables[count++] = &simd_scalar::kernelTable();
+#if defined(__SSE2__) || defined(_M_X64)
+        tables[count++] = &simd_sse2::kernelTable();
+#elif defined(__ARM_NEON)
+        tables[count++] = &simd_neon::kernelTable();
+#endif
+#if defined(IOU3D_X86_CPUID)
+        __builtin_cpu_init();
+#if defined(IOU3D_DISPATCH_SSE41)
+        if (__builtin_cpu_supports("sse4.1")) {
+            tables[count++] = &simd_sse41::kernelTable();
+        }
+#endif
+#if defined(IOU3D_DISPATCH_AVX2)
+        if (__builtin_cpu_supports("avx2")) {
+            tables[count++] = &simd_avx2::kernelTable();
+        }
+#endif
+#if defined(IOU3D_DISPATCH_AVX512)
+        if (__builtin_cpu_supports("avx512f")) {
+            tables[count++] = &simd_avx512::kernelTable();
+        }
+#endif
+#endif
+    }
+};
+
+const SupportedTables& supportedTables() {
+    static const SupportedTables supported;
+    return supported;
+}
+
+const detail::KernelTable* findTable(const char* name) {
+    const SupportedTables& supported = supportedTables();
+    for (size_t i = 0; i < supported.count; ++i) {
+        if (std::strcmp(supported.tables[i]->name, name) == 0) {
+            return supported.tables[i];
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief 默认选择最高级别；IOU3D_FORCE_ISA指定的后端不可用时，选择不高于它的最高级别
+ */
+const detail::KernelTable* selectInitialTable() {
+    const SupportedTables& supported = supportedTables();
+    const detail::KernelTable* best = supported.tables[supported.count - 1];
+    const char* forced = std::getenv("IOU3D_FORCE_ISA");
+    if (!forced || levelOf(forced) < 0) {
+        return best;
+    }
+    if (const detail::KernelTable* exact = findTable(forced)) {
+        return exact;
+    }
+    const int limit = levelOf(forced);
+    const detail::KernelTable* chosen = supported.tables[0];
+    for (size_t i = 0; i < supported.count; ++i) {
+        if (levelOf(supported.tables[i]->name) <= limit) {
+            chosen = supported.tables[i];
+        }
+    }
+    return chosen;
+}
+
+std::atomic<const detail::KernelTable*>& activeTable() {
+    static std::atomic<const detail::KernelTable*> active(selectInitialTable());
+    return active;
+}
+
+} // namespace
+
+namespace detail {
+
+const KernelTable& activeKernels() {
+    return *activeTable().load(std::memory_order_acquire);
+}
+
+} // namespace detail
+
+const char* simdBackendName() {
+    return detail::activeKernels().name;
+}
+
+std::vector<std::string> availableSimdBackends() {
+    const SupportedTables& supported = supportedTables();
+    std::vector<std::string> names;
+    for (size_t i = 0; i < supported.count; ++i) {
+        names.push_back(supported.tables[i]->name);
+    }
+    return names;
+}
+
+bool setSimdBackend(const std::string& name) {
+    const detail::KernelTable* table = findTable(name.c_str());
+    if (!table) {
+        return false;
+    }
+    activeTable().store(table, std::memory_order_release);
+    return true;
+}
+
+} // namespace nms
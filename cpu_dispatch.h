@@ -0,0 +1,65 @@
+#pragma once
+
+// 内部头文件：SIMD内核的运行时分发表，不对外安装
+// 每个指令集的内核在单独的翻译单元（simd_kernels_*.cpp）中以对应的编译选项生成，
+// 运行时按CPU支持的指令集选择其中一个，同一个二进制可以部署在不同代的CPU上
+
+#include <cstddef>
+
+namespace nms {
+namespace detail {
+
+/**
+ * @brief 一对多BEV IoU中参考框的预计算量
+ * 坐标相对于origin（参考框中心），候选框在内核中平移到同一原点，减小叉积的舍入误差
+ */
+struct BEVReference {
+    float origin_x;
+    float origin_z;
+    // 逆时针顶点，顺序与boxToBEVCorners一致
+    float corner_x[4];
+    float corner_z[4];
+    // 边向量corner[k + 1] - corner[k]，以及判断候选框的边与之共线的容差
+    float edge_x[4];
+    float edge_z[4];
+    float collinear_tolerance[4];
+    float min_x;
+    float min_z;
+    float max_x;
+    float max_z;
+    float area;
+};
+
+/**
+ * @brief 一个指令集的内核函数表
+ */
+struct KernelTable {
+    // 后端名称，与simd::backendName()一致
+    const char* name;
+    // SoA包围盒的BEV顶点，语义见computeBEVCorners
+    void (*bev_corners)(const float* center_x, const float* center_z,
+                        const float* length, const float* width, const float* yaw,
+                        size_t n, float* const corners_x[4], float* const corners_z[4]);
+    // 参考框与SoA候选框的BEV IoU，语义见calculateBEVIoUOneToMany
+    void (*bev_iou_one_to_many)(const BEVReference& reference, const float* center_x, const float* center_z,
+                                const float* length, const float* width, const float* yaw,
+                                size_t n, float* out);
+};
+
+/**
+ * @brief 当前使用的内核表
+ * 首次调用时选择当前CPU支持的最高指令集，环境变量IOU3D_FORCE_ISA可以指定其他级别
+ */
+const KernelTable& activeKernels();
+
+} // namespace detail
+
+// 各后端命名空间中的内核表，只有编译进库的后端才有定义
+namespace simd_scalar { const detail::KernelTable& kernelTable(); }
+namespace simd_sse2 { const detail::KernelTable& kernelTable(); }
+namespace simd_neon { const detail::KernelTable& kernelTable(); }
+namespace simd_sse41 { const detail::KernelTable& kernelTable(); }
+namespace simd_avx2 { const detail::KernelTable& kernelTable(); }
+namespace simd_avx512 { const detail::KernelTable& kernelTable(); }
+
+} // namespace nms
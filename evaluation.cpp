@@ -0,0 +1,333 @@
+#include "evaluation.h"
+#include "executor.h"
+#include <algorithm>
+
+namespace nms {
+
+struct Evaluator::FrameMatches {
+    std::vector<int> class_ids;
+    std::vector<float> scores;
+    std::vector<char> tp;
+    // (class_id, 真值框个数)，按class_id升序
+    std::vector<std::pair<int, size_t> > num_ground_truth;
+};
+
+namespace {
+
+/**
+ * @brief 检测框排序：类别升序，同类别内置信度降序，置信度相同时索引小的优先
+ */
+struct DetectionLess {
+    const std::vector<Box>* boxes;
+
+    bool operator()(int a, int b) const {
+        const Box& box_a = (*boxes)[a];
+        const Box& box_b = (*boxes)[b];
+        if (box_a.class_id != box_b.class_id) {
+            return box_a.class_id < box_b.class_id;
+        }
+        if (box_a.confidence != box_b.confidence) {
+            return box_a.confidence > box_b.confidence;
+        }
+        return a < b;
+    }
+};
+
+struct GroundTruthLess {
+    const std::vector<Box>* boxes;
+
+    bool operator()(int a, int b) const {
+        const Box& box_a = (*boxes)[a];
+        const Box& box_b = (*boxes)[b];
+        if (box_a.class_id != box_b.class_id) {
+            return box_a.class_id < box_b.class_id;
+        }
+        return a < b;
+    }
+};
+
+std::vector<int> sortedIndices(size_t count) {
+    std::vector<int> indices(count);
+    for (size_t i = 0; i < count; ++i) {
+        indices[i] = static_cast<int>(i);
+    }
+    return indices;
+}
+
+/**
+ * @brief 由未插值的PR曲线计算AP
+ */
+float averagePrecision(const PRCurve& curve, size_t num_ground_truth, int num_recall_points) {
+    if (num_ground_truth == 0 || curve.precision.empty()) {
+        return 0.0f;
+    }
+    // 插值精度：召回率不低于当前点的所有点中的最大精度
+    std::vector<float> envelope(curve.precision);
+    for (size_t i = envelope.size() - 1; i > 0; --i) {
+        envelope[i - 1] = std::max(envelope[i - 1], envelope[i]);
+    }
+
+    double sum = 0.0;
+    if (num_recall_points > 0) {
+        // 召回率是非降序列，取第一个达到召回点的位置
+        for (int k = 1; k <= num_recall_points; ++k) {
+            float target = static_cast<float>(k) / static_cast<float>(num_recall_points);
+            std::vector<float>::const_iterator it =
+                std::lower_bound(curve.recall.begin(), curve.recall.end(), target);
+            if (it == curve.recall.end()) {
+                break;
+            }
+            sum += envelope[it - curve.recall.begin()];
+        }
+        return static_cast<float>(sum / num_recall_points);
+    }
+
+    float previous_recall = 0.0f;
+    for (size_t i = 0; i < envelope.size(); ++i) {
+        sum += static_cast<double>(curve.recall[i] - previous_recall) * envelope[i];
+        previous_recall = curve.recall[i];
+    }
+    return static_cast<float>(sum);
+}
+
+} // namespace
+
+float EvaluationResult::meanAP(size_t threshold_index) const {
+    double sum = 0.0;
+    size_t count = 0;
+    for (size_t c = 0; c < classes.size(); ++c) {
+        if (classes[c].num_ground_truth == 0 || threshold_index >= classes[c].ap.size()) {
+            continue;
+        }
+        sum += classes[c].ap[threshold_index];
+        ++count;
+    }
+    return count > 0 ? static_cast<float>(sum / count) : 0.0f;
+}
+
+Evaluator::Evaluator(const EvalConfig& config) : config_(config), num_frames_(0) {}
+
+void Evaluator::matchFrame(const std::vector<Box>& ground_truth, const std::vector<Box>& detections,
+                           const EvalConfig& config, FrameMatches& matches) {
+    const size_t num_thresholds = config.iou_thresholds.size();
+    const bool use_3d = config.iou_type == IoUType::IOU_3D;
+
+    DetectionLess detection_less = {&detections};
+    GroundTruthLess ground_truth_less = {&ground_truth};
+    std::vector<int> det_order = sortedIndices(detections.size());
+    std::vector<int> gt_order = sortedIndices(ground_truth.size());
+    std::sort(det_order.begin(), det_order.end(), detection_less);
+    std::sort(gt_order.begin(), gt_order.end(), ground_truth_less);
+
+    std::vector<PreparedBox> prepared_det(detections.size());
+    std::vector<PreparedBox> prepared_gt(ground_truth.size());
+    for (size_t i = 0; i < detections.size(); ++i) {
+        prepareBox(detections[i], prepared_det[i]);
+    }
+    for (size_t i = 0; i < ground_truth.size(); ++i) {
+        prepareBox(ground_truth[i], prepared_gt[i]);
+    }
+
+    matches.class_ids.reserve(matches.class_ids.size() + detections.size());
+    matches.scores.reserve(matches.scores.size() + detections.size());
+    matches.tp.reserve(matches.tp.size() + detections.size() * num_thresholds);
+
+    std::vector<float> iou;
+    std::vector<char> gt_used;
+    size_t det_pos = 0;
+    size_t gt_pos = 0;
+    // 两个有序序列按类别归并，每个类别处理一次
+    while (det_pos < det_order.size() || gt_pos < gt_order.size()) {
+        int class_id;
+        if (gt_pos == gt_order.size()) {
+            class_id = detections[det_order[det_pos]].class_id;
+        } else if (det_pos == det_order.size()) {
+            class_id = ground_truth[gt_order[gt_pos]].class_id;
+        } else {
+            class_id = std::min(detections[det_order[det_pos]].class_id,
+                                ground_truth[gt_order[gt_pos]].class_id);
+        }
+        size_t det_begin = det_pos;
+        size_t gt_begin = gt_pos;
+        while (det_pos < det_order.size() && detections[det_order[det_pos]].class_id == class_id) {
+            ++det_pos;
+        }
+        while (gt_pos < gt_order.size() && ground_truth[gt_order[gt_pos]].class_id == class_id) {
+            ++gt_pos;
+        }
+        const size_t num_det = det_pos - det_begin;
+        const size_t num_gt = gt_pos - gt_begin;
+        if (num_gt > 0) {
+            matches.num_ground_truth.push_back(std::make_pair(class_id, num_gt));
+        }
+        if (num_det == 0) {
+            continue;
+        }
+
+        // 该类别的IoU矩阵只计算一次，所有阈值共用
+        iou.resize(num_det * num_gt);
+        for (size_t i = 0; i < num_det; ++i) {
+            const PreparedBox& det = prepared_det[det_order[det_begin + i]];
+            for (size_t j = 0; j < num_gt; ++j) {
+                const PreparedBox& gt = prepared_gt[gt_order[gt_begin + j]];
+                iou[i * num_gt + j] = use_3d ? calculateIoU3D(det, gt) : calculateBEVIoU(det, gt);
+            }
+        }
+
+        size_t tp_begin = matches.tp.size();
+        for (size_t i = 0; i < num_det; ++i) {
+            matches.class_ids.push_back(class_id);
+            matches.scores.push_back(detections[det_order[det_begin + i]].confidence);
+        }
+        matches.tp.resize(tp_begin + num_det * num_thresholds, 0);
+
+        for (size_t t = 0; t < num_thresholds; ++t) {
+            const float threshold = config.iou_thresholds[t];
+            gt_used.assign(num_gt, 0);
+            for (size_t i = 0; i < num_det; ++i) {
+                const float* row = iou.data() + i * num_gt;
+                int best = -1;
+                float best_iou = 0.0f;
+                for (size_t j = 0; j < num_gt; ++j) {
+                    if (!gt_used[j] && row[j] > 0.0f && row[j] >= threshold && row[j] > best_iou) {
+                        best = static_cast<int>(j);
+                        best_iou = row[j];
+                    }
+                }
+                if (best >= 0) {
+                    gt_used[best] = 1;
+                    matches.tp[tp_begin + i * num_thresholds + t] = 1;
+                }
+            }
+        }
+    }
+}
+
+void Evaluator::append(const FrameMatches& matches) {
+    class_ids_.insert(class_ids_.end(), matches.class_ids.begin(), matches.class_ids.end());
+    scores_.insert(scores_.end(), matches.scores.begin(), matches.scores.end());
+    tp_.insert(tp_.end(), matches.tp.begin(), matches.tp.end());
+    for (size_t k = 0; k < matches.num_ground_truth.size(); ++k) {
+        num_ground_truth_[matches.num_ground_truth[k].first] += matches.num_ground_truth[k].second;
+    }
+    ++num_frames_;
+}
+
+void Evaluator::addFrame(const std::vector<Box>& ground_truth, const std::vector<Box>& detections) {
+    FrameMatches matches;
+    matchFrame(ground_truth, detections, config_, matches);
+    append(matches);
+}
+
+void Evaluator::addFrames(const std::vector<EvalFrame>& frames) {
+    SerialExecutor executor;
+    addFrames(frames, executor);
+}
+
+void Evaluator::addFrames(const std::vector<EvalFrame>& frames, Executor& executor) {
+    // 各帧独立匹配后按帧顺序合并，结果与线程数无关
+    std::vector<FrameMatches> per_frame(frames.size());
+    const EvalConfig& config = config_;
+    executor.parallelFor(frames.size(), 8, [&](size_t begin, size_t end) {
+        for (size_t f = begin; f < end; ++f) {
+            matchFrame(frames[f].ground_truth, frames[f].detections, config, per_frame[f]);
+        }
+    });
+    for (size_t f = 0; f < per_frame.size(); ++f) {
+        append(per_frame[f]);
+    }
+}
+
+EvaluationResult Evaluator::result() const {
+    const size_t num_thresholds = config_.iou_thresholds.size();
+    EvaluationResult result;
+    result.iou_thresholds = config_.iou_thresholds;
+    result.num_frames = num_frames_;
+
+    // 所有检测框按类别升序、置信度降序排列，置信度相同时按加入顺序
+    std::vector<int> order = sortedIndices(class_ids_.size());
+    const std::vector<int>& class_ids = class_ids_;
+    const std::vector<float>& scores = scores_;
+    std::sort(order.begin(), order.end(), [&class_ids, &scores](int a, int b) {
+        if (class_ids[a] != class_ids[b]) {
+            return class_ids[a] < class_ids[b];
+        }
+        if (scores[a] != scores[b]) {
+            return scores[a] > scores[b];
+        }
+        return a < b;
+    });
+
+    // 出现在真值或检测中的所有类别
+    std::vector<int> classes;
+    for (std::map<int, size_t>::const_iterator it = num_ground_truth_.begin(); it != num_ground_truth_.end(); ++it) {
+        classes.push_back(it->first);
+    }
+    for (size_t k = 0; k < order.size(); ++k) {
+        if (k == 0 || class_ids[order[k]] != class_ids[order[k - 1]]) {
+            classes.push_back(class_ids[order[k]]);
+        }
+    }
+    std::sort(classes.begin(), classes.end());
+    classes.erase(std::unique(classes.begin(), classes.end()), classes.end());
+
+    size_t pos = 0;
+    for (size_t c = 0; c < classes.size(); ++c) {
+        ClassEvaluation evaluation;
+        evaluation.class_id = classes[c];
+        std::map<int, size_t>::const_iterator found = num_ground_truth_.find(classes[c]);
+        evaluation.num_ground_truth = found != num_ground_truth_.end() ? found->second : 0;
+
+        size_t begin = pos;
+        while (pos < order.size() && class_ids[order[pos]] == classes[c]) {
+            ++pos;
+        }
+        evaluation.num_detections = pos - begin;
+        evaluation.ap.resize(num_thresholds);
+        evaluation.curves.resize(num_thresholds);
+
+        for (size_t t = 0; t < num_thresholds; ++t) {
+            PRCurve& curve = evaluation.curves[t];
+            curve.scores.resize(evaluation.num_detections);
+            curve.precision.resize(evaluation.num_detections);
+            curve.recall.resize(evaluation.num_detections);
+            size_t true_positives = 0;
+            for (size_t k = 0; k < evaluation.num_detections; ++k) {
+                int index = order[begin + k];
+                true_positives += tp_[static_cast<size_t>(index) * num_thresholds + t] ? 1 : 0;
+                curve.scores[k] = scores[index];
+                curve.precision[k] = static_cast<float>(true_positives) / static_cast<float>(k + 1);
+                curve.recall[k] = evaluation.num_ground_truth > 0
+                                      ? static_cast<float>(true_positives) /
+                                            static_cast<float>(evaluation.num_ground_truth)
+                                      : 0.0f;
+            }
+            evaluation.ap[t] = averagePrecision(curve, evaluation.num_ground_truth, config_.num_recall_points);
+        }
+        result.classes.push_back(evaluation);
+    }
+    return result;
+}
+
+void Evaluator::clear() {
+    class_ids_.clear();
+    scores_.clear();
+    tp_.clear();
+    num_ground_truth_.clear();
+    num_frames_ = 0;
+}
+
+EvaluationResult evaluate(const std::vector<EvalFrame>& frames, const EvalConfig& config) {
+    Evaluator evaluator(config);
+    evaluator.addFrames(frames);
+    return evaluator.result();
+}
+
+EvaluationResult evaluate(const std::vector<EvalFrame>& frames, const EvalConfig& config,
+                          Executor& executor) {
+    Evaluator evaluator(config);
+    evaluator.addFrames(frames, executor);
+    return evaluator.result();
+}
+
+} // namespace nms
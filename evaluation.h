@@ -0,0 +1,135 @@
+#pragma once
+
+#include "iou3d.h"
+#include "nms.h"
+
+#include <vector>
+#include <map>
+#include <cstddef>
+
+namespace nms {
+
+/**
+ * @brief 一帧的真值框与检测框
+ * 类别取Box::class_id，检测框的置信度取Box::confidence（真值框的置信度不使用）
+ */
+struct EvalFrame {
+    std::vector<Box> ground_truth;
+    std::vector<Box> detections;
+};
+
+/**
+ * @brief 评估参数
+ */
+struct EvalConfig {
+    // 同时评估的IoU阈值，每帧的IoU矩阵只计算一次，所有阈值共用
+    std::vector<float> iou_thresholds = {0.5f, 0.7f};
+    // 使用BEV IoU还是3D IoU判断检测框与真值框是否匹配
+    IoUType iou_type = IoUType::IOU_3D;
+    // 插值召回点个数：N>0时在召回率1/N, 2/N, ..., 1处取插值精度求平均（40对应KITTI R40），
+    // 0表示对插值后的PR曲线逐点积分（VOC 2010之后的做法）
+    int num_recall_points = 40;
+};
+
+/**
+ * @brief 一个类别在一个IoU阈值下的PR曲线
+ * 每个检测框对应一个点，按置信度降序排列（置信度相同时按加入顺序），
+ * precision为未插值的精度
+ */
+struct PRCurve {
+    std::vector<float> scores;
+    std::vector<float> precision;
+    std::vector<float> recall;
+};
+
+/**
+ * @brief 一个类别的评估结果，ap与curves按EvalConfig::iou_thresholds的顺序排列
+ */
+struct ClassEvaluation {
+    int class_id;
+    size_t num_ground_truth;
+    size_t num_detections;
+    std::vector<float> ap;
+    std::vector<PRCurve> curves;
+};
+
+/**
+ * @brief 评估结果
+ */
+struct EvaluationResult {
+    std::vector<float> iou_thresholds;
+    // 按class_id升序，包含在真值或检测中出现过的所有类别
+    std::vector<ClassEvaluation> classes;
+    size_t num_frames = 0;
+
+    /**
+     * @brief 第threshold_index个阈值下的mAP，只对有真值框的类别求平均
+     */
+    float meanAP(size_t threshold_index) const;
+};
+
+/**
+ * @brief 逐帧累积匹配结果的评估器
+ * 每帧按类别计算一次检测框×真值框的IoU矩阵，在每个阈值下按置信度降序贪心匹配
+ * （每个检测框匹配IoU最大且尚未被匹配的同类真值框），只保留每个检测框的类别、
+ * 置信度和各阈值下是否为TP，因此可以流式处理任意多帧。
+ */
+class Evaluator {
+public:
+    explicit Evaluator(const EvalConfig& config = EvalConfig());
+
+    const EvalConfig& config() const { return config_; }
+
+    /**
+     * @brief 加入一帧
+     */
+    void addFrame(const std::vector<Box>& ground_truth, const std::vector<Box>& detections);
+
+    /**
+     * @brief 加入多帧，帧之间由执行器并行匹配，结果与逐帧调用addFrame完全一致
+     */
+    void addFrames(const std::vector<EvalFrame>& frames);
+    void addFrames(const std::vector<EvalFrame>& frames, Executor& executor);
+
+    /**
+     * @brief 由已加入的所有帧计算各类别的AP和PR曲线
+     */
+    EvaluationResult result() const;
+
+    /**
+     * @brief 清空已加入的帧，保留参数
+     */
+    void clear();
+
+    size_t numFrames() const { return num_frames_; }
+
+private:
+    // 一帧的匹配结果，定义在evaluation.cpp中
+    struct FrameMatches;
+
+    static void matchFrame(const std::vector<Box>& ground_truth, const std::vector<Box>& detections,
+                           const EvalConfig& config, FrameMatches& matches);
+    void append(const FrameMatches& matches);
+
+    EvalConfig config_;
+    // 所有检测框的类别、置信度，以及每个检测框在各阈值下是否为TP（检测框数×阈值数）
+    std::vector<int> class_ids_;
+    std::vector<float> scores_;
+    std::vector<char> tp_;
+    // 各类别的真值框个数
+    std::map<int, size_t> num_ground_truth_;
+    size_t num_frames_;
+};
+
+/**
+ * @brief 评估一组帧，等价于依次addFrame后调用result()
+ */
+EvaluationResult evaluate(const std::vector<EvalFrame>& frames, const EvalConfig& config = EvalConfig());
+
+/**
+ * @brief 评估一组帧（并行版本），结果与串行版本完全一致
+ */
+EvaluationResult evaluate(const std::vector<EvalFrame>& frames, const EvalConfig& config,
+                          Executor& executor);
+
+} // namespace nms
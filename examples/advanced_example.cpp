@@ -45,10 +45,12 @@ void calculateIoUMatrix(const std::vector<Box>& boxes) {
     }
     std::cout << std::endl;
     
+    std::vector<float> iou_matrix(n * n);
+    calculateIoU3DMatrix(boxes, boxes, iou_matrix.data());
     for (size_t i = 0; i < n; ++i) {
         std::cout << std::setw(8) << ("Box" + std::to_string(i));
         for (size_t j = 0; j < n; ++j) {
-            float iou = calculateIoU3D(boxes[i], boxes[j]);
+            float iou = iou_matrix[i * n + j];
             std::cout << std::setw(8) << std::fixed << std::setprecision(3) << iou;
         }
         std::cout << std::endl;
@@ -61,10 +63,12 @@ void calculateIoUMatrix(const std::vector<Box>& boxes) {
     }
     std::cout << std::endl;
     
+    std::vector<float> bev_matrix(n * n);
+    calculateBEVIoUMatrix(boxes, boxes, bev_matrix.data());
     for (size_t i = 0; i < n; ++i) {
         std::cout << std::setw(8) << ("Box" + std::to_string(i));
         for (size_t j = 0; j < n; ++j) {
-            float iou = calculateBEVIoU(boxes[i], boxes[j]);
+            float iou = bev_matrix[i * n + j];
             std::cout << std::setw(8) << std::fixed << std::setprecision(3) << iou;
         }
         std::cout << std::endl;
@@ -0,0 +1,139 @@
+#include "executor.h"
+#include <algorithm>
+
+namespace nms {
+
+namespace {
+
+// 标记当前线程是否正在执行线程池任务（工作线程，或parallelFor期间的调用线程），
+// 用于让嵌套调用退化为顺序执行，避免死锁
+thread_local bool in_pool_task = false;
+
+void runSerial(size_t count, size_t grain, const std::function<void(size_t, size_t)>& body) {
+    for (size_t begin = 0; begin < count; begin += grain) {
+        body(begin, std::min(count, begin + grain));
+    }
+}
+
+} // namespace
+
+void SerialExecutor::parallelFor(size_t count, size_t grain,
+                                 const std::function<void(size_t, size_t)>& body) {
+    runSerial(count, std::max<size_t>(grain, 1), body);
+}
+
+ThreadPool::ThreadPool(size_t num_threads)
+    : stop_(false), generation_(0), body_(nullptr), count_(0), grain_(1),
+      num_chunks_(0), next_chunk_(0), active_workers_(0) {
+    if (num_threads == 0) {
+        num_threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    }
+    // 调用线程也参与计算
+    for (size_t i = 1; i < num_threads; ++i) {
+        workers_.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    work_ready_.notify_all();
+    for (size_t i = 0; i < workers_.size(); ++i) {
+        workers_[i].join();
+    }
+}
+
+void ThreadPool::runChunks() {
+    for (;;) {
+        size_t chunk = next_chunk_.fetch_add(1);
+        if (chunk >= num_chunks_) {
+            break;
+        }
+        size_t begin = chunk * grain_;
+        try {
+            (*body_)(begin, std::min(count_, begin + grain_));
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_) {
+                error_ = std::current_exception();
+            }
+            // 其他线程不再领取新的任务块
+            next_chunk_.store(num_chunks_);
+        }
+    }
+}
+
+void ThreadPool::workerLoop() {
+    in_pool_task = true;
+    unsigned long seen_generation = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_ready_.wait(lock, [this, seen_generation] {
+                return stop_ || generation_ != seen_generation;
+            });
+            if (stop_) {
+                return;
+            }
+            seen_generation = generation_;
+        }
+
+        runChunks();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--active_workers_ == 0) {
+                work_done_.notify_one();
+            }
+        }
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, size_t grain,
+                             const std::function<void(size_t, size_t)>& body) {
+    grain = std::max<size_t>(grain, 1);
+    size_t num_chunks = (count + grain - 1) / grain;
+    if (workers_.empty() || num_chunks <= 1 || in_pool_task) {
+        runSerial(count, grain, body);
+        return;
+    }
+
+    std::unique_lock<std::mutex> submit_lock(submit_mutex_, std::try_to_lock);
+    if (!submit_lock.owns_lock()) {
+        runSerial(count, grain, body);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        body_ = &body;
+        count_ = count;
+        grain_ = grain;
+        num_chunks_ = num_chunks;
+        next_chunk_.store(0);
+        active_workers_ = workers_.size();
+        error_ = nullptr;
+        ++generation_;
+    }
+    work_ready_.notify_all();
+
+    // runChunks不抛出异常，工作线程结束前不会离开这里，body在此期间始终有效
+    in_pool_task = true;
+    runChunks();
+    in_pool_task = false;
+
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        work_done_.wait(lock, [this] { return active_workers_ == 0; });
+        body_ = nullptr;
+        error.swap(error_);
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+} // namespace nms
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+
+namespace nms {
+
+/**
+ * @brief 并行执行器接口
+ * 批量IoU矩阵和NMS通过该接口并行化，用户可以接入自己的线程池实现。
+ * 所有并行接口的结果与线程数无关（每个输出元素只由一个任务写入）。
+ */
+class Executor {
+public:
+    virtual ~Executor() {}
+
+    /**
+     * @brief 将[0, count)划分为长度不超过grain的块并执行body(begin, end)，阻塞直到全部完成
+     */
+    virtual void parallelFor(size_t count, size_t grain,
+                             const std::function<void(size_t, size_t)>& body) = 0;
+
+    /**
+     * @brief 可同时执行的任务数
+     */
+    virtual size_t concurrency() const = 0;
+};
+
+/**
+ * @brief 在调用线程上顺序执行的执行器
+ */
+class SerialExecutor : public Executor {
+public:
+    void parallelFor(size_t count, size_t grain,
+                     const std::function<void(size_t, size_t)>& body) override;
+    size_t concurrency() const override { return 1; }
+};
+
+/**
+ * @brief 固定大小的线程池
+ * 工作线程与调用线程通过原子计数器动态领取任务块，负载不均时自动平衡。
+ * 在任务内部嵌套调用（无论在工作线程还是调用线程上），或线程池正被其他线程占用时，
+ * 任务在调用线程上顺序执行。
+ * body抛出异常时，剩余的任务块不再领取，parallelFor等待已开始的任务块结束后
+ * 在调用线程上重新抛出第一个异常。
+ */
+class ThreadPool : public Executor {
+public:
+    /**
+     * @param num_threads 总线程数（包括调用线程），0表示使用硬件并发数
+     */
+    explicit ThreadPool(size_t num_threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void parallelFor(size_t count, size_t grain,
+                     const std::function<void(size_t, size_t)>& body) override;
+    size_t concurrency() const override { return workers_.size() + 1; }
+
+private:
+    void workerLoop();
+    void runChunks();
+
+    std::vector<std::thread> workers_;
+    std::mutex submit_mutex_;
+    std::mutex mutex_;
+    std::condition_variable work_ready_;
+    std::condition_variable work_done_;
+    bool stop_;
+    unsigned long generation_;
+
+    // 当前任务
+    const std::function<void(size_t, size_t)>* body_;
+    size_t count_;
+    size_t grain_;
+    size_t num_chunks_;
+    std::atomic<size_t> next_chunk_;
+    size_t active_workers_;
+    // 当前任务中第一个被抛出的异常
+    std::exception_ptr error_;
+};
+
+} // namespace nms
@@ -1,110 +1,318 @@
 #include "iou3d.h"
+#include "executor.h"
+#include "quad_kernel.h"
+#include "stats_hooks.h"
 #include <cmath>
 #include <algorithm>
 #include <cassert>
+#include <utility>
 
 namespace nms {
 
-Polygon2D boxToBEVPolygon(const Box& box) {
+namespace {
+
+/**
+ * @brief 由已知的yaw三角函数值计算BEV顶点，结果相对于(origin_x, origin_z)
+ * BoxType为Box、BoxPOD或BoxParams，只读取中心和尺寸字段
+ */
+template <typename T, typename BoxType>
+void cornersFromTrig(const BoxType& box, T cos_yaw, T sin_yaw, T origin_x, T origin_z,
+                     BasicPoint2D<T> corners[4]) {
     // 在BEV视角（xoz平面）中，计算旋转后的4个顶点
-    float half_length = box.length * 0.5f; // x方向的一半
-    float half_width = box.width * 0.5f;   // z方向的一半
-    
-    float cos_yaw = std::cos(box.yaw);
-    float sin_yaw = std::sin(box.yaw);
-    
-    Polygon2D polygon;
-    polygon.reserve(4);
+    T half_length = T(box.length) * T(0.5); // x方向的一半
+    T half_width = T(box.width) * T(0.5);   // z方向的一半
     
     // 定义相对于中心的4个顶点（未旋转）
     // 逆时针方向：右前、右后、左后、左前
-    float vertices[4][2] = {
+    T vertices[4][2] = {
         {half_length, half_width},   // 右前 (x=length/2, z=width/2)
         {-half_length, half_width},  // 左前 (x=-length/2, z=width/2)
         {-half_length, -half_width}, // 左后 (x=-length/2, z=-width/2)
         {half_length, -half_width}   // 右后 (x=length/2, z=-width/2)
     };
     
+    // 先在目标精度下平移中心，远离原点时可避免精度损失
+    T center_x = T(box.center_x) - origin_x;
+    T center_z = T(box.center_z) - origin_z;
+    
     // 应用旋转并平移到中心位置
     for (int i = 0; i < 4; ++i) {
-        float local_x = vertices[i][0];
-        float local_z = vertices[i][1];
+        T local_x = vertices[i][0];
+        T local_z = vertices[i][1];
         
         // 绕y轴旋转（从z轴绕向x轴为正向）
-        float rotated_x = local_x * cos_yaw + local_z * sin_yaw;
-        float rotated_z = -local_x * sin_yaw + local_z * cos_yaw;
+        T rotated_x = local_x * cos_yaw + local_z * sin_yaw;
+        T rotated_z = -local_x * sin_yaw + local_z * cos_yaw;
         
         // 平移到世界坐标
-        polygon.emplace_back(rotated_x + box.center_x, rotated_z + box.center_z);
+        corners[i] = BasicPoint2D<T>(rotated_x + center_x, rotated_z + center_z);
+    }
+}
+
+/**
+ * @brief 按行存放的原始参数，字段名与Box一致
+ */
+struct BoxParams {
+    float center_x;
+    float center_y;
+    float center_z;
+    float length;
+    float width;
+    float height;
+    float yaw;
+};
+
+template <typename BoxType>
+void prepareFields(const BoxType& box, PreparedBox& prepared) {
+    float cos_yaw = std::cos(box.yaw);
+    float sin_yaw = std::sin(box.yaw);
+    cornersFromTrig(box, cos_yaw, sin_yaw, 0.0f, 0.0f, prepared.corners);
+    
+    // 局部坐标系下各边的内法向量为(0,-1)、(1,0)、(0,1)、(-1,0)，旋转到世界坐标
+    prepared.edge_normals[0] = Point2D(-sin_yaw, -cos_yaw);
+    prepared.edge_normals[1] = Point2D(cos_yaw, -sin_yaw);
+    prepared.edge_normals[2] = Point2D(sin_yaw, cos_yaw);
+    prepared.edge_normals[3] = Point2D(-cos_yaw, sin_yaw);
+    
+    prepared.min_x = prepared.max_x = prepared.corners[0].x;
+    prepared.min_z = prepared.max_z = prepared.corners[0].z;
+    for (int k = 1; k < 4; ++k) {
+        prepared.min_x = std::min(prepared.min_x, prepared.corners[k].x);
+        prepared.max_x = std::max(prepared.max_x, prepared.corners[k].x);
+        prepared.min_z = std::min(prepared.min_z, prepared.corners[k].z);
+        prepared.max_z = std::max(prepared.max_z, prepared.corners[k].z);
     }
     
-    return polygon;
+    prepared.center_x = box.center_x;
+    prepared.center_z = box.center_z;
+    prepared.radius = 0.5f * std::sqrt(box.length * box.length + box.width * box.width);
+    prepared.half_length = 0.5f * std::abs(box.length);
+    prepared.half_width = 0.5f * std::abs(box.width);
+    prepared.area = std::abs(box.length * box.width);
+    prepared.volume = prepared.area * box.height;
+    prepared.y_min = box.center_y - box.height * 0.5f;
+    prepared.y_max = box.center_y + box.height * 0.5f;
 }
 
-float getLineIntersectionX(float x1, float z1, float x2, float z2,
-                          float x3, float z3, float x4, float z4) {
-    float numerator = (x1*z2 - z1*x2) * (x3-x4) - (x1-x2) * (x3*z4 - z3*x4);
-    float denominator = (x1-x2) * (z3-z4) - (z1-z2) * (x3-x4);
+template <typename T, typename BoxType>
+void bevCorners(const BoxType& box, BasicPoint2D<T> corners[4], T origin_x, T origin_z) {
+    T yaw = T(box.yaw);
+    cornersFromTrig(box, T(std::cos(yaw)), T(std::sin(yaw)), origin_x, origin_z, corners);
+}
+
+} // namespace
+
+int ClassTable::intern(const std::string& name) {
+    std::unordered_map<std::string, int>::const_iterator it = ids_.find(name);
+    if (it != ids_.end()) {
+        return it->second;
+    }
+    int class_id = names_.empty() ? 0 : names_.rbegin()->first + 1;
+    set(class_id, name);
+    return class_id;
+}
+
+void ClassTable::set(int class_id, const std::string& name) {
+    names_[class_id] = name;
+    ids_[name] = class_id;
+}
+
+int ClassTable::find(const std::string& name) const {
+    std::unordered_map<std::string, int>::const_iterator it = ids_.find(name);
+    return it != ids_.end() ? it->second : -1;
+}
+
+const std::string& ClassTable::name(int class_id) const {
+    static const std::string empty;
+    std::map<int, std::string>::const_iterator it = names_.find(class_id);
+    return it != names_.end() ? it->second : empty;
+}
+
+BoxPOD toBoxPOD(const Box& box) {
+    BoxPOD pod;
+    pod.center_x = box.center_x;
+    pod.center_y = box.center_y;
+    pod.center_z = box.center_z;
+    pod.length = box.length;
+    pod.width = box.width;
+    pod.height = box.height;
+    pod.yaw = box.yaw;
+    pod.confidence = box.confidence;
+    pod.class_id = box.class_id;
+    return pod;
+}
+
+BoxPOD toBoxPOD(const Box& box, ClassTable& table) {
+    if (!box.class_name.empty() && !table.contains(box.class_id)) {
+        table.set(box.class_id, box.class_name);
+    }
+    return toBoxPOD(box);
+}
+
+std::vector<BoxPOD> toBoxPODs(const std::vector<Box>& boxes, ClassTable* table) {
+    std::vector<BoxPOD> pods(boxes.size());
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        pods[i] = table ? toBoxPOD(boxes[i], *table) : toBoxPOD(boxes[i]);
+    }
+    return pods;
+}
+
+Box toBox(const BoxPOD& box) {
+    Box result;
+    result.class_id = box.class_id;
+    result.center_x = box.center_x;
+    result.center_y = box.center_y;
+    result.center_z = box.center_z;
+    result.length = box.length;
+    result.width = box.width;
+    result.height = box.height;
+    result.yaw = box.yaw;
+    result.confidence = box.confidence;
+    return result;
+}
+
+Box toBox(const BoxPOD& box, const ClassTable& table) {
+    Box result = toBox(box);
+    result.class_name = table.name(box.class_id);
+    return result;
+}
+
+template <typename T>
+void boxToBEVCorners(const Box& box, BasicPoint2D<T> corners[4], T origin_x, T origin_z) {
+    bevCorners(box, corners, origin_x, origin_z);
+}
+
+void boxToBEVCorners(const Box& box, Point2D corners[4]) {
+    boxToBEVCorners<float>(box, corners, 0.0f, 0.0f);
+}
+
+void prepareBox(const Box& box, PreparedBox& prepared) {
+    prepareFields(box, prepared);
+}
+
+void prepareBox(const float params[7], PreparedBox& prepared) {
+    BoxParams box = {params[0], params[1], params[2], params[3], params[4], params[5], params[6]};
+    prepareFields(box, prepared);
+}
+
+PreparedBox prepareBox(const Box& box) {
+    PreparedBox prepared;
+    prepareBox(box, prepared);
+    return prepared;
+}
+
+void prepareBox(const BoxPOD& box, PreparedBox& prepared) {
+    prepareFields(box, prepared);
+}
+
+PreparedBox prepareBox(const BoxPOD& box) {
+    PreparedBox prepared;
+    prepareFields(box, prepared);
+    return prepared;
+}
+
+Polygon2D boxToBEVPolygon(const Box& box) {
+    Point2D corners[4];
+    boxToBEVCorners(box, corners);
+    return Polygon2D(corners, corners + 4);
+}
+
+template <typename T>
+T getLineIntersectionX(T x1, T z1, T x2, T z2,
+                       T x3, T z3, T x4, T z4) {
+    T numerator = (x1*z2 - z1*x2) * (x3-x4) - (x1-x2) * (x3*z4 - z3*x4);
+    T denominator = (x1-x2) * (z3-z4) - (z1-z2) * (x3-x4);
     
     // 避免除零
-    if (std::abs(denominator) < 1e-10f) {
-        return 0.0f;
+    if (std::abs(denominator) < T(1e-10)) {
+        IOU3D_STAT_INC(DEGENERATE_DENOMINATORS);
+        return T(0);
     }
     
     return numerator / denominator;
 }
 
-float getLineIntersectionZ(float x1, float z1, float x2, float z2,
-                          float x3, float z3, float x4, float z4) {
-    float numerator = (x1*z2 - z1*x2) * (z3-z4) - (z1-z2) * (x3*z4 - z3*x4);
-    float denominator = (x1-x2) * (z3-z4) - (z1-z2) * (x3-x4);
+template <typename T>
+T getLineIntersectionZ(T x1, T z1, T x2, T z2,
+                       T x3, T z3, T x4, T z4) {
+    T numerator = (x1*z2 - z1*x2) * (z3-z4) - (z1-z2) * (x3*z4 - z3*x4);
+    T denominator = (x1-x2) * (z3-z4) - (z1-z2) * (x3-x4);
     
     // 避免除零
-    if (std::abs(denominator) < 1e-10f) {
-        return 0.0f;
+    if (std::abs(denominator) < T(1e-10)) {
+        IOU3D_STAT_INC(DEGENERATE_DENOMINATORS);
+        return T(0);
     }
     
     return numerator / denominator;
 }
 
-float calculatePolygonArea(const Polygon2D& polygon) {
-    if (polygon.size() < 3) {
-        return 0.0f;
+float getLineIntersectionX(float x1, float z1, float x2, float z2,
+                          float x3, float z3, float x4, float z4) {
+    return getLineIntersectionX<float>(x1, z1, x2, z2, x3, z3, x4, z4);
+}
+
+float getLineIntersectionZ(float x1, float z1, float x2, float z2,
+                          float x3, float z3, float x4, float z4) {
+    return getLineIntersectionZ<float>(x1, z1, x2, z2, x3, z3, x4, z4);
+}
+
+template <typename T>
+T calculatePolygonArea(const BasicPoint2D<T>* points, size_t count) {
+    if (count < 3) {
+        return T(0);
     }
     
-    float area = 0.0f;
-    size_t n = polygon.size();
+    T area = T(0);
     
-    // 使用鞋带公式
-    for (size_t i = 0; i < n; ++i) {
-        size_t j = (i + 1) % n;
-        area += polygon[i].x * polygon[j].z - polygon[j].x * polygon[i].z;
+    // 使用鞋带公式，以第一个顶点为参考点，远离原点时不会因大数相减损失精度
+    const T origin_x = points[0].x;
+    const T origin_z = points[0].z;
+    for (size_t i = 1; i + 1 < count; ++i) {
+        T ax = points[i].x - origin_x;
+        T az = points[i].z - origin_z;
+        T bx = points[i + 1].x - origin_x;
+        T bz = points[i + 1].z - origin_z;
+        area += ax * bz - bx * az;
     }
     
-    return std::abs(area) * 0.5f;
+    return std::abs(area) * T(0.5);
 }
 
-Polygon2D clipPolygonByLine(const Polygon2D& polygon, 
-                           float x1, float z1, float x2, float z2) {
-    if (polygon.empty()) {
-        return Polygon2D();
-    }
-    
-    Polygon2D clipped;
-    
-    for (size_t i = 0; i < polygon.size(); ++i) {
+template <typename T>
+T calculatePolygonArea(const BasicPolygon2D<T>& polygon) {
+    return calculatePolygonArea<T>(polygon.data(), polygon.size());
+}
+
+float calculatePolygonArea(const Point2D* points, size_t count) {
+    return calculatePolygonArea<float>(points, count);
+}
+
+float calculatePolygonArea(const Polygon2D& polygon) {
+    return calculatePolygonArea<float>(polygon.data(), polygon.size());
+}
+
+namespace {
+
+/**
+ * @brief 单边裁剪的公共实现，输出容器可以是Polygon2D或StaticPolygon
+ */
+template <typename T, typename Output>
+void clipByLine(const BasicPoint2D<T>* polygon, size_t count,
+                T x1, T z1, T x2, T z2, Output& clipped) {
+    for (size_t i = 0; i < count; ++i) {
         size_t curr_i = i;
-        size_t next_i = (i + 1) % polygon.size();
+        size_t next_i = (i + 1) % count;
         
-        float curr_x = polygon[curr_i].x;
-        float curr_z = polygon[curr_i].z;
-        float next_x = polygon[next_i].x;
-        float next_z = polygon[next_i].z;
+        T curr_x = polygon[curr_i].x;
+        T curr_z = polygon[curr_i].z;
+        T next_x = polygon[next_i].x;
+        T next_z = polygon[next_i].z;
         
         // 计算点相对于裁剪线的位置
         // 使用叉积判断点在线的哪一侧（左侧为内侧）
-        float curr_side = (x2 - x1) * (curr_z - z1) - (z2 - z1) * (curr_x - x1);
-        float next_side = (x2 - x1) * (next_z - z1) - (z2 - z1) * (next_x - x1);
+        T curr_side = (x2 - x1) * (curr_z - z1) - (z2 - z1) * (curr_x - x1);
+        T next_side = (x2 - x1) * (next_z - z1) - (z2 - z1) * (next_x - x1);
         
         // 当前点是否在内侧
         bool curr_inside = curr_side >= 0;
@@ -112,63 +320,422 @@ Polygon2D clipPolygonByLine(const Polygon2D& polygon,
         
         if (curr_inside && next_inside) {
             // 案例1：两个点都在内侧，添加next点
-            clipped.emplace_back(next_x, next_z);
+            clipped.push_back(BasicPoint2D<T>(next_x, next_z));
         } else if (curr_inside && !next_inside) {
             // 案例2：当前点在内侧，下一个点在外侧，添加交点
-            float intersect_x = getLineIntersectionX(curr_x, curr_z, next_x, next_z, x1, z1, x2, z2);
-            float intersect_z = getLineIntersectionZ(curr_x, curr_z, next_x, next_z, x1, z1, x2, z2);
-            clipped.emplace_back(intersect_x, intersect_z);
+            T intersect_x = getLineIntersectionX<T>(curr_x, curr_z, next_x, next_z, x1, z1, x2, z2);
+            T intersect_z = getLineIntersectionZ<T>(curr_x, curr_z, next_x, next_z, x1, z1, x2, z2);
+            clipped.push_back(BasicPoint2D<T>(intersect_x, intersect_z));
         } else if (!curr_inside && next_inside) {
             // 案例3：当前点在外侧，下一个点在内侧，添加交点和next点
-            float intersect_x = getLineIntersectionX(curr_x, curr_z, next_x, next_z, x1, z1, x2, z2);
-            float intersect_z = getLineIntersectionZ(curr_x, curr_z, next_x, next_z, x1, z1, x2, z2);
-            clipped.emplace_back(intersect_x, intersect_z);
-            clipped.emplace_back(next_x, next_z);
+            T intersect_x = getLineIntersectionX<T>(curr_x, curr_z, next_x, next_z, x1, z1, x2, z2);
+            T intersect_z = getLineIntersectionZ<T>(curr_x, curr_z, next_x, next_z, x1, z1, x2, z2);
+            clipped.push_back(BasicPoint2D<T>(intersect_x, intersect_z));
+            clipped.push_back(BasicPoint2D<T>(next_x, next_z));
         }
         // 案例4：两个点都在外侧，不添加任何点
     }
-    
+}
+
+} // namespace
+
+template <typename T>
+BasicPolygon2D<T> clipPolygonByLine(const BasicPolygon2D<T>& polygon,
+                                    T x1, T z1, T x2, T z2) {
+    BasicPolygon2D<T> clipped;
+    clipByLine(polygon.data(), polygon.size(), x1, z1, x2, z2, clipped);
     return clipped;
 }
 
-Polygon2D sutherlandHodgmanClip(const Polygon2D& subject, const Polygon2D& clipper) {
+Polygon2D clipPolygonByLine(const Polygon2D& polygon, 
+                           float x1, float z1, float x2, float z2) {
+    return clipPolygonByLine<float>(polygon, x1, z1, x2, z2);
+}
+
+void clipPolygonByLine(const IntersectionPolygon& polygon,
+                       float x1, float z1, float x2, float z2,
+                       IntersectionPolygon& clipped) {
+    clipped.clear();
+    clipByLine(polygon.points, polygon.size(), x1, z1, x2, z2, clipped);
+}
+
+template <typename T>
+BasicPolygon2D<T> sutherlandHodgmanClip(const BasicPolygon2D<T>& subject, const BasicPolygon2D<T>& clipper) {
     if (subject.empty() || clipper.empty()) {
-        return Polygon2D();
+        return BasicPolygon2D<T>();
     }
     
-    Polygon2D clipped = subject;
+    BasicPolygon2D<T> clipped = subject;
     
     // 对每条裁剪边进行裁剪
     for (size_t i = 0; i < clipper.size(); ++i) {
         size_t next_i = (i + 1) % clipper.size();
         
-        clipped = clipPolygonByLine(clipped, 
-                                   clipper[i].x, clipper[i].z,
-                                   clipper[next_i].x, clipper[next_i].z);
+        clipped = clipPolygonByLine<T>(clipped, 
+                                      clipper[i].x, clipper[i].z,
+                                      clipper[next_i].x, clipper[next_i].z);
         
         if (clipped.empty()) {
             break;
         }
     }
     
+    IOU3D_STAT_CLIP_VERTICES(clipped.size());
+    if (clipped.empty()) {
+        IOU3D_STAT_INC(EMPTY_INTERSECTIONS);
+    }
     return clipped;
 }
 
-float calculateBEVIoU(const Box& box1, const Box& box2) {
-    // 将3D包围盒投影到BEV平面
-    Polygon2D poly1 = boxToBEVPolygon(box1);
-    Polygon2D poly2 = boxToBEVPolygon(box2);
+Polygon2D sutherlandHodgmanClip(const Polygon2D& subject, const Polygon2D& clipper) {
+    return sutherlandHodgmanClip<float>(subject, clipper);
+}
+
+void sutherlandHodgmanClip(const Point2D* subject, size_t subject_size,
+                           const Point2D* clipper, size_t clipper_size,
+                           IntersectionPolygon& result) {
+    result.clear();
+    if (subject_size == 0 || clipper_size == 0) {
+        return;
+    }
+    
+    // 两个缓冲区交替作为输入和输出
+    IntersectionPolygon buffer;
+    for (size_t i = 0; i < subject_size; ++i) {
+        result.push_back(subject[i]);
+    }
+    
+    IntersectionPolygon* input = &result;
+    IntersectionPolygon* output = &buffer;
+    for (size_t i = 0; i < clipper_size; ++i) {
+        size_t next_i = (i + 1) % clipper_size;
+        
+        clipPolygonByLine(*input,
+                          clipper[i].x, clipper[i].z,
+                          clipper[next_i].x, clipper[next_i].z,
+                          *output);
+        std::swap(input, output);
+        
+        if (input->empty()) {
+            break;
+        }
+    }
+    
+    if (input != &result) {
+        result = *input;
+    }
+    IOU3D_STAT_CLIP_VERTICES(result.size());
+    if (result.empty()) {
+        IOU3D_STAT_INC(EMPTY_INTERSECTIONS);
+    }
+}
+
+namespace {
+
+template <typename T>
+inline T cross(T ax, T az, T bx, T bz) {
+    return ax * bz - az * bx;
+}
+
+/**
+ * @brief 判断点是否在逆时针凸四边形内部（含边界，带相对容差）
+ */
+template <typename T>
+inline bool insideQuad(const BasicPoint2D<T>& p, const BasicPoint2D<T> quad[4]) {
+    bool inside = true;
+    for (int k = 0; k < 4; ++k) {
+        const BasicPoint2D<T>& a = quad[k];
+        const BasicPoint2D<T>& b = quad[(k + 1) & 3];
+        T ex = b.x - a.x;
+        T ez = b.z - a.z;
+        T tolerance = T(1e-5) * (ex * ex + ez * ez);
+        inside &= cross(ex, ez, p.x - a.x, p.z - a.z) >= -tolerance;
+    }
+    return inside;
+}
+
+/**
+ * @brief 伪极角，与atan2单调一致，取值范围[0, 4)
+ */
+template <typename T>
+inline T pseudoAngle(T dx, T dz) {
+    T sum = std::abs(dx) + std::abs(dz);
+    if (sum <= T(0)) {
+        return T(0);
+    }
+    T ratio = dx / sum;
+    return dz >= T(0) ? T(1) - ratio : T(3) + ratio;
+}
+
+/**
+ * @brief 收集两个凸四边形交集的顶点，按极角排序
+ * 返回的顶点已减去质心(center_x, center_z)；kRecord为true时同时记录每个顶点的来源
+ * @return 顶点数，少于3时交集为空
+ */
+template <typename T, bool kRecord>
+int collectIntersection(const BasicPoint2D<T> quad1[4], const BasicPoint2D<T> quad2[4],
+                        BasicPoint2D<T> points[24], detail::VertexSource sources[24],
+                        T& center_x, T& center_z) {
+    // 候选顶点：4+4个角点和最多16个边交点
+    int count = 0;
+    
+    for (int i = 0; i < 4; ++i) {
+        if (insideQuad(quad1[i], quad2)) {
+            if (kRecord) {
+                sources[count].kind = detail::VertexSource::CORNER1;
+                sources[count].index1 = i;
+                sources[count].index2 = -1;
+            }
+            points[count++] = quad1[i];
+        }
+    }
+    for (int i = 0; i < 4; ++i) {
+        if (insideQuad(quad2[i], quad1)) {
+            if (kRecord) {
+                sources[count].kind = detail::VertexSource::CORNER2;
+                sources[count].index1 = -1;
+                sources[count].index2 = i;
+            }
+            points[count++] = quad2[i];
+        }
+    }
+    
+    // 边与边的交点：p + t*r 与 q + u*s，两个参数共用同一个分母
+    const T param_tolerance = T(1e-6);
+    for (int i = 0; i < 4; ++i) {
+        const BasicPoint2D<T>& p = quad1[i];
+        T rx = quad1[(i + 1) & 3].x - p.x;
+        T rz = quad1[(i + 1) & 3].z - p.z;
+        for (int j = 0; j < 4; ++j) {
+            const BasicPoint2D<T>& q = quad2[j];
+            T sx = quad2[(j + 1) & 3].x - q.x;
+            T sz = quad2[(j + 1) & 3].z - q.z;
+            
+            T denominator = cross(rx, rz, sx, sz);
+            if (std::abs(denominator) < T(1e-10)) {
+                IOU3D_STAT_INC(PARALLEL_EDGES);
+                continue; // 平行边，交点已由角点测试覆盖
+            }
+            
+            T qpx = q.x - p.x;
+            T qpz = q.z - p.z;
+            T t = cross(qpx, qpz, sx, sz) / denominator;
+            T u = cross(qpx, qpz, rx, rz) / denominator;
+            if (t >= -param_tolerance && t <= T(1) + param_tolerance &&
+                u >= -param_tolerance && u <= T(1) + param_tolerance) {
+                if (kRecord) {
+                    sources[count].kind = detail::VertexSource::EDGE_CROSSING;
+                    sources[count].index1 = i;
+                    sources[count].index2 = j;
+                }
+                points[count++] = BasicPoint2D<T>(p.x + t * rx, p.z + t * rz);
+            }
+        }
+    }
+    
+    if (count < 3) {
+        return count;
+    }
+    
+    // 以质心为参考按极角排序（交集为凸多边形，质心在其内部）
+    center_x = T(0);
+    center_z = T(0);
+    for (int i = 0; i < count; ++i) {
+        center_x += points[i].x;
+        center_z += points[i].z;
+    }
+    center_x /= count;
+    center_z /= count;
+    
+    T angles[24];
+    for (int i = 0; i < count; ++i) {
+        points[i].x -= center_x;
+        points[i].z -= center_z;
+        angles[i] = pseudoAngle(points[i].x, points[i].z);
+    }
+    
+    // 顶点数很少，插入排序即可
+    for (int i = 1; i < count; ++i) {
+        BasicPoint2D<T> point = points[i];
+        detail::VertexSource source;
+        if (kRecord) {
+            source = sources[i];
+        }
+        T angle = angles[i];
+        int j = i - 1;
+        while (j >= 0 && angles[j] > angle) {
+            points[j + 1] = points[j];
+            if (kRecord) {
+                sources[j + 1] = sources[j];
+            }
+            angles[j + 1] = angles[j];
+            --j;
+        }
+        points[j + 1] = point;
+        if (kRecord) {
+            sources[j + 1] = source;
+        }
+        angles[j + 1] = angle;
+    }
+    
+    return count;
+}
+
+} // namespace
+
+template <typename T>
+T calculateQuadIntersectionArea(const BasicPoint2D<T> quad1[4], const BasicPoint2D<T> quad2[4]) {
+    BasicPoint2D<T> points[24];
+    T center_x;
+    T center_z;
+    int count = collectIntersection<T, false>(quad1, quad2, points, nullptr, center_x, center_z);
+    IOU3D_STAT_CLIP_VERTICES(static_cast<size_t>(count));
+    if (count < 3) {
+        IOU3D_STAT_INC(EMPTY_INTERSECTIONS);
+        return T(0);
+    }
+    
+    // 相对质心的鞋带公式，重复顶点不影响结果
+    T area = T(0);
+    for (int i = 0; i < count; ++i) {
+        const BasicPoint2D<T>& a = points[i];
+        const BasicPoint2D<T>& b = points[(i + 1) % count];
+        area += cross(a.x, a.z, b.x, b.z);
+    }
+    
+    return std::abs(area) * T(0.5);
+}
+
+namespace detail {
+
+template <typename T>
+int quadIntersectionPolygon(const BasicPoint2D<T> quad1[4], const BasicPoint2D<T> quad2[4],
+                            BasicPoint2D<T> points[24], VertexSource sources[24]) {
+    T center_x;
+    T center_z;
+    int count = collectIntersection<T, true>(quad1, quad2, points, sources, center_x, center_z);
+    if (count < 3) {
+        return 0;
+    }
+    for (int i = 0; i < count; ++i) {
+        points[i].x += center_x;
+        points[i].z += center_z;
+    }
+    return count;
+}
+
+template int quadIntersectionPolygon<float>(const BasicPoint2D<float>[4], const BasicPoint2D<float>[4],
+                                            BasicPoint2D<float>[24], VertexSource[24]);
+template int quadIntersectionPolygon<double>(const BasicPoint2D<double>[4], const BasicPoint2D<double>[4],
+                                             BasicPoint2D<double>[24], VertexSource[24]);
+
+} // namespace detail
+
+float calculateQuadIntersectionArea(const Point2D quad1[4], const Point2D quad2[4]) {
+    return calculateQuadIntersectionArea<float>(quad1, quad2);
+}
+
+namespace {
+
+/**
+ * @brief 外接圆或轴对齐包围矩形不相交时，BEV交集必为0
+ */
+inline bool disjointBEV(const PreparedBox& box1, const PreparedBox& box2) {
+    float dx = box1.center_x - box2.center_x;
+    float dz = box1.center_z - box2.center_z;
+    float radius_sum = box1.radius + box2.radius;
+    if (dx * dx + dz * dz >= radius_sum * radius_sum) {
+        IOU3D_STAT_INC(BEV_REJECTS);
+        return true;
+    }
     
-    // 计算两个多边形的交集
-    Polygon2D intersection = sutherlandHodgmanClip(poly1, poly2);
+    bool disjoint = box1.min_x >= box2.max_x || box2.min_x >= box1.max_x ||
+                    box1.min_z >= box2.max_z || box2.min_z >= box1.max_z;
+    if (disjoint) {
+        IOU3D_STAT_INC(BEV_REJECTS);
+    }
+    return disjoint;
+}
+
+inline float intervalOverlap(float center1, float half1, float center2, float half2) {
+    float overlap = std::min(center1 + half1, center2 + half2) - std::max(center1 - half1, center2 - half2);
+    return overlap > 0.0f ? overlap : 0.0f;
+}
+
+/**
+ * @brief BEV交集面积，yaw相差π/2的整数倍时使用轴对齐矩形求交
+ */
+inline float intersectionAreaBEV(const PreparedBox& box1, const PreparedBox& box2) {
+    // edge_normals[0] = (-sin, -cos)，两者的叉积为sin(Δyaw)，点积为cos(Δyaw)
+    const Point2D& n1 = box1.edge_normals[0];
+    const Point2D& n2 = box2.edge_normals[0];
+    float sin_delta = n1.x * n2.z - n1.z * n2.x;
+    float cos_delta = n1.x * n2.x + n1.z * n2.z;
+    if (std::abs(sin_delta * cos_delta) > 1e-6f) {
+        return calculateQuadIntersectionArea(box1.corners, box2.corners);
+    }
+    
+    IOU3D_STAT_INC(ALIGNED_PAIRS);
+    // 在box1的局部坐标系中计算box2的中心，局部x轴为(cos, -sin)，局部z轴为(sin, cos)
+    float cos_yaw = -n1.z;
+    float sin_yaw = -n1.x;
+    float dx = box2.center_x - box1.center_x;
+    float dz = box2.center_z - box1.center_z;
+    float local_x = dx * cos_yaw - dz * sin_yaw;
+    float local_z = dx * sin_yaw + dz * cos_yaw;
+    
+    // yaw相差±π/2时box2的长宽互换
+    bool swapped = std::abs(cos_delta) < std::abs(sin_delta);
+    float half_x = swapped ? box2.half_width : box2.half_length;
+    float half_z = swapped ? box2.half_length : box2.half_width;
+    
+    return intervalOverlap(0.0f, box1.half_length, local_x, half_x) *
+           intervalOverlap(0.0f, box1.half_width, local_z, half_z);
+}
+
+/**
+ * @brief 未预处理时的廉价排除：y区间（仅3D）和外接圆
+ */
+template <typename BoxType>
+inline bool quickRejectBoxes(const BoxType& box1, const BoxType& box2, bool check_y) {
+    if (check_y) {
+        float y_min = std::max(box1.center_y - box1.height * 0.5f, box2.center_y - box2.height * 0.5f);
+        float y_max = std::min(box1.center_y + box1.height * 0.5f, box2.center_y + box2.height * 0.5f);
+        if (y_min >= y_max) {
+            IOU3D_STAT_INC(Y_REJECTS);
+            return true;
+        }
+    }
+    
+    float dx = box1.center_x - box2.center_x;
+    float dz = box1.center_z - box2.center_z;
+    float diameter_sum2 = box1.length * box1.length + box1.width * box1.width +
+                          box2.length * box2.length + box2.width * box2.width;
+    float distance2 = dx * dx + dz * dz;
+    // (r1 + r2)^2 <= 2(r1^2 + r2^2)，先用不含开方的上界排除
+    if (2.0f * distance2 >= diameter_sum2) {
+        IOU3D_STAT_INC(BEV_REJECTS);
+        return true;
+    }
+    float radius_sum = 0.5f * (std::sqrt(box1.length * box1.length + box1.width * box1.width) +
+                               std::sqrt(box2.length * box2.length + box2.width * box2.width));
+    if (distance2 >= radius_sum * radius_sum) {
+        IOU3D_STAT_INC(BEV_REJECTS);
+        return true;
+    }
+    return false;
+}
+
+float preparedBEVIoU(const PreparedBox& box1, const PreparedBox& box2) {
+    if (disjointBEV(box1, box2)) {
+        return 0.0f;
+    }
     
-    // 计算面积
-    float area1 = calculatePolygonArea(poly1);
-    float area2 = calculatePolygonArea(poly2);
-    float area_intersection = calculatePolygonArea(intersection);
+    // 计算两个矩形的交集面积
+    float area_intersection = intersectionAreaBEV(box1, box2);
     
     // 计算并集面积
-    float area_union = area1 + area2 - area_intersection;
+    float area_union = box1.area + box2.area - area_intersection;
     
     // 避免除零
     if (area_union < 1e-10f) {
@@ -178,49 +745,312 @@ float calculateBEVIoU(const Box& box1, const Box& box2) {
     return area_intersection / area_union;
 }
 
-float calculateIoU3D(const Box& box1, const Box& box2) {
+float preparedIoU3D(const PreparedBox& box1, const PreparedBox& box2) {
+    // 先做廉价的y轴重叠判断，避免无效的多边形裁剪
+    float y_intersection_min = std::max(box1.y_min, box2.y_min);
+    float y_intersection_max = std::min(box1.y_max, box2.y_max);
+    
+    if (y_intersection_min >= y_intersection_max) {
+        IOU3D_STAT_INC(Y_REJECTS);
+        return 0.0f; // y轴方向没有重叠
+    }
+    
+    if (disjointBEV(box1, box2)) {
+        return 0.0f;
+    }
+    
     // 计算BEV平面的交集面积
-    Polygon2D poly1 = boxToBEVPolygon(box1);
-    Polygon2D poly2 = boxToBEVPolygon(box2);
-    Polygon2D intersection_poly = sutherlandHodgmanClip(poly1, poly2);
-    float intersection_area = calculatePolygonArea(intersection_poly);
+    float intersection_area = intersectionAreaBEV(box1, box2);
     
     if (intersection_area < 1e-10f) {
         return 0.0f; // BEV平面没有交集，3D IoU为0
     }
     
-    // 计算y轴方向的重叠
-    float box1_y_min = box1.center_y - box1.height * 0.5f;
-    float box1_y_max = box1.center_y + box1.height * 0.5f;
-    float box2_y_min = box2.center_y - box2.height * 0.5f;
-    float box2_y_max = box2.center_y + box2.height * 0.5f;
+    // 计算3D交集体积
+    float intersection_volume = intersection_area * (y_intersection_max - y_intersection_min);
+    
+    // 计算并集体积
+    float union_volume = box1.volume + box2.volume - intersection_volume;
+    
+    // 避免除零
+    if (union_volume < 1e-10f) {
+        return 0.0f;
+    }
+    
+    return intersection_volume / union_volume;
+}
+
+} // namespace
+
+float calculateBEVIoU(const PreparedBox& box1, const PreparedBox& box2) {
+    IOU3D_STAT_INC(PAIRS_EVALUATED);
+    return preparedBEVIoU(box1, box2);
+}
+
+float calculateIoU3D(const PreparedBox& box1, const PreparedBox& box2) {
+    IOU3D_STAT_INC(PAIRS_EVALUATED);
+    return preparedIoU3D(box1, box2);
+}
+
+namespace {
+
+template <typename BoxType>
+float bevIoU(const BoxType& box1, const BoxType& box2) {
+    IOU3D_STAT_INC(PAIRS_EVALUATED);
+    if (quickRejectBoxes(box1, box2, false)) {
+        return 0.0f;
+    }
+    return preparedBEVIoU(prepareBox(box1), prepareBox(box2));
+}
+
+template <typename BoxType>
+float iou3D(const BoxType& box1, const BoxType& box2) {
+    IOU3D_STAT_INC(PAIRS_EVALUATED);
+    if (quickRejectBoxes(box1, box2, true)) {
+        return 0.0f;
+    }
+    return preparedIoU3D(prepareBox(box1), prepareBox(box2));
+}
+
+template <typename T, typename BoxType>
+T bevIoU(const BoxType& box1, const BoxType& box2, bool recenter) {
+    IOU3D_STAT_INC(PAIRS_EVALUATED);
+    // 以两个中心的中点为原点，交集计算只涉及较小的相对坐标
+    T origin_x = T(0);
+    T origin_z = T(0);
+    if (recenter) {
+        origin_x = (T(box1.center_x) + T(box2.center_x)) * T(0.5);
+        origin_z = (T(box1.center_z) + T(box2.center_z)) * T(0.5);
+    }
+    
+    BasicPoint2D<T> poly1[4];
+    BasicPoint2D<T> poly2[4];
+    bevCorners<T>(box1, poly1, origin_x, origin_z);
+    bevCorners<T>(box2, poly2, origin_x, origin_z);
     
-    // 计算y轴方向的交集范围
-    float y_intersection_min = std::max(box1_y_min, box2_y_min);
-    float y_intersection_max = std::min(box1_y_max, box2_y_max);
+    T area1 = std::abs(T(box1.length) * T(box1.width));
+    T area2 = std::abs(T(box2.length) * T(box2.width));
+    T area_intersection = calculateQuadIntersectionArea<T>(poly1, poly2);
+    T area_union = area1 + area2 - area_intersection;
     
+    if (area_union < T(1e-10)) {
+        return T(0);
+    }
+    
+    return area_intersection / area_union;
+}
+
+template <typename T, typename BoxType>
+T iou3D(const BoxType& box1, const BoxType& box2, bool recenter) {
+    IOU3D_STAT_INC(PAIRS_EVALUATED);
+    T y_intersection_min = std::max(T(box1.center_y) - T(box1.height) * T(0.5),
+                                    T(box2.center_y) - T(box2.height) * T(0.5));
+    T y_intersection_max = std::min(T(box1.center_y) + T(box1.height) * T(0.5),
+                                    T(box2.center_y) + T(box2.height) * T(0.5));
     if (y_intersection_min >= y_intersection_max) {
-        return 0.0f; // y轴方向没有重叠
+        IOU3D_STAT_INC(Y_REJECTS);
+        return T(0);
     }
     
-    float y_intersection_height = y_intersection_max - y_intersection_min;
+    T origin_x = T(0);
+    T origin_z = T(0);
+    if (recenter) {
+        origin_x = (T(box1.center_x) + T(box2.center_x)) * T(0.5);
+        origin_z = (T(box1.center_z) + T(box2.center_z)) * T(0.5);
+    }
     
-    // 计算3D交集体积
-    float intersection_volume = intersection_area * y_intersection_height;
+    BasicPoint2D<T> poly1[4];
+    BasicPoint2D<T> poly2[4];
+    bevCorners<T>(box1, poly1, origin_x, origin_z);
+    bevCorners<T>(box2, poly2, origin_x, origin_z);
     
-    // 计算两个包围盒的体积
-    float volume1 = calculatePolygonArea(poly1) * box1.height;
-    float volume2 = calculatePolygonArea(poly2) * box2.height;
+    T intersection_area = calculateQuadIntersectionArea<T>(poly1, poly2);
+    if (intersection_area < T(1e-10)) {
+        return T(0);
+    }
     
-    // 计算并集体积
-    float union_volume = volume1 + volume2 - intersection_volume;
+    T intersection_volume = intersection_area * (y_intersection_max - y_intersection_min);
+    T volume1 = std::abs(T(box1.length) * T(box1.width)) * T(box1.height);
+    T volume2 = std::abs(T(box2.length) * T(box2.width)) * T(box2.height);
+    T union_volume = volume1 + volume2 - intersection_volume;
     
-    // 避免除零
-    if (union_volume < 1e-10f) {
-        return 0.0f;
+    if (union_volume < T(1e-10)) {
+        return T(0);
     }
     
     return intersection_volume / union_volume;
 }
 
+} // namespace
+
+float calculateBEVIoU(const Box& box1, const Box& box2) {
+    return bevIoU(box1, box2);
+}
+
+float calculateIoU3D(const Box& box1, const Box& box2) {
+    return iou3D(box1, box2);
+}
+
+float calculateBEVIoU(const BoxPOD& box1, const BoxPOD& box2) {
+    return bevIoU(box1, box2);
+}
+
+float calculateIoU3D(const BoxPOD& box1, const BoxPOD& box2) {
+    return iou3D(box1, box2);
+}
+
+template <typename T>
+T calculateBEVIoU(const Box& box1, const Box& box2, bool recenter) {
+    return bevIoU<T>(box1, box2, recenter);
+}
+
+template <typename T>
+T calculateIoU3D(const Box& box1, const Box& box2, bool recenter) {
+    return iou3D<T>(box1, box2, recenter);
+}
+
+template <typename T>
+T calculateBEVIoU(const BoxPOD& box1, const BoxPOD& box2, bool recenter) {
+    return bevIoU<T>(box1, box2, recenter);
+}
+
+template <typename T>
+T calculateIoU3D(const BoxPOD& box1, const BoxPOD& box2, bool recenter) {
+    return iou3D<T>(box1, box2, recenter);
+}
+
+// 显式实例化float与double版本
+#define IOU3D_INSTANTIATE_GEOMETRY(T) \
+    template void boxToBEVCorners<T>(const Box&, BasicPoint2D<T>[4], T, T); \
+    template T getLineIntersectionX<T>(T, T, T, T, T, T, T, T); \
+    template T getLineIntersectionZ<T>(T, T, T, T, T, T, T, T); \
+    template T calculatePolygonArea<T>(const BasicPoint2D<T>*, size_t); \
+    template T calculatePolygonArea<T>(const BasicPolygon2D<T>&); \
+    template BasicPolygon2D<T> clipPolygonByLine<T>(const BasicPolygon2D<T>&, T, T, T, T); \
+    template BasicPolygon2D<T> sutherlandHodgmanClip<T>(const BasicPolygon2D<T>&, const BasicPolygon2D<T>&); \
+    template T calculateQuadIntersectionArea<T>(const BasicPoint2D<T>[4], const BasicPoint2D<T>[4]); \
+    template T calculateBEVIoU<T>(const Box&, const Box&, bool); \
+    template T calculateIoU3D<T>(const Box&, const Box&, bool); \
+    template T calculateBEVIoU<T>(const BoxPOD&, const BoxPOD&, bool); \
+    template T calculateIoU3D<T>(const BoxPOD&, const BoxPOD&, bool);
+
+IOU3D_INSTANTIATE_GEOMETRY(float)
+IOU3D_INSTANTIATE_GEOMETRY(double)
+
+#undef IOU3D_INSTANTIATE_GEOMETRY
+
+namespace {
+
+template <typename BoxType>
+void prepareBoxes(const std::vector<BoxType>& boxes, std::vector<PreparedBox>& prepared,
+                  Executor& executor) {
+    prepared.resize(boxes.size());
+    executor.parallelFor(boxes.size(), 256, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            prepareBox(boxes[i], prepared[i]);
+        }
+    });
+}
+
+float bevIoUPair(const PreparedBox& box1, const PreparedBox& box2) {
+    return calculateBEVIoU(box1, box2);
+}
+
+float iou3DPair(const PreparedBox& box1, const PreparedBox& box2) {
+    return calculateIoU3D(box1, box2);
+}
+
+/**
+ * @brief 按行块和列块遍历计算矩阵，列块内的几何信息保持在缓存中
+ */
+template <typename PairFunction>
+void fillMatrixTile(const std::vector<PreparedBox>& prepared1, const std::vector<PreparedBox>& prepared2,
+                    size_t row_begin, size_t row_end, float* out, PairFunction pair_function) {
+    const size_t cols = prepared2.size();
+    const size_t col_tile = 64;
+    for (size_t col_begin = 0; col_begin < cols; col_begin += col_tile) {
+        size_t col_end = std::min(cols, col_begin + col_tile);
+        for (size_t i = row_begin; i < row_end; ++i) {
+            float* row = out + i * cols;
+            for (size_t j = col_begin; j < col_end; ++j) {
+                row[j] = pair_function(prepared1[i], prepared2[j]);
+            }
+        }
+    }
+}
+
+template <typename PairFunction>
+void fillPreparedMatrix(const std::vector<PreparedBox>& prepared1, const std::vector<PreparedBox>& prepared2,
+                        float* out, Executor& executor, PairFunction pair_function) {
+    // 每个任务处理16行
+    executor.parallelFor(prepared1.size(), 16, [&](size_t row_begin, size_t row_end) {
+        fillMatrixTile(prepared1, prepared2, row_begin, row_end, out, pair_function);
+    });
+}
+
+template <typename BoxType, typename PairFunction>
+void fillMatrix(const std::vector<BoxType>& boxes1, const std::vector<BoxType>& boxes2, float* out,
+                Executor& executor, PairFunction pair_function) {
+    IOU3D_STAGE_TIMER(Stage::IOU_MATRIX);
+    std::vector<PreparedBox> prepared1;
+    std::vector<PreparedBox> prepared2;
+    prepareBoxes(boxes1, prepared1, executor);
+    prepareBoxes(boxes2, prepared2, executor);
+    fillPreparedMatrix(prepared1, prepared2, out, executor, pair_function);
+}
+
+} // namespace
+
+void calculateIoU3DMatrix(const std::vector<Box>& boxes1, const std::vector<Box>& boxes2, float* out) {
+    SerialExecutor serial;
+    fillMatrix(boxes1, boxes2, out, serial, iou3DPair);
+}
+
+void calculateBEVIoUMatrix(const std::vector<Box>& boxes1, const std::vector<Box>& boxes2, float* out) {
+    SerialExecutor serial;
+    fillMatrix(boxes1, boxes2, out, serial, bevIoUPair);
+}
+
+void calculateIoU3DMatrix(const std::vector<Box>& boxes1, const std::vector<Box>& boxes2, float* out,
+                          Executor& executor) {
+    fillMatrix(boxes1, boxes2, out, executor, iou3DPair);
+}
+
+void calculateBEVIoUMatrix(const std::vector<Box>& boxes1, const std::vector<Box>& boxes2, float* out,
+                           Executor& executor) {
+    fillMatrix(boxes1, boxes2, out, executor, bevIoUPair);
+}
+
+void calculateIoU3DMatrix(const std::vector<BoxPOD>& boxes1, const std::vector<BoxPOD>& boxes2, float* out) {
+    SerialExecutor serial;
+    fillMatrix(boxes1, boxes2, out, serial, iou3DPair);
+}
+
+void calculateBEVIoUMatrix(const std::vector<BoxPOD>& boxes1, const std::vector<BoxPOD>& boxes2, float* out) {
+    SerialExecutor serial;
+    fillMatrix(boxes1, boxes2, out, serial, bevIoUPair);
+}
+
+void calculateIoU3DMatrix(const std::vector<BoxPOD>& boxes1, const std::vector<BoxPOD>& boxes2, float* out,
+                          Executor& executor) {
+    fillMatrix(boxes1, boxes2, out, executor, iou3DPair);
+}
+
+void calculateBEVIoUMatrix(const std::vector<BoxPOD>& boxes1, const std::vector<BoxPOD>& boxes2, float* out,
+                           Executor& executor) {
+    fillMatrix(boxes1, boxes2, out, executor, bevIoUPair);
+}
+
+void calculateIoU3DMatrix(const std::vector<PreparedBox>& boxes1, const std::vector<PreparedBox>& boxes2,
+                          float* out, Executor& executor) {
+    IOU3D_STAGE_TIMER(Stage::IOU_MATRIX);
+    fillPreparedMatrix(boxes1, boxes2, out, executor, iou3DPair);
+}
+
+void calculateBEVIoUMatrix(const std::vector<PreparedBox>& boxes1, const std::vector<PreparedBox>& boxes2,
+                           float* out, Executor& executor) {
+    IOU3D_STAGE_TIMER(Stage::IOU_MATRIX);
+    fillPreparedMatrix(boxes1, boxes2, out, executor, bevIoUPair);
+}
+
 } // namespace nms
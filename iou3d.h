@@ -2,12 +2,17 @@
 
 #include <vector>
 #include <string>
+#include <map>
+#include <unordered_map>
 #include <iostream>
 #include <cmath>
 #include <algorithm>
+#include <type_traits>
 
 namespace nms {
 
+class Executor;
+
 /**
  * @brief 相机坐标系下的3D包围盒
  * 坐标系定义：
@@ -46,20 +51,172 @@ struct Box {
     }
 };
 
+/**
+ * @brief 不含字符串的紧凑包围盒，可平凡复制（36字节）
+ * 字段含义与Box相同，类别名称只保存一份在ClassTable中。
+ * 排序、拷贝和按值传递都不会分配内存，适合大批量框的处理。
+ */
+struct BoxPOD {
+    float center_x;
+    float center_y;
+    float center_z;
+    // x方向尺寸
+    float length;
+    // z方向尺寸
+    float width;
+    // y方向尺寸
+    float height;
+    float yaw;
+    float confidence;
+    int class_id;
+};
+
+static_assert(std::is_trivially_copyable<BoxPOD>::value, "BoxPOD must stay trivially copyable");
+
+/**
+ * @brief class_id与类别名称的对照表，每个名称只保存一份
+ */
+class ClassTable {
+public:
+    /**
+     * @brief 返回名称对应的class_id；名称未出现过时分配新的id（当前最大id加1，空表从0开始）
+     */
+    int intern(const std::string& name);
+
+    /**
+     * @brief 设置class_id的名称，覆盖已有名称
+     */
+    void set(int class_id, const std::string& name);
+
+    /**
+     * @brief 名称对应的class_id，不存在时返回-1
+     */
+    int find(const std::string& name) const;
+
+    /**
+     * @brief class_id对应的名称，不存在时返回空字符串
+     */
+    const std::string& name(int class_id) const;
+
+    bool contains(int class_id) const { return names_.count(class_id) != 0; }
+    size_t size() const { return names_.size(); }
+    const std::map<int, std::string>& names() const { return names_; }
+
+private:
+    std::map<int, std::string> names_;
+    std::unordered_map<std::string, int> ids_;
+};
+
+/**
+ * @brief Box转换为BoxPOD，丢弃class_name
+ */
+BoxPOD toBoxPOD(const Box& box);
+
+/**
+ * @brief Box转换为BoxPOD，非空的class_name记入table（该class_id已有名称时不覆盖）
+ */
+BoxPOD toBoxPOD(const Box& box, ClassTable& table);
+
+/**
+ * @brief 批量转换，table为nullptr时丢弃class_name
+ */
+std::vector<BoxPOD> toBoxPODs(const std::vector<Box>& boxes, ClassTable* table = nullptr);
+
+/**
+ * @brief BoxPOD转换为Box，class_name从table中查找
+ */
+Box toBox(const BoxPOD& box, const ClassTable& table);
+
+/**
+ * @brief BoxPOD转换为Box，class_name为空
+ */
+Box toBox(const BoxPOD& box);
+
 /**
  * @brief 2D点结构体，用于BEV平面（xoz）
+ * @tparam T 坐标精度（float或double）
+ * 下文的几何模板函数定义在iou3d.cpp中，仅对float和double显式实例化
  */
-struct Point2D {
-    float x;
-    float z;  // 注意：这里是z坐标，不是y
+template <typename T>
+struct BasicPoint2D {
+    T x;
+    T z;  // 注意：这里是z坐标，不是y
     
-    Point2D(float x = 0.0f, float z = 0.0f) : x(x), z(z) {}
+    BasicPoint2D(T x = T(0), T z = T(0)) : x(x), z(z) {}
 };
 
+using Point2D = BasicPoint2D<float>;
+using Point2DD = BasicPoint2D<double>;
+
 /**
  * @brief 2D多边形类型定义
  */
-using Polygon2D = std::vector<Point2D>;
+template <typename T>
+using BasicPolygon2D = std::vector<BasicPoint2D<T>>;
+
+using Polygon2D = BasicPolygon2D<float>;
+using Polygon2DD = BasicPolygon2D<double>;
+
+/**
+ * @brief 固定容量、存放在栈上的2D多边形，用于无堆分配的裁剪路径
+ * @tparam N 最大顶点数
+ */
+template <size_t N>
+struct StaticPolygon {
+    Point2D points[N];
+    size_t count;
+
+    StaticPolygon() : count(0) {}
+
+    static size_t capacity() { return N; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    void clear() { count = 0; }
+
+    // 超出容量的顶点被丢弃；凸四边形之间的裁剪不会出现这种情况
+    void push_back(const Point2D& point) {
+        if (count < N) {
+            points[count++] = point;
+        }
+    }
+
+    Point2D& operator[](size_t i) { return points[i]; }
+    const Point2D& operator[](size_t i) const { return points[i]; }
+};
+
+/**
+ * @brief 两个凸四边形的交集最多有8个顶点
+ */
+using IntersectionPolygon = StaticPolygon<8>;
+
+/**
+ * @brief 预先计算的包围盒几何信息
+ * 跟踪等场景中同一个框会与大量框比较，预先计算后每对只需计算交集本身。
+ */
+struct PreparedBox {
+    // BEV顶点，顺序与boxToBEVCorners一致（逆时针）
+    Point2D corners[4];
+    // 第k条边（corners[k] -> corners[k+1]）指向矩形内部的单位法向量
+    Point2D edge_normals[4];
+    // BEV平面的轴对齐包围矩形
+    float min_x;
+    float min_z;
+    float max_x;
+    float max_z;
+    // BEV中心与外接圆半径
+    float center_x;
+    float center_z;
+    float radius;
+    // 半长（局部x方向）与半宽（局部z方向），用于朝向对齐时的快速路径
+    float half_length;
+    float half_width;
+    // BEV面积（length × width）与体积
+    float area;
+    float volume;
+    // y方向范围
+    float y_min;
+    float y_max;
+};
 
 /**
  * @brief 将3D包围盒投影到BEV平面（xoz）得到2D矩形顶点
@@ -68,6 +225,45 @@ using Polygon2D = std::vector<Point2D>;
  */
 Polygon2D boxToBEVPolygon(const Box& box);
 
+/**
+ * @brief 将3D包围盒投影到BEV平面，顶点写入调用方提供的数组（不分配内存）
+ * @param box 3D包围盒
+ * @param corners 输出的4个顶点，顺序与boxToBEVPolygon一致
+ */
+void boxToBEVCorners(const Box& box, Point2D corners[4]);
+
+/**
+ * @brief 在指定精度下计算BEV顶点，结果相对于(origin_x, origin_z)
+ * 中心坐标先转换为T再减去原点，远离原点的场景可借此避免float精度损失
+ * @param box 3D包围盒
+ * @param corners 输出的4个顶点
+ * @param origin_x, origin_z 局部坐标系原点
+ */
+template <typename T>
+void boxToBEVCorners(const Box& box, BasicPoint2D<T> corners[4], T origin_x, T origin_z);
+
+/**
+ * @brief 预先计算包围盒的顶点、边法向量、包围矩形、面积、体积和y范围
+ */
+void prepareBox(const Box& box, PreparedBox& prepared);
+
+/**
+ * @brief 预先计算包围盒几何信息（返回值版本）
+ */
+PreparedBox prepareBox(const Box& box);
+
+/**
+ * @brief 由原始参数预先计算几何信息，不需要构造Box
+ * @param params 依次为center_x, center_y, center_z, length, width, height, yaw
+ */
+void prepareBox(const float params[7], PreparedBox& prepared);
+
+/**
+ * @brief 预先计算BoxPOD的几何信息，结果与对应Box的prepareBox完全一致
+ */
+void prepareBox(const BoxPOD& box, PreparedBox& prepared);
+PreparedBox prepareBox(const BoxPOD& box);
+
 /**
  * @brief 计算两条直线的交点x坐标
  */
@@ -80,6 +276,18 @@ float getLineIntersectionX(float x1, float z1, float x2, float z2,
 float getLineIntersectionZ(float x1, float z1, float x2, float z2,
                           float x3, float z3, float x4, float z4);
 
+/**
+ * @brief 计算两条直线的交点x坐标（指定精度）
+ */
+template <typename T>
+T getLineIntersectionX(T x1, T z1, T x2, T z2, T x3, T z3, T x4, T z4);
+
+/**
+ * @brief 计算两条直线的交点z坐标（指定精度）
+ */
+template <typename T>
+T getLineIntersectionZ(T x1, T z1, T x2, T z2, T x3, T z3, T x4, T z4);
+
 /**
  * @brief 使用鞋带公式计算多边形面积
  * @param polygon 多边形顶点
@@ -87,6 +295,32 @@ float getLineIntersectionZ(float x1, float z1, float x2, float z2,
  */
 float calculatePolygonArea(const Polygon2D& polygon);
 
+/**
+ * @brief 使用鞋带公式计算多边形面积（指针版本）
+ * @param points 多边形顶点数组
+ * @param count 顶点数
+ * @return 多边形面积
+ */
+float calculatePolygonArea(const Point2D* points, size_t count);
+
+/**
+ * @brief 使用鞋带公式计算多边形面积（指定精度）
+ * 以第一个顶点为参考点累加，坐标很大时也不会因大数相减损失精度
+ */
+template <typename T>
+T calculatePolygonArea(const BasicPoint2D<T>* points, size_t count);
+
+template <typename T>
+T calculatePolygonArea(const BasicPolygon2D<T>& polygon);
+
+/**
+ * @brief 计算固定容量多边形的面积
+ */
+template <size_t N>
+inline float calculatePolygonArea(const StaticPolygon<N>& polygon) {
+    return calculatePolygonArea(polygon.points, polygon.size());
+}
+
 /**
  * @brief 对多边形执行单边裁剪
  * @param polygon 待裁剪的多边形
@@ -104,6 +338,55 @@ Polygon2D clipPolygonByLine(const Polygon2D& polygon,
  */
 Polygon2D sutherlandHodgmanClip(const Polygon2D& subject, const Polygon2D& clipper);
 
+/**
+ * @brief 对多边形执行单边裁剪（指定精度）
+ */
+template <typename T>
+BasicPolygon2D<T> clipPolygonByLine(const BasicPolygon2D<T>& polygon,
+                                    T x1, T z1, T x2, T z2);
+
+/**
+ * @brief Sutherland-Hodgman多边形裁剪算法（指定精度）
+ */
+template <typename T>
+BasicPolygon2D<T> sutherlandHodgmanClip(const BasicPolygon2D<T>& subject, const BasicPolygon2D<T>& clipper);
+
+/**
+ * @brief 对固定容量多边形执行单边裁剪（不分配内存）
+ * @param polygon 待裁剪的多边形
+ * @param x1, z1, x2, z2 裁剪线的两个端点
+ * @param clipped 裁剪结果，不能与polygon是同一对象
+ */
+void clipPolygonByLine(const IntersectionPolygon& polygon,
+                       float x1, float z1, float x2, float z2,
+                       IntersectionPolygon& clipped);
+
+/**
+ * @brief 无堆分配的Sutherland-Hodgman裁剪
+ * 要求两个多边形均为凸多边形且顶点数之和不超过8（例如两个BEV矩形）
+ * @param subject, subject_size 被裁剪多边形
+ * @param clipper, clipper_size 裁剪多边形
+ * @param result 交集多边形
+ */
+void sutherlandHodgmanClip(const Point2D* subject, size_t subject_size,
+                           const Point2D* clipper, size_t clipper_size,
+                           IntersectionPolygon& result);
+
+/**
+ * @brief 计算两个凸四边形的交集面积（BEV矩形专用内核）
+ * 收集落在对方内部的顶点以及4×4条边的交点，按极角排序后用鞋带公式求面积。
+ * 每对边的交点只计算一次公共分母，循环次数固定，便于编译器展开。
+ * @param quad1, quad2 逆时针排列的4个顶点（例如boxToBEVCorners的输出）
+ * @return 交集面积
+ */
+float calculateQuadIntersectionArea(const Point2D quad1[4], const Point2D quad2[4]);
+
+/**
+ * @brief 计算两个凸四边形的交集面积（指定精度）
+ */
+template <typename T>
+T calculateQuadIntersectionArea(const BasicPoint2D<T> quad1[4], const BasicPoint2D<T> quad2[4]);
+
 /**
  * @brief 计算两个3D包围盒的IoU
  * @param box1 第一个包围盒
@@ -120,4 +403,97 @@ float calculateIoU3D(const Box& box1, const Box& box2);
  */
 float calculateBEVIoU(const Box& box1, const Box& box2);
 
+/**
+ * @brief 在指定精度下计算两个3D包围盒的IoU
+ * 用法：calculateIoU3D<double>(box1, box2)。坐标很大（如全局地图坐标）时，
+ * float版本的顶点只剩厘米级有效位，此版本可避免IoU失真。
+ * @param recenter 为true时先平移到两个中心的中点再计算交集
+ */
+template <typename T>
+T calculateIoU3D(const Box& box1, const Box& box2, bool recenter = true);
+
+/**
+ * @brief 在指定精度下计算两个3D包围盒的BEV IoU
+ * @param recenter 为true时先平移到两个中心的中点再计算交集
+ */
+template <typename T>
+T calculateBEVIoU(const Box& box1, const Box& box2, bool recenter = true);
+
+/**
+ * @brief BoxPOD版本的IoU，结果与对应Box的版本完全一致
+ */
+float calculateIoU3D(const BoxPOD& box1, const BoxPOD& box2);
+float calculateBEVIoU(const BoxPOD& box1, const BoxPOD& box2);
+
+template <typename T>
+T calculateIoU3D(const BoxPOD& box1, const BoxPOD& box2, bool recenter = true);
+
+template <typename T>
+T calculateBEVIoU(const BoxPOD& box1, const BoxPOD& box2, bool recenter = true);
+
+/**
+ * @brief 计算两个预处理包围盒的3D IoU
+ * 依次进行y区间、外接圆和轴对齐包围矩形的廉价排除；
+ * 两框yaw相差π/2的整数倍时在box1的局部坐标系中按轴对齐矩形求交，否则执行完整的四边形求交
+ */
+float calculateIoU3D(const PreparedBox& box1, const PreparedBox& box2);
+
+/**
+ * @brief 计算两个预处理包围盒的BEV IoU（排除与快速路径同3D版本，不含y区间测试）
+ */
+float calculateBEVIoU(const PreparedBox& box1, const PreparedBox& box2);
+
+/**
+ * @brief 批量计算两组包围盒之间的3D IoU矩阵
+ * 每个包围盒的BEV顶点、面积和y范围只计算一次，然后逐对计算交集
+ * @param boxes1 第一组包围盒（N个，对应矩阵的行）
+ * @param boxes2 第二组包围盒（M个，对应矩阵的列）
+ * @param out 输出缓冲区，至少N*M个元素，按行优先存储：out[i*M + j] = IoU(boxes1[i], boxes2[j])
+ */
+void calculateIoU3DMatrix(const std::vector<Box>& boxes1, const std::vector<Box>& boxes2, float* out);
+
+/**
+ * @brief 批量计算两组包围盒之间的BEV IoU矩阵
+ * @param boxes1 第一组包围盒（N个，对应矩阵的行）
+ * @param boxes2 第二组包围盒（M个，对应矩阵的列）
+ * @param out 输出缓冲区，至少N*M个元素，按行优先存储：out[i*M + j] = BEV IoU(boxes1[i], boxes2[j])
+ */
+void calculateBEVIoUMatrix(const std::vector<Box>& boxes1, const std::vector<Box>& boxes2, float* out);
+
+/**
+ * @brief 并行计算3D IoU矩阵，按行块分配给执行器，结果与串行版本完全一致
+ * @param executor 并行执行器（见executor.h）
+ */
+void calculateIoU3DMatrix(const std::vector<Box>& boxes1, const std::vector<Box>& boxes2, float* out,
+                          Executor& executor);
+
+/**
+ * @brief 并行计算BEV IoU矩阵，按行块分配给执行器，结果与串行版本完全一致
+ * @param executor 并行执行器（见executor.h）
+ */
+void calculateBEVIoUMatrix(const std::vector<Box>& boxes1, const std::vector<Box>& boxes2, float* out,
+                           Executor& executor);
+
+/**
+ * @brief BoxPOD版本的IoU矩阵，结果与对应Box的版本完全一致
+ */
+void calculateIoU3DMatrix(const std::vector<BoxPOD>& boxes1, const std::vector<BoxPOD>& boxes2, float* out);
+void calculateBEVIoUMatrix(const std::vector<BoxPOD>& boxes1, const std::vector<BoxPOD>& boxes2, float* out);
+void calculateIoU3DMatrix(const std::vector<BoxPOD>& boxes1, const std::vector<BoxPOD>& boxes2, float* out,
+                          Executor& executor);
+void calculateBEVIoUMatrix(const std::vector<BoxPOD>& boxes1, const std::vector<BoxPOD>& boxes2, float* out,
+                           Executor& executor);
+
+/**
+ * @brief 由已预处理的包围盒并行计算3D IoU矩阵，适用于包围盒不以Box形式存放的场景
+ */
+void calculateIoU3DMatrix(const std::vector<PreparedBox>& boxes1, const std::vector<PreparedBox>& boxes2,
+                          float* out, Executor& executor);
+
+/**
+ * @brief 由已预处理的包围盒并行计算BEV IoU矩阵
+ */
+void calculateBEVIoUMatrix(const std::vector<PreparedBox>& boxes1, const std::vector<PreparedBox>& boxes2,
+                           float* out, Executor& executor);
+
 } // namespace nms
@@ -0,0 +1,199 @@
+#include "iou3d_c.h"
+#include "iou3d.h"
+#include "nms.h"
+#include "executor.h"
+#include <new>
+#include <vector>
+#include <algorithm>
+
+struct iou3d_context {
+    explicit iou3d_context(size_t num_threads) : pool(num_threads) {}
+
+    nms::ThreadPool pool;
+    nms::NmsWorkspace nms;
+    std::vector<nms::PreparedBox> prepared1;
+    std::vector<nms::PreparedBox> prepared2;
+};
+
+namespace {
+
+struct StridedBoxes {
+    const float* boxes;
+    size_t stride;
+    nms::PreparedBox* prepared;
+};
+
+int checkBoxes(const float* boxes, size_t n, size_t stride) {
+    if (n > 0 && !boxes) {
+        return IOU3D_ERROR_NULL_POINTER;
+    }
+    if (stride < IOU3D_BOX_PARAMS) {
+        return IOU3D_ERROR_INVALID_STRIDE;
+    }
+    return IOU3D_OK;
+}
+
+void prepareStrided(const float* boxes, size_t n, size_t stride, std::vector<nms::PreparedBox>& prepared,
+                    nms::Executor& executor) {
+    prepared.resize(n);
+    // 闭包只捕获一个引用，std::function不会为其分配内存
+    StridedBoxes input = {boxes, stride, prepared.data()};
+    executor.parallelFor(n, 256, [&input](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            nms::prepareBox(input.boxes + i * input.stride, input.prepared[i]);
+        }
+    });
+}
+
+int computeMatrix(const float* boxes1, size_t n, size_t stride1, const float* boxes2, size_t m, size_t stride2,
+                  float* out, iou3d_context* ctx, bool use_3d) {
+    int status = checkBoxes(boxes1, n, stride1);
+    if (status == IOU3D_OK) {
+        status = checkBoxes(boxes2, m, stride2);
+    }
+    if (status != IOU3D_OK) {
+        return status;
+    }
+    if (n == 0 || m == 0) {
+        return IOU3D_OK;
+    }
+    if (!out) {
+        return IOU3D_ERROR_NULL_POINTER;
+    }
+
+    try {
+        nms::SerialExecutor serial;
+        std::vector<nms::PreparedBox> local1, local2;
+        nms::Executor& executor = ctx ? static_cast<nms::Executor&>(ctx->pool) : serial;
+        std::vector<nms::PreparedBox>& prepared1 = ctx ? ctx->prepared1 : local1;
+        std::vector<nms::PreparedBox>& prepared2 = ctx ? ctx->prepared2 : local2;
+        prepareStrided(boxes1, n, stride1, prepared1, executor);
+        prepareStrided(boxes2, m, stride2, prepared2, executor);
+
+        if (use_3d) {
+            nms::calculateIoU3DMatrix(prepared1, prepared2, out, executor);
+        } else {
+            nms::calculateBEVIoUMatrix(prepared1, prepared2, out, executor);
+        }
+    } catch (const std::bad_alloc&) {
+        return IOU3D_ERROR_OUT_OF_MEMORY;
+    } catch (...) {
+        return IOU3D_ERROR_INTERNAL;
+    }
+    return IOU3D_OK;
+}
+
+} // namespace
+
+extern "C" {
+
+int iou3d_context_create(size_t num_threads, iou3d_context** ctx) {
+    if (!ctx) {
+        return IOU3D_ERROR_NULL_POINTER;
+    }
+    *ctx = nullptr;
+    try {
+        *ctx = new iou3d_context(num_threads);
+    } catch (const std::bad_alloc&) {
+        return IOU3D_ERROR_OUT_OF_MEMORY;
+    } catch (...) {
+        return IOU3D_ERROR_INTERNAL;
+    }
+    return IOU3D_OK;
+}
+
+void iou3d_context_destroy(iou3d_context* ctx) {
+    delete ctx;
+}
+
+void iou3d_nms_params_init(iou3d_nms_params* params) {
+    if (!params) {
+        return;
+    }
+    nms::NMSConfig config;
+    params->iou_threshold = config.iou_threshold;
+    params->score_threshold = config.score_threshold;
+    params->use_3d = config.iou_type == nms::IoUType::IOU_3D;
+    params->class_aware = config.class_aware;
+    params->pre_max_size = config.pre_max_size;
+    params->post_max_size = config.post_max_size;
+    params->use_distance_iou = config.use_distance_iou;
+}
+
+int iou3d_bev_iou_matrix(const float* boxes1, size_t n, size_t stride1,
+                         const float* boxes2, size_t m, size_t stride2,
+                         float* out, iou3d_context* ctx) {
+    return computeMatrix(boxes1, n, stride1, boxes2, m, stride2, out, ctx, false);
+}
+
+int iou3d_iou3d_matrix(const float* boxes1, size_t n, size_t stride1,
+                       const float* boxes2, size_t m, size_t stride2,
+                       float* out, iou3d_context* ctx) {
+    return computeMatrix(boxes1, n, stride1, boxes2, m, stride2, out, ctx, true);
+}
+
+int iou3d_nms(const float* boxes, size_t n, size_t stride, const float* scores, const int* class_ids,
+              const iou3d_nms_params* params, int* keep, size_t* num_keep, iou3d_context* ctx) {
+    int status = checkBoxes(boxes, n, stride);
+    if (status != IOU3D_OK) {
+        return status;
+    }
+    if (!num_keep || (n > 0 && (!scores || !keep))) {
+        return IOU3D_ERROR_NULL_POINTER;
+    }
+    *num_keep = 0;
+
+    iou3d_nms_params defaults;
+    iou3d_nms_params_init(&defaults);
+    const iou3d_nms_params& p = params ? *params : defaults;
+    if (!(p.iou_threshold >= 0.0f)) {
+        return IOU3D_ERROR_INVALID_ARGUMENT;
+    }
+
+    nms::NMSConfig config;
+    config.iou_threshold = p.iou_threshold;
+    config.score_threshold = p.score_threshold;
+    config.iou_type = p.use_3d ? nms::IoUType::IOU_3D : nms::IoUType::BEV;
+    config.class_aware = p.class_aware != 0 && class_ids != nullptr;
+    config.pre_max_size = p.pre_max_size;
+    config.post_max_size = p.post_max_size;
+    config.use_distance_iou = p.use_distance_iou != 0;
+
+    try {
+        nms::SerialExecutor serial;
+        nms::NmsWorkspace local;
+        nms::Executor& executor = ctx ? static_cast<nms::Executor&>(ctx->pool) : serial;
+        nms::NmsWorkspace& workspace = ctx ? ctx->nms : local;
+        workspace.setConfig(config);
+
+        const std::vector<int>& result = workspace.process(boxes, n, stride, scores, class_ids, executor);
+        std::copy(result.begin(), result.end(), keep);
+        *num_keep = result.size();
+    } catch (const std::bad_alloc&) {
+        return IOU3D_ERROR_OUT_OF_MEMORY;
+    } catch (...) {
+        return IOU3D_ERROR_INTERNAL;
+    }
+    return IOU3D_OK;
+}
+
+const char* iou3d_status_string(int status) {
+    switch (status) {
+        case IOU3D_OK:
+            return "ok";
+        case IOU3D_ERROR_NULL_POINTER:
+            return "null pointer";
+        case IOU3D_ERROR_INVALID_STRIDE:
+            return "stride is smaller than the number of box parameters";
+        case IOU3D_ERROR_INVALID_ARGUMENT:
+            return "invalid argument";
+        case IOU3D_ERROR_OUT_OF_MEMORY:
+            return "out of memory";
+        case IOU3D_ERROR_INTERNAL:
+            return "internal error";
+        default:
+            return "unknown status";
+    }
+}
+
+} // extern "C"
@@ -0,0 +1,94 @@
+#pragma once
+
+/*
+ * C语言接口
+ * 包围盒以调用方持有的float数组按行传入，不做任何拷贝：第i个框的参数为
+ * boxes[i*stride + 0 .. 6] = center_x, center_y, center_z, length, width, height, yaw，
+ * 坐标系与C++接口的Box相同。stride为相邻两个框之间的float个数（不小于7），
+ * 因此可以直接传入带有额外列（如置信度、类别）的数组。
+ * 所有函数返回状态码，不会抛出异常。
+ */
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 状态码 */
+#define IOU3D_OK 0
+#define IOU3D_ERROR_NULL_POINTER (-1)
+#define IOU3D_ERROR_INVALID_STRIDE (-2)
+#define IOU3D_ERROR_INVALID_ARGUMENT (-3)
+#define IOU3D_ERROR_OUT_OF_MEMORY (-4)
+#define IOU3D_ERROR_INTERNAL (-5)
+
+/* 每个框的参数个数 */
+#define IOU3D_BOX_PARAMS 7
+
+/*
+ * 执行上下文：持有线程池和可复用的缓冲区，逐帧复用时不再分配内存。
+ * 一个上下文不能被多个线程同时使用；各函数的ctx参数为NULL时在调用线程上串行计算，可以并发调用。
+ */
+typedef struct iou3d_context iou3d_context;
+
+/*
+ * 非极大值抑制参数，iou3d_nms_params_init填入与C++ NMSConfig相同的默认值
+ */
+typedef struct iou3d_nms_params {
+    float iou_threshold;
+    float score_threshold;
+    /* 非0时使用3D IoU，否则使用BEV IoU */
+    int use_3d;
+    /* 非0且提供了class_ids时只在相同类别之间抑制 */
+    int class_aware;
+    /* NMS之前/之后保留的最大框数，<=0表示不限制 */
+    int pre_max_size;
+    int post_max_size;
+    /* 非0时使用DIoU判断是否抑制 */
+    int use_distance_iou;
+} iou3d_nms_params;
+
+/*
+ * 创建上下文
+ * num_threads: 总线程数（包括调用线程），0表示使用硬件并发数
+ */
+int iou3d_context_create(size_t num_threads, iou3d_context** ctx);
+
+void iou3d_context_destroy(iou3d_context* ctx);
+
+void iou3d_nms_params_init(iou3d_nms_params* params);
+
+/*
+ * 计算n×m的BEV IoU矩阵，行优先写入out（至少n*m个元素）
+ */
+int iou3d_bev_iou_matrix(const float* boxes1, size_t n, size_t stride1,
+                         const float* boxes2, size_t m, size_t stride2,
+                         float* out, iou3d_context* ctx);
+
+/*
+ * 计算n×m的3D IoU矩阵，行优先写入out（至少n*m个元素）
+ */
+int iou3d_iou3d_matrix(const float* boxes1, size_t n, size_t stride1,
+                       const float* boxes2, size_t m, size_t stride2,
+                       float* out, iou3d_context* ctx);
+
+/*
+ * 非极大值抑制
+ * scores: 长度为n的置信度
+ * class_ids: 长度为n的类别，可以为NULL（视为同一类别）
+ * params: 为NULL时使用默认参数
+ * keep: 至少n个元素，写入保留框的索引（按置信度降序）
+ * num_keep: 写入保留框的个数
+ */
+int iou3d_nms(const float* boxes, size_t n, size_t stride, const float* scores, const int* class_ids,
+              const iou3d_nms_params* params, int* keep, size_t* num_keep, iou3d_context* ctx);
+
+/*
+ * 状态码的说明文字
+ */
+const char* iou3d_status_string(int status);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,516 @@
+#include "iou_loss.h"
+#include "executor.h"
+#include "quad_kernel.h"
+#include <cmath>
+#include <algorithm>
+#include <cassert>
+
+namespace nms {
+
+namespace {
+
+// 预测框参数在梯度数组中的下标
+enum Param { CX = 0, CY, CZ, LENGTH, WIDTH, HEIGHT, YAW, PARAM_COUNT };
+
+const double kPi = 3.14159265358979323846;
+
+// 与boxToBEVCorners一致的角点符号：(±length/2, ±width/2)
+const double kCornerSignX[4] = {1.0, -1.0, -1.0, 1.0};
+const double kCornerSignZ[4] = {1.0, 1.0, -1.0, -1.0};
+
+/**
+ * @brief 一个量及其对预测框7个参数的偏导
+ */
+struct Dual {
+    double value;
+    double d[PARAM_COUNT];
+
+    explicit Dual(double v = 0.0) : value(v) {
+        std::fill(d, d + PARAM_COUNT, 0.0);
+    }
+};
+
+/**
+ * @brief 带梯度的计算上下文：预测框角点的雅可比矩阵和对角点坐标的梯度累加
+ */
+struct CornerJacobian {
+    // dx[k][p]、dz[k][p]：第k个角点坐标对参数p的偏导
+    double dx[4][PARAM_COUNT];
+    double dz[4][PARAM_COUNT];
+};
+
+void computeCornerJacobian(const Box& box, CornerJacobian& jacobian) {
+    double yaw = box.yaw;
+    double c = std::cos(yaw);
+    double s = std::sin(yaw);
+    for (int k = 0; k < 4; ++k) {
+        double local_x = kCornerSignX[k] * 0.5 * box.length;
+        double local_z = kCornerSignZ[k] * 0.5 * box.width;
+        std::fill(jacobian.dx[k], jacobian.dx[k] + PARAM_COUNT, 0.0);
+        std::fill(jacobian.dz[k], jacobian.dz[k] + PARAM_COUNT, 0.0);
+        // x = cx + local_x*cos + local_z*sin, z = cz - local_x*sin + local_z*cos
+        jacobian.dx[k][CX] = 1.0;
+        jacobian.dx[k][LENGTH] = 0.5 * kCornerSignX[k] * c;
+        jacobian.dx[k][WIDTH] = 0.5 * kCornerSignZ[k] * s;
+        jacobian.dx[k][YAW] = -local_x * s + local_z * c;
+        jacobian.dz[k][CZ] = 1.0;
+        jacobian.dz[k][LENGTH] = -0.5 * kCornerSignX[k] * s;
+        jacobian.dz[k][WIDTH] = 0.5 * kCornerSignZ[k] * c;
+        jacobian.dz[k][YAW] = -local_x * c - local_z * s;
+    }
+}
+
+/**
+ * @brief 将对预测框角点坐标的梯度链式传递到参数
+ */
+void chainCorners(const CornerJacobian& jacobian, const double grad_x[4], const double grad_z[4], Dual& out) {
+    for (int k = 0; k < 4; ++k) {
+        for (int p = 0; p < PARAM_COUNT; ++p) {
+            out.d[p] += grad_x[k] * jacobian.dx[k][p] + grad_z[k] * jacobian.dz[k][p];
+        }
+    }
+}
+
+/**
+ * @brief 逆时针多边形面积对第i个顶点的偏导
+ */
+inline void shoelaceGradient(const Point2DD* points, int count, int i, double& gx, double& gz) {
+    const Point2DD& prev = points[(i + count - 1) % count];
+    const Point2DD& next = points[(i + 1) % count];
+    gx = 0.5 * (next.z - prev.z);
+    gz = 0.5 * (prev.x - next.x);
+}
+
+double shoelaceArea(const Point2DD* points, int count) {
+    double area = 0.0;
+    for (int i = 0; i < count; ++i) {
+        const Point2DD& a = points[i];
+        const Point2DD& b = points[(i + 1) % count];
+        area += a.x * b.z - b.x * a.z;
+    }
+    return 0.5 * area;
+}
+
+/**
+ * @brief BEV交集面积及梯度
+ */
+Dual intersectionArea(const Point2DD pred[4], const Point2DD target[4],
+                      const CornerJacobian* jacobian) {
+    Point2DD points[24];
+    detail::VertexSource sources[24];
+    int count = detail::quadIntersectionPolygon<double>(pred, target, points, sources);
+    if (count < 3) {
+        return Dual(0.0);
+    }
+
+    Dual area(std::abs(shoelaceArea(points, count)));
+    if (jacobian == nullptr) {
+        return area;
+    }
+
+    double grad_x[4] = {0.0, 0.0, 0.0, 0.0};
+    double grad_z[4] = {0.0, 0.0, 0.0, 0.0};
+    for (int i = 0; i < count; ++i) {
+        double gx;
+        double gz;
+        shoelaceGradient(points, count, i, gx, gz);
+        const detail::VertexSource& source = sources[i];
+        if (source.kind == detail::VertexSource::CORNER1) {
+            grad_x[source.index1] += gx;
+            grad_z[source.index1] += gz;
+        } else if (source.kind == detail::VertexSource::EDGE_CROSSING) {
+            // 交点P在预测框边ab与目标框边所在直线上：
+            // 设n为目标边法向量，fa = n·(a-q)，fb = n·(b-q)，则P = (fa*b - fb*a) / (fa - fb)
+            int ia = source.index1;
+            int ib = (ia + 1) & 3;
+            const Point2DD& a = pred[ia];
+            const Point2DD& b = pred[ib];
+            const Point2DD& q = target[source.index2];
+            const Point2DD& q2 = target[(source.index2 + 1) & 3];
+            double nx = -(q2.z - q.z);
+            double nz = q2.x - q.x;
+            double fa = nx * (a.x - q.x) + nz * (a.z - q.z);
+            double fb = nx * (b.x - q.x) + nz * (b.z - q.z);
+            double denominator = fa - fb;
+            if (std::abs(denominator) < 1e-12) {
+                continue;
+            }
+            const Point2DD& p = points[i];
+            // dP/da = ((b-P)n^T - fb*I) / D，dP/db = (fa*I + (P-a)n^T) / D
+            double dot_b = (b.x - p.x) * gx + (b.z - p.z) * gz;
+            double dot_a = (p.x - a.x) * gx + (p.z - a.z) * gz;
+            grad_x[ia] += (nx * dot_b - fb * gx) / denominator;
+            grad_z[ia] += (nz * dot_b - fb * gz) / denominator;
+            grad_x[ib] += (fa * gx + nx * dot_a) / denominator;
+            grad_z[ib] += (fa * gz + nz * dot_a) / denominator;
+        }
+    }
+    chainCorners(*jacobian, grad_x, grad_z, area);
+    return area;
+}
+
+double cross(const Point2DD& o, const Point2DD& a, const Point2DD& b) {
+    return (a.x - o.x) * (b.z - o.z) - (a.z - o.z) * (b.x - o.x);
+}
+
+/**
+ * @brief 两个矩形8个角点的凸包面积及梯度（Andrew单调链）
+ */
+Dual hullArea(const Point2DD pred[4], const Point2DD target[4], const CornerJacobian* jacobian) {
+    Point2DD all[8];
+    int order[8];
+    for (int k = 0; k < 4; ++k) {
+        all[k] = pred[k];
+        all[k + 4] = target[k];
+    }
+    for (int k = 0; k < 8; ++k) {
+        order[k] = k;
+    }
+    std::sort(order, order + 8, [&all](int a, int b) {
+        return all[a].x < all[b].x || (all[a].x == all[b].x && all[a].z < all[b].z);
+    });
+
+    int hull[16];
+    int size = 0;
+    for (int k = 0; k < 8; ++k) {
+        while (size >= 2 && cross(all[hull[size - 2]], all[hull[size - 1]], all[order[k]]) <= 0.0) {
+            --size;
+        }
+        hull[size++] = order[k];
+    }
+    for (int k = 6, lower = size + 1; k >= 0; --k) {
+        while (size >= lower && cross(all[hull[size - 2]], all[hull[size - 1]], all[order[k]]) <= 0.0) {
+            --size;
+        }
+        hull[size++] = order[k];
+    }
+    --size; // 最后一个点与起点重复
+
+    Point2DD points[16];
+    for (int k = 0; k < size; ++k) {
+        points[k] = all[hull[k]];
+    }
+    Dual area(shoelaceArea(points, size));
+    if (jacobian == nullptr || size < 3) {
+        return area;
+    }
+
+    double grad_x[4] = {0.0, 0.0, 0.0, 0.0};
+    double grad_z[4] = {0.0, 0.0, 0.0, 0.0};
+    for (int k = 0; k < size; ++k) {
+        if (hull[k] >= 4) {
+            continue;
+        }
+        double gx;
+        double gz;
+        shoelaceGradient(points, size, k, gx, gz);
+        grad_x[hull[k]] += gx;
+        grad_z[hull[k]] += gz;
+    }
+    chainCorners(*jacobian, grad_x, grad_z, area);
+    return area;
+}
+
+/**
+ * @brief 包含两框所有角点的轴对齐矩形在一个坐标轴上的跨度及梯度
+ * @param use_x true为x轴，false为z轴
+ */
+Dual cornerExtent(const Point2DD pred[4], const Point2DD target[4], bool use_x,
+                  const CornerJacobian* jacobian) {
+    int min_index = 0;
+    int max_index = 0;
+    double min_value = use_x ? pred[0].x : pred[0].z;
+    double max_value = min_value;
+    for (int k = 1; k < 8; ++k) {
+        const Point2DD& point = k < 4 ? pred[k] : target[k - 4];
+        double value = use_x ? point.x : point.z;
+        if (value < min_value) {
+            min_value = value;
+            min_index = k;
+        }
+        if (value > max_value) {
+            max_value = value;
+            max_index = k;
+        }
+    }
+
+    Dual extent(max_value - min_value);
+    if (jacobian != nullptr) {
+        for (int p = 0; p < PARAM_COUNT; ++p) {
+            if (max_index < 4) {
+                extent.d[p] += use_x ? jacobian->dx[max_index][p] : jacobian->dz[max_index][p];
+            }
+            if (min_index < 4) {
+                extent.d[p] -= use_x ? jacobian->dx[min_index][p] : jacobian->dz[min_index][p];
+            }
+        }
+    }
+    return extent;
+}
+
+/**
+ * @brief 一个区间端点：value及其对cy、height的偏导
+ */
+struct Bound {
+    double value;
+    double d_center;
+    double d_height;
+};
+
+/**
+ * @brief 全部指标及所选损失的梯度
+ */
+struct PairResult {
+    IoUMetrics metrics;
+    double d_loss[PARAM_COUNT];
+};
+
+void evaluatePair(const Box& pred, const Box& target, IoUType iou_type, IoULossType loss_type,
+                  bool with_gradient, PairResult& result) {
+    std::fill(result.d_loss, result.d_loss + PARAM_COUNT, 0.0);
+    result.metrics.iou = 0.0f;
+    result.metrics.giou = 0.0f;
+    result.metrics.diou = 0.0f;
+    result.metrics.ciou = 0.0f;
+
+    const bool is_3d = iou_type == IoUType::IOU_3D;
+
+    // 以目标框中心为原点，与calculateIoU3D<double>使用同一顶点计算
+    const double origin_x = target.center_x;
+    const double origin_z = target.center_z;
+    Point2DD pred_corners[4];
+    Point2DD target_corners[4];
+    boxToBEVCorners<double>(pred, pred_corners, origin_x, origin_z);
+    boxToBEVCorners<double>(target, target_corners, origin_x, origin_z);
+
+    CornerJacobian jacobian;
+    const CornerJacobian* jacobian_ptr = nullptr;
+    if (with_gradient) {
+        computeCornerJacobian(pred, jacobian);
+        jacobian_ptr = &jacobian;
+    }
+
+    // 交集：BEV面积乘以y方向重叠长度
+    Dual intersection = intersectionArea(pred_corners, target_corners, jacobian_ptr);
+    Dual pred_size(static_cast<double>(pred.length) * pred.width);
+    pred_size.d[LENGTH] = pred.width;
+    pred_size.d[WIDTH] = pred.length;
+    double target_size = static_cast<double>(target.length) * target.width;
+
+    Bound pred_top = {pred.center_y + 0.5 * pred.height, 1.0, 0.5};
+    Bound pred_bottom = {pred.center_y - 0.5 * pred.height, 1.0, -0.5};
+    double target_top = target.center_y + 0.5 * target.height;
+    double target_bottom = target.center_y - 0.5 * target.height;
+
+    Dual enclose_height(1.0);
+    if (is_3d) {
+        // y方向重叠长度
+        Dual overlap(std::min(pred_top.value, target_top) - std::max(pred_bottom.value, target_bottom));
+        if (pred_top.value <= target_top) {
+            overlap.d[CY] += pred_top.d_center;
+            overlap.d[HEIGHT] += pred_top.d_height;
+        }
+        if (pred_bottom.value >= target_bottom) {
+            overlap.d[CY] -= pred_bottom.d_center;
+            overlap.d[HEIGHT] -= pred_bottom.d_height;
+        }
+        if (overlap.value <= 0.0) {
+            intersection = Dual(0.0);
+        } else {
+            for (int p = 0; p < PARAM_COUNT; ++p) {
+                intersection.d[p] = intersection.d[p] * overlap.value + intersection.value * overlap.d[p];
+            }
+            intersection.value *= overlap.value;
+        }
+
+        double pred_height = pred.height;
+        for (int p = 0; p < PARAM_COUNT; ++p) {
+            pred_size.d[p] *= pred_height;
+        }
+        pred_size.d[HEIGHT] = pred_size.value;
+        pred_size.value *= pred_height;
+        target_size *= target.height;
+
+        // 联合高度范围
+        enclose_height = Dual(std::max(pred_top.value, target_top) - std::min(pred_bottom.value, target_bottom));
+        if (pred_top.value >= target_top) {
+            enclose_height.d[CY] += pred_top.d_center;
+            enclose_height.d[HEIGHT] += pred_top.d_height;
+        }
+        if (pred_bottom.value <= target_bottom) {
+            enclose_height.d[CY] -= pred_bottom.d_center;
+            enclose_height.d[HEIGHT] -= pred_bottom.d_height;
+        }
+    }
+
+    double union_value = pred_size.value + target_size - intersection.value;
+    if (union_value < 1e-10) {
+        return;
+    }
+
+    // IoU = I / U，U = V1 + V2 - I
+    double iou = intersection.value / union_value;
+    double d_iou[PARAM_COUNT];
+    double d_union[PARAM_COUNT];
+    for (int p = 0; p < PARAM_COUNT; ++p) {
+        d_union[p] = pred_size.d[p] - intersection.d[p];
+        d_iou[p] = (intersection.d[p] * union_value - intersection.value * d_union[p]) / (union_value * union_value);
+    }
+
+    // GIoU = IoU - (C - U) / C，C为凸包面积（3D时乘以联合高度）
+    Dual hull = hullArea(pred_corners, target_corners, jacobian_ptr);
+    double enclose = hull.value * enclose_height.value;
+    double giou = iou;
+    double d_giou[PARAM_COUNT];
+    std::copy(d_iou, d_iou + PARAM_COUNT, d_giou);
+    if (enclose > 1e-10) {
+        giou = iou - (enclose - union_value) / enclose;
+        for (int p = 0; p < PARAM_COUNT; ++p) {
+            double d_enclose = hull.d[p] * enclose_height.value + hull.value * enclose_height.d[p];
+            d_giou[p] += (d_union[p] * enclose - union_value * d_enclose) / (enclose * enclose);
+        }
+    }
+
+    // DIoU = IoU - rho^2 / c^2
+    Dual extent_x = cornerExtent(pred_corners, target_corners, true, jacobian_ptr);
+    Dual extent_z = cornerExtent(pred_corners, target_corners, false, jacobian_ptr);
+    double dx = static_cast<double>(pred.center_x) - target.center_x;
+    double dz = static_cast<double>(pred.center_z) - target.center_z;
+    double distance2 = dx * dx + dz * dz;
+    double diagonal2 = extent_x.value * extent_x.value + extent_z.value * extent_z.value;
+    double d_distance2[PARAM_COUNT] = {0.0};
+    double d_diagonal2[PARAM_COUNT];
+    d_distance2[CX] = 2.0 * dx;
+    d_distance2[CZ] = 2.0 * dz;
+    for (int p = 0; p < PARAM_COUNT; ++p) {
+        d_diagonal2[p] = 2.0 * (extent_x.value * extent_x.d[p] + extent_z.value * extent_z.d[p]);
+    }
+    if (is_3d) {
+        double dy = static_cast<double>(pred.center_y) - target.center_y;
+        distance2 += dy * dy;
+        d_distance2[CY] = 2.0 * dy;
+        diagonal2 += enclose_height.value * enclose_height.value;
+        for (int p = 0; p < PARAM_COUNT; ++p) {
+            d_diagonal2[p] += 2.0 * enclose_height.value * enclose_height.d[p];
+        }
+    }
+
+    double diou = iou;
+    double d_diou[PARAM_COUNT];
+    std::copy(d_iou, d_iou + PARAM_COUNT, d_diou);
+    if (diagonal2 > 1e-12) {
+        diou = iou - distance2 / diagonal2;
+        for (int p = 0; p < PARAM_COUNT; ++p) {
+            d_diou[p] -= (d_distance2[p] * diagonal2 - distance2 * d_diagonal2[p]) / (diagonal2 * diagonal2);
+        }
+    }
+
+    // CIoU = DIoU - alpha * v，v衡量BEV长宽比差异，alpha视为常数
+    double pred_atan = std::atan2(static_cast<double>(pred.length), static_cast<double>(pred.width));
+    double target_atan = std::atan2(static_cast<double>(target.length), static_cast<double>(target.width));
+    double delta = target_atan - pred_atan;
+    double v = 4.0 / (kPi * kPi) * delta * delta;
+    double alpha_denominator = (1.0 - iou) + v;
+    double alpha = alpha_denominator > 1e-12 ? v / alpha_denominator : 0.0;
+    double ciou = diou - alpha * v;
+    double d_ciou[PARAM_COUNT];
+    std::copy(d_diou, d_diou + PARAM_COUNT, d_ciou);
+    double norm2 = static_cast<double>(pred.length) * pred.length + static_cast<double>(pred.width) * pred.width;
+    if (norm2 > 0.0) {
+        // d(atan(l/w))/dl = w / (l^2 + w^2)，d(atan(l/w))/dw = -l / (l^2 + w^2)
+        double scale = -8.0 / (kPi * kPi) * delta;
+        d_ciou[LENGTH] -= alpha * scale * pred.width / norm2;
+        d_ciou[WIDTH] -= alpha * scale * -static_cast<double>(pred.length) / norm2;
+    }
+
+    result.metrics.iou = static_cast<float>(iou);
+    result.metrics.giou = static_cast<float>(giou);
+    result.metrics.diou = static_cast<float>(diou);
+    result.metrics.ciou = static_cast<float>(ciou);
+
+    const double* d_metric = d_iou;
+    switch (loss_type) {
+        case IoULossType::IOU: d_metric = d_iou; break;
+        case IoULossType::GIOU: d_metric = d_giou; break;
+        case IoULossType::DIOU: d_metric = d_diou; break;
+        case IoULossType::CIOU: d_metric = d_ciou; break;
+    }
+    for (int p = 0; p < PARAM_COUNT; ++p) {
+        result.d_loss[p] = -d_metric[p];
+    }
+}
+
+float lossFromMetrics(const IoUMetrics& metrics, IoULossType loss_type) {
+    switch (loss_type) {
+        case IoULossType::GIOU: return 1.0f - metrics.giou;
+        case IoULossType::DIOU: return 1.0f - metrics.diou;
+        case IoULossType::CIOU: return 1.0f - metrics.ciou;
+        case IoULossType::IOU: break;
+    }
+    return 1.0f - metrics.iou;
+}
+
+void storeGradient(const PairResult& result, BoxGradient& gradient) {
+    gradient.center_x = static_cast<float>(result.d_loss[CX]);
+    gradient.center_y = static_cast<float>(result.d_loss[CY]);
+    gradient.center_z = static_cast<float>(result.d_loss[CZ]);
+    gradient.length = static_cast<float>(result.d_loss[LENGTH]);
+    gradient.width = static_cast<float>(result.d_loss[WIDTH]);
+    gradient.height = static_cast<float>(result.d_loss[HEIGHT]);
+    gradient.yaw = static_cast<float>(result.d_loss[YAW]);
+}
+
+} // namespace
+
+IoUMetrics calculateIoUMetrics(const Box& pred, const Box& target, IoUType iou_type) {
+    PairResult result;
+    evaluatePair(pred, target, iou_type, IoULossType::IOU, false, result);
+    return result.metrics;
+}
+
+float calculateIoULoss(const Box& pred, const Box& target, IoULossType loss_type,
+                       IoUType iou_type, BoxGradient* gradient) {
+    PairResult result;
+    evaluatePair(pred, target, iou_type, loss_type, gradient != nullptr, result);
+    if (gradient != nullptr) {
+        storeGradient(result, *gradient);
+    }
+    return lossFromMetrics(result.metrics, loss_type);
+}
+
+void calculateIoUMetricsBatch(const std::vector<Box>& preds, const std::vector<Box>& targets,
+                              IoUType iou_type, IoUMetrics* out) {
+    SerialExecutor executor;
+    calculateIoUMetricsBatch(preds, targets, iou_type, out, executor);
+}
+
+void calculateIoUMetricsBatch(const std::vector<Box>& preds, const std::vector<Box>& targets,
+                              IoUType iou_type, IoUMetrics* out, Executor& executor) {
+    assert(preds.size() == targets.size());
+    executor.parallelFor(preds.size(), 1024, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            out[i] = calculateIoUMetrics(preds[i], targets[i], iou_type);
+        }
+    });
+}
+
+void calculateIoULossBatch(const std::vector<Box>& preds, const std::vector<Box>& targets,
+                           IoULossType loss_type, IoUType iou_type,
+                           float* losses, BoxGradient* gradients) {
+    SerialExecutor executor;
+    calculateIoULossBatch(preds, targets, loss_type, iou_type, losses, gradients, executor);
+}
+
+void calculateIoULossBatch(const std::vector<Box>& preds, const std::vector<Box>& targets,
+                           IoULossType loss_type, IoUType iou_type,
+                           float* losses, BoxGradient* gradients, Executor& executor) {
+    assert(preds.size() == targets.size());
+    executor.parallelFor(preds.size(), 1024, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            losses[i] = calculateIoULoss(preds[i], targets[i], loss_type, iou_type,
+                                         gradients != nullptr ? &gradients[i] : nullptr);
+        }
+    });
+}
+
+} // namespace nms
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "iou3d.h"
+#include "nms.h"
+
+#include <vector>
+
+namespace nms {
+
+/**
+ * @brief IoU类损失的种类
+ */
+enum class IoULossType {
+    IOU,   // 1 - IoU
+    GIOU,  // 1 - GIoU，包围区域为两个BEV矩形的凸包（3D时乘以联合高度范围）
+    DIOU,  // 1 - DIoU，中心距离惩罚项的分母为包含两框的轴对齐包围盒对角线
+    CIOU   // 1 - CIoU，在DIoU基础上加入BEV长宽比一致性项
+};
+
+/**
+ * @brief 一对包围盒的各类重叠度指标
+ */
+struct IoUMetrics {
+    float iou;
+    float giou;
+    float diou;
+    float ciou;
+};
+
+/**
+ * @brief 损失对预测框参数的梯度
+ */
+struct BoxGradient {
+    float center_x;
+    float center_y;
+    float center_z;
+    float length;
+    float width;
+    float height;
+    float yaw;
+};
+
+/**
+ * @brief 计算预测框与目标框的IoU/GIoU/DIoU/CIoU
+ * 内部以目标框中心为原点、使用double计算，与calculateIoU3D共用顶点和交集内核
+ * @param pred 预测框
+ * @param target 目标框
+ * @param iou_type BEV或3D
+ */
+IoUMetrics calculateIoUMetrics(const Box& pred, const Box& target, IoUType iou_type = IoUType::IOU_3D);
+
+/**
+ * @brief 计算IoU类损失及其对预测框参数的解析梯度
+ * 梯度通过交集顶点的来源（预测框角点、目标框角点或两条边的交点）链式传递到
+ * 中心、尺寸和yaw；在顶点来源发生变化的位置（例如角点恰好落在边上）损失不可导，
+ * 此时返回其中一侧的梯度。CIoU中的权重系数alpha按惯例视为常数。
+ * 尺寸应为正数。
+ * @param gradient 为nullptr时只计算损失
+ * @return 损失值
+ */
+float calculateIoULoss(const Box& pred, const Box& target, IoULossType loss_type,
+                       IoUType iou_type = IoUType::IOU_3D, BoxGradient* gradient = nullptr);
+
+/**
+ * @brief 批量计算逐对（pred[i], target[i]）的指标
+ * @param out 长度为preds.size()
+ */
+void calculateIoUMetricsBatch(const std::vector<Box>& preds, const std::vector<Box>& targets,
+                              IoUType iou_type, IoUMetrics* out);
+
+/**
+ * @brief 批量计算逐对指标（并行版本）
+ */
+void calculateIoUMetricsBatch(const std::vector<Box>& preds, const std::vector<Box>& targets,
+                              IoUType iou_type, IoUMetrics* out, Executor& executor);
+
+/**
+ * @brief 批量计算逐对损失和梯度
+ * @param losses 长度为preds.size()
+ * @param gradients 长度为preds.size()，为nullptr时不计算梯度
+ */
+void calculateIoULossBatch(const std::vector<Box>& preds, const std::vector<Box>& targets,
+                           IoULossType loss_type, IoUType iou_type,
+                           float* losses, BoxGradient* gradients);
+
+/**
+ * @brief 批量计算逐对损失和梯度（并行版本）
+ */
+void calculateIoULossBatch(const std::vector<Box>& preds, const std::vector<Box>& targets,
+                           IoULossType loss_type, IoUType iou_type,
+                           float* losses, BoxGradient* gradients, Executor& executor);
+
+} // namespace nms
@@ -0,0 +1,759 @@
+#include "nms.h"
+#include "broad_phase.h"
+#include "executor.h"
+#include "box_batch.h"
+#include "stats_hooks.h"
+#include <cmath>
+#include <algorithm>
+#include <unordered_map>
+#include <cstdint>
+
+namespace nms {
+
+namespace {
+
+/**
+ * @brief NMS过程中每个候选框预先计算的几何信息
+ */
+struct CandidateGeometry {
+    PreparedBox prepared;
+    int class_id;
+};
+
+void prepareCandidate(const Box& box, CandidateGeometry& geometry) {
+    prepareBox(box, geometry.prepared);
+    geometry.class_id = box.class_id;
+}
+
+/**
+ * @brief 判断两个候选框是否可能重叠（外接圆与轴对齐包围矩形测试）
+ */
+bool mayOverlap(const PreparedBox& g1, const PreparedBox& g2) {
+    float dx = g1.center_x - g2.center_x;
+    float dz = g1.center_z - g2.center_z;
+    float radius_sum = g1.radius + g2.radius;
+    if (dx * dx + dz * dz >= radius_sum * radius_sum) {
+        return false;
+    }
+
+    return g1.min_x < g2.max_x && g2.min_x < g1.max_x &&
+           g1.min_z < g2.max_z && g2.min_z < g1.max_z;
+}
+
+float candidateIoU(const PreparedBox& g1, const PreparedBox& g2, IoUType iou_type) {
+    return iou_type == IoUType::IOU_3D ? calculateIoU3D(g1, g2) : calculateBEVIoU(g1, g2);
+}
+
+/**
+ * @brief DIoU的中心距离惩罚项：中心距离平方除以包含两框的轴对齐包围盒对角线平方
+ */
+float distancePenalty(const PreparedBox& g1, const PreparedBox& g2, IoUType iou_type) {
+    float dx = g1.center_x - g2.center_x;
+    float dz = g1.center_z - g2.center_z;
+    float extent_x = std::max(g1.max_x, g2.max_x) - std::min(g1.min_x, g2.min_x);
+    float extent_z = std::max(g1.max_z, g2.max_z) - std::min(g1.min_z, g2.min_z);
+    float distance2 = dx * dx + dz * dz;
+    float diagonal2 = extent_x * extent_x + extent_z * extent_z;
+
+    if (iou_type == IoUType::IOU_3D) {
+        float dy = 0.5f * ((g1.y_min + g1.y_max) - (g2.y_min + g2.y_max));
+        float extent_y = std::max(g1.y_max, g2.y_max) - std::min(g1.y_min, g2.y_min);
+        distance2 += dy * dy;
+        diagonal2 += extent_y * extent_y;
+    }
+
+    return diagonal2 > 0.0f ? distance2 / diagonal2 : 0.0f;
+}
+
+/**
+ * @brief 判断高分框是否抑制另一个框（调用前已通过mayOverlap测试）
+ */
+bool shouldSuppress(const PreparedBox& g1, const PreparedBox& g2, const NMSConfig& config) {
+    float overlap = candidateIoU(g1, g2, config.iou_type);
+    if (config.use_distance_iou) {
+        overlap -= distancePenalty(g1, g2, config.iou_type);
+    }
+    return overlap > config.iou_threshold;
+}
+
+/**
+ * @brief 按置信度过滤并降序排列，应用top-K限制
+ * @param score 返回第i个框置信度的函数
+ */
+template <typename Score>
+void sortByScore(size_t count, Score score, float score_threshold, int pre_max_size, std::vector<int>& order) {
+    order.clear();
+    for (size_t i = 0; i < count; ++i) {
+        if (score(i) >= score_threshold) {
+            order.push_back(static_cast<int>(i));
+        }
+    }
+    // 置信度相同时按索引排序，与稳定排序的结果相同，但不需要额外的缓冲区
+    std::sort(order.begin(), order.end(), [&score](int a, int b) {
+        float score_a = score(a);
+        float score_b = score(b);
+        if (score_a != score_b) {
+            return score_a > score_b;
+        }
+        return a < b;
+    });
+
+    if (pre_max_size > 0 && order.size() > static_cast<size_t>(pre_max_size)) {
+        order.resize(pre_max_size);
+    }
+}
+
+template <typename BoxType>
+void sortCandidates(const std::vector<BoxType>& boxes, float score_threshold, int pre_max_size,
+                    std::vector<int>& order) {
+    sortByScore(boxes.size(), [&boxes](size_t i) { return boxes[i].confidence; },
+                score_threshold, pre_max_size, order);
+}
+
+/**
+ * @brief 按行存放的原始框参数
+ */
+struct RawBoxes {
+    const float* boxes;
+    size_t stride;
+    const float* scores;
+    const int* class_ids;
+};
+
+/**
+ * @brief 准备候选框几何信息和包围矩形
+ */
+void prepareCandidates(const std::vector<Box>& boxes, const std::vector<int>& order,
+                       std::vector<CandidateGeometry>& geometries, std::vector<BEVBounds>& bounds,
+                       Executor& executor) {
+    const size_t n = order.size();
+    geometries.resize(n);
+    bounds.resize(n);
+    executor.parallelFor(n, 256, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            prepareCandidate(boxes[order[i]], geometries[i]);
+            const PreparedBox& p = geometries[i].prepared;
+            BEVBounds b = {p.min_x, p.min_z, p.max_x, p.max_z};
+            bounds[i] = b;
+        }
+    });
+}
+
+float softDecay(float iou, const SoftNMSConfig& config) {
+    if (config.method == SoftNMSMethod::GAUSSIAN) {
+        return std::exp(-iou * iou / config.sigma);
+    }
+    return iou > config.iou_threshold ? 1.0f - iou : 1.0f;
+}
+
+/**
+ * @brief Soft-NMS优先队列中的元素，分数高者优先，分数相同时原始排名靠前者优先
+ * 分数更新时直接压入新元素，出队时与当前分数不一致的旧元素被跳过
+ */
+struct ScoreEntry {
+    float score;
+    int rank;
+
+    bool operator<(const ScoreEntry& other) const {
+        if (score != other.score) {
+            return score < other.score;
+        }
+        return rank > other.rank;
+    }
+};
+
+/**
+ * @brief WBF中的一个簇，累加成员的加权参数
+ */
+struct FusionCluster {
+    Box fused;
+    PreparedBox prepared;
+    float reference_yaw;
+    double weight_sum;
+    double center_x;
+    double center_y;
+    double center_z;
+    double length;
+    double width;
+    double height;
+    double yaw_cos;
+    double yaw_sin;
+    long long cell;
+    int count;
+};
+
+const float kPi = 3.14159265358979323846f;
+
+/**
+ * @brief 将角度对齐到reference附近：相差超过90°时翻转180°（BEV矩形关于中心对称）
+ */
+float alignYaw(float yaw, float reference) {
+    float diff = std::remainder(yaw - reference, 2.0f * kPi);
+    if (diff > 0.5f * kPi) {
+        diff -= kPi;
+    } else if (diff < -0.5f * kPi) {
+        diff += kPi;
+    }
+    return reference + diff;
+}
+
+void addToCluster(const Box& box, FusionCluster& cluster) {
+    double w = box.confidence;
+    float yaw = alignYaw(box.yaw, cluster.reference_yaw);
+    cluster.weight_sum += w;
+    cluster.center_x += w * box.center_x;
+    cluster.center_y += w * box.center_y;
+    cluster.center_z += w * box.center_z;
+    cluster.length += w * box.length;
+    cluster.width += w * box.width;
+    cluster.height += w * box.height;
+    cluster.yaw_cos += w * std::cos(yaw);
+    cluster.yaw_sin += w * std::sin(yaw);
+    cluster.count += 1;
+
+    // 置信度全为0时退化为等权平均
+    double inv = cluster.weight_sum > 0.0 ? 1.0 / cluster.weight_sum : 0.0;
+    Box& fused = cluster.fused;
+    if (inv > 0.0) {
+        fused.center_x = static_cast<float>(cluster.center_x * inv);
+        fused.center_y = static_cast<float>(cluster.center_y * inv);
+        fused.center_z = static_cast<float>(cluster.center_z * inv);
+        fused.length = static_cast<float>(cluster.length * inv);
+        fused.width = static_cast<float>(cluster.width * inv);
+        fused.height = static_cast<float>(cluster.height * inv);
+        fused.yaw = static_cast<float>(std::atan2(cluster.yaw_sin, cluster.yaw_cos));
+    }
+    prepareBox(fused, cluster.prepared);
+}
+
+long long fusionCellKey(float x, float z, float cell_size, int dx, int dz) {
+    long long cx = static_cast<long long>(std::floor(x / cell_size)) + dx;
+    long long cz = static_cast<long long>(std::floor(z / cell_size)) + dz;
+    return (cx << 32) ^ (cz & 0xffffffffLL);
+}
+
+} // namespace
+
+std::vector<int> nonMaximumSuppression(const std::vector<Box>& boxes, const NMSConfig& config) {
+    IOU3D_STAGE_TIMER(Stage::NMS);
+    std::vector<int> order;
+    sortCandidates(boxes, config.score_threshold, config.pre_max_size, order);
+
+    std::vector<CandidateGeometry> geometries(order.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        prepareCandidate(boxes[order[i]], geometries[i]);
+    }
+
+    std::vector<char> suppressed(order.size(), 0);
+    std::vector<int> keep;
+    keep.reserve(order.size());
+
+    for (size_t i = 0; i < order.size(); ++i) {
+        if (suppressed[i]) {
+            continue;
+        }
+
+        keep.push_back(order[i]);
+        if (config.post_max_size > 0 && keep.size() >= static_cast<size_t>(config.post_max_size)) {
+            break;
+        }
+
+        const CandidateGeometry& current = geometries[i];
+        for (size_t j = i + 1; j < order.size(); ++j) {
+            if (suppressed[j]) {
+                continue;
+            }
+
+            const CandidateGeometry& other = geometries[j];
+            if (config.class_aware && current.class_id != other.class_id) {
+                continue;
+            }
+            if (!mayOverlap(current.prepared, other.prepared)) {
+                continue;
+            }
+
+            if (shouldSuppress(current.prepared, other.prepared, config)) {
+                suppressed[j] = 1;
+            }
+        }
+    }
+
+    return keep;
+}
+
+std::vector<int> nonMaximumSuppression(const std::vector<Box>& boxes, const NMSConfig& config,
+                                       Executor& executor) {
+    NmsWorkspace workspace(config);
+    return workspace.process(boxes, executor);
+}
+
+std::vector<int> nonMaximumSuppression(const std::vector<BoxPOD>& boxes, const NMSConfig& config) {
+    NmsWorkspace workspace(config);
+    return workspace.process(boxes);
+}
+
+std::vector<int> nonMaximumSuppression(const std::vector<BoxPOD>& boxes, const NMSConfig& config,
+                                       Executor& executor) {
+    NmsWorkspace workspace(config);
+    return workspace.process(boxes, executor);
+}
+
+std::vector<int> bitmaskNonMaximumSuppression(const std::vector<Box>& boxes, const NMSConfig& config) {
+    SerialExecutor executor;
+    return bitmaskNonMaximumSuppression(boxes, config, executor);
+}
+
+std::vector<int> bitmaskNonMaximumSuppression(const std::vector<Box>& boxes, const NMSConfig& config,
+                                              Executor& executor) {
+    IOU3D_STAGE_TIMER(Stage::NMS);
+    std::vector<int> order;
+    sortCandidates(boxes, config.score_threshold, config.pre_max_size, order);
+
+    const size_t n = order.size();
+    std::vector<CandidateGeometry> geometries;
+    std::vector<BEVBounds> bounds;
+    prepareCandidates(boxes, order, geometries, bounds, executor);
+
+    // 外接圆测试使用的连续数组，块内先无分支地求出候选位，再只对候选位计算IoU
+    std::vector<float> center_x(n), center_z(n), radius(n);
+    std::vector<int> class_ids(n);
+    for (size_t i = 0; i < n; ++i) {
+        center_x[i] = geometries[i].prepared.center_x;
+        center_z[i] = geometries[i].prepared.center_z;
+        radius[i] = geometries[i].prepared.radius;
+        class_ids[i] = config.class_aware ? geometries[i].class_id : 0;
+    }
+
+    // mask[i * num_blocks + b]的第k位表示第i个框抑制第(64b + k)个框，只记录j > i
+    const size_t num_blocks = (n + 63) / 64;
+    std::vector<uint64_t> mask(n * num_blocks, 0);
+
+    // 上三角（列块 >= 行块）的所有块按行块依次编号
+    std::vector<size_t> tile_start(num_blocks + 1, 0);
+    for (size_t rb = 0; rb < num_blocks; ++rb) {
+        tile_start[rb + 1] = tile_start[rb] + (num_blocks - rb);
+    }
+
+    executor.parallelFor(tile_start[num_blocks], 4, [&](size_t begin, size_t end) {
+        for (size_t t = begin; t < end; ++t) {
+            size_t rb = std::upper_bound(tile_start.begin(), tile_start.end(), t) - tile_start.begin() - 1;
+            size_t cb = rb + (t - tile_start[rb]);
+            size_t row_end = std::min(n, rb * 64 + 64);
+            size_t col_begin = cb * 64;
+            size_t col_end = std::min(n, col_begin + 64);
+
+            for (size_t i = rb * 64; i < row_end; ++i) {
+                uint64_t candidates = 0;
+                for (size_t j = std::max(i + 1, col_begin); j < col_end; ++j) {
+                    float dx = center_x[i] - center_x[j];
+                    float dz = center_z[i] - center_z[j];
+                    float radius_sum = radius[i] + radius[j];
+                    bool hit = dx * dx + dz * dz < radius_sum * radius_sum && class_ids[i] == class_ids[j];
+                    candidates |= static_cast<uint64_t>(hit) << (j - col_begin);
+                }
+
+                uint64_t bits = 0;
+                for (size_t k = 0; candidates != 0; ++k, candidates >>= 1) {
+                    if (!(candidates & 1)) {
+                        continue;
+                    }
+                    const PreparedBox& current = geometries[i].prepared;
+                    const PreparedBox& other = geometries[col_begin + k].prepared;
+                    if (mayOverlap(current, other) && shouldSuppress(current, other, config)) {
+                        bits |= uint64_t(1) << k;
+                    }
+                }
+                mask[i * num_blocks + cb] = bits;
+            }
+        }
+    });
+
+    // 按置信度顺序扫描，removed为已被抑制的框集合
+    std::vector<uint64_t> removed(num_blocks, 0);
+    std::vector<int> keep;
+    keep.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        size_t block = i / 64;
+        if (removed[block] & (uint64_t(1) << (i % 64))) {
+            continue;
+        }
+
+        keep.push_back(order[i]);
+        if (config.post_max_size > 0 && keep.size() >= static_cast<size_t>(config.post_max_size)) {
+            break;
+        }
+
+        const uint64_t* row = &mask[i * num_blocks];
+        for (size_t b = block; b < num_blocks; ++b) {
+            removed[b] |= row[b];
+        }
+    }
+
+    return keep;
+}
+
+NmsWorkspace::NmsWorkspace(const NMSConfig& config) : config_(config) {}
+
+void NmsWorkspace::reserve(size_t max_boxes) {
+    order_.reserve(max_boxes);
+    prepared_.reserve(max_boxes);
+    class_ids_.reserve(max_boxes);
+    bounds_.reserve(max_boxes);
+    adjacency_start_.reserve(max_boxes + 1);
+    adjacency_fill_.reserve(max_boxes);
+    suppressed_.reserve(max_boxes);
+    keep_.reserve(max_boxes);
+}
+
+const std::vector<int>& NmsWorkspace::process(const std::vector<Box>& boxes) {
+    SerialExecutor executor;
+    return process(boxes, executor);
+}
+
+const std::vector<int>& NmsWorkspace::process(const std::vector<Box>& boxes, Executor& executor) {
+    return processBoxes(boxes, executor);
+}
+
+const std::vector<int>& NmsWorkspace::process(const std::vector<BoxPOD>& boxes) {
+    SerialExecutor executor;
+    return processBoxes(boxes, executor);
+}
+
+const std::vector<int>& NmsWorkspace::process(const std::vector<BoxPOD>& boxes, Executor& executor) {
+    return processBoxes(boxes, executor);
+}
+
+template <typename BoxType>
+const std::vector<int>& NmsWorkspace::processBoxes(const std::vector<BoxType>& boxes, Executor& executor) {
+    IOU3D_STAGE_TIMER(Stage::NMS);
+    sortCandidates(boxes, config_.score_threshold, config_.pre_max_size, order_);
+
+    const size_t n = order_.size();
+    prepared_.resize(n);
+    class_ids_.resize(n);
+    // 只按引用捕获，std::function不会为闭包分配内存
+    const std::vector<BoxType>* source = &boxes;
+    executor.parallelFor(n, 256, [this, source](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const BoxType& box = (*source)[order_[i]];
+            prepareBox(box, prepared_[i]);
+            class_ids_[i] = box.class_id;
+        }
+    });
+
+    suppress(executor);
+    return keep_;
+}
+
+const std::vector<int>& NmsWorkspace::process(const float* boxes, size_t count, size_t stride,
+                                              const float* scores, const int* class_ids,
+                                              Executor& executor) {
+    IOU3D_STAGE_TIMER(Stage::NMS);
+    sortByScore(count, [scores](size_t i) { return scores[i]; },
+                config_.score_threshold, config_.pre_max_size, order_);
+
+    const size_t n = order_.size();
+    prepared_.resize(n);
+    class_ids_.resize(n);
+    RawBoxes source = {boxes, stride, scores, class_ids};
+    executor.parallelFor(n, 256, [this, &source](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            size_t index = static_cast<size_t>(order_[i]);
+            prepareBox(source.boxes + index * source.stride, prepared_[i]);
+            class_ids_[i] = source.class_ids ? source.class_ids[index] : 0;
+        }
+    });
+
+    suppress(executor);
+    return keep_;
+}
+
+const std::vector<int>& NmsWorkspace::process(const BoxBatchView& boxes, Executor& executor) {
+    IOU3D_STAGE_TIMER(Stage::NMS);
+    const float* scores = boxes.confidence;
+    sortByScore(boxes.size(), [scores](size_t i) { return scores[i]; },
+                config_.score_threshold, config_.pre_max_size, order_);
+
+    const size_t n = order_.size();
+    prepared_.resize(n);
+    class_ids_.resize(n);
+    const BoxBatchView* source = &boxes;
+    executor.parallelFor(n, 256, [this, source](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            size_t index = static_cast<size_t>(order_[i]);
+            prepareBox(*source, index, prepared_[i]);
+            class_ids_[i] = source->class_id[index];
+        }
+    });
+
+    suppress(executor);
+    return keep_;
+}
+
+void NmsWorkspace::suppress(Executor& executor) {
+    const size_t n = order_.size();
+    bounds_.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        const PreparedBox& p = prepared_[i];
+        BEVBounds b = {p.min_x, p.min_z, p.max_x, p.max_z};
+        bounds_[i] = b;
+    }
+
+    // 粗筛：只有包围矩形相交的框对才可能互相抑制
+    grid_.build(bounds_);
+    grid_.selfPairs(pairs_);
+
+    testPairs(executor);
+    sweep();
+}
+
+void NmsWorkspace::testPairs(Executor& executor) {
+    // 并行判断每个候选对是否超过阈值
+    overlapping_.assign(pairs_.size(), 0);
+    executor.parallelFor(pairs_.size(), 1024, [this](size_t begin, size_t end) {
+        for (size_t k = begin; k < end; ++k) {
+            int first = pairs_[k].first;
+            int second = pairs_[k].second;
+            if (config_.class_aware && class_ids_[first] != class_ids_[second]) {
+                continue;
+            }
+            if (!mayOverlap(prepared_[first], prepared_[second])) {
+                continue;
+            }
+            overlapping_[k] = shouldSuppress(prepared_[first], prepared_[second], config_);
+        }
+    });
+}
+
+void NmsWorkspace::sweep() {
+    const size_t n = order_.size();
+
+    // 以高分框为起点构建邻接表（CSR），first < second即first的置信度更高
+    adjacency_start_.assign(n + 1, 0);
+    for (size_t k = 0; k < pairs_.size(); ++k) {
+        if (overlapping_[k]) {
+            ++adjacency_start_[pairs_[k].first + 1];
+        }
+    }
+    for (size_t i = 0; i < n; ++i) {
+        adjacency_start_[i + 1] += adjacency_start_[i];
+    }
+    adjacency_.resize(adjacency_start_[n]);
+    adjacency_fill_.assign(adjacency_start_.begin(), adjacency_start_.end() - 1);
+    for (size_t k = 0; k < pairs_.size(); ++k) {
+        if (overlapping_[k]) {
+            adjacency_[adjacency_fill_[pairs_[k].first]++] = pairs_[k].second;
+        }
+    }
+
+    // 按置信度顺序串行扫描
+    suppressed_.assign(n, 0);
+    keep_.clear();
+    for (size_t i = 0; i < n; ++i) {
+        if (suppressed_[i]) {
+            continue;
+        }
+
+        keep_.push_back(order_[i]);
+        if (config_.post_max_size > 0 && keep_.size() >= static_cast<size_t>(config_.post_max_size)) {
+            break;
+        }
+
+        for (int k = adjacency_start_[i]; k < adjacency_start_[i + 1]; ++k) {
+            suppressed_[adjacency_[k]] = 1;
+        }
+    }
+}
+
+SoftNMSResult softNonMaximumSuppression(const std::vector<Box>& boxes, const SoftNMSConfig& config) {
+    std::vector<int> order;
+    sortCandidates(boxes, config.score_threshold, config.pre_max_size, order);
+
+    const size_t n = order.size();
+    std::vector<CandidateGeometry> geometries;
+    std::vector<BEVBounds> bounds;
+    SerialExecutor executor;
+    prepareCandidates(boxes, order, geometries, bounds, executor);
+
+    // 预先计算所有会衰减分数的重叠对，之后只沿这些边更新
+    BEVGrid grid;
+    grid.build(bounds);
+    std::vector<CandidatePair> pairs;
+    grid.selfPairs(pairs);
+
+    std::vector<float> decay(pairs.size(), 1.0f);
+    std::vector<int> degree_start(n + 1, 0);
+    for (size_t k = 0; k < pairs.size(); ++k) {
+        const CandidateGeometry& g1 = geometries[pairs[k].first];
+        const CandidateGeometry& g2 = geometries[pairs[k].second];
+        if (config.class_aware && g1.class_id != g2.class_id) {
+            continue;
+        }
+        if (!mayOverlap(g1.prepared, g2.prepared)) {
+            continue;
+        }
+        decay[k] = softDecay(candidateIoU(g1.prepared, g2.prepared, config.iou_type), config);
+        if (decay[k] < 1.0f) {
+            ++degree_start[pairs[k].first + 1];
+            ++degree_start[pairs[k].second + 1];
+        }
+    }
+
+    // 对称的CSR邻接表，附带衰减系数
+    for (size_t i = 0; i < n; ++i) {
+        degree_start[i + 1] += degree_start[i];
+    }
+    std::vector<int> neighbors(degree_start[n]);
+    std::vector<float> factors(degree_start[n]);
+    std::vector<int> fill(degree_start.begin(), degree_start.end() - 1);
+    for (size_t k = 0; k < pairs.size(); ++k) {
+        if (decay[k] < 1.0f) {
+            int a = pairs[k].first;
+            int b = pairs[k].second;
+            neighbors[fill[a]] = b;
+            factors[fill[a]++] = decay[k];
+            neighbors[fill[b]] = a;
+            factors[fill[b]++] = decay[k];
+        }
+    }
+
+    std::vector<float> scores(n);
+    std::vector<ScoreEntry> heap(n);
+    for (size_t i = 0; i < n; ++i) {
+        scores[i] = boxes[order[i]].confidence;
+        heap[i].score = scores[i];
+        heap[i].rank = static_cast<int>(i);
+    }
+    std::make_heap(heap.begin(), heap.end());
+
+    // 0：待处理，1：已选出或已丢弃
+    std::vector<char> done(n, 0);
+    SoftNMSResult result;
+    while (!heap.empty()) {
+        ScoreEntry top = heap.front();
+        std::pop_heap(heap.begin(), heap.end());
+        heap.pop_back();
+        if (done[top.rank] || top.score != scores[top.rank]) {
+            continue;
+        }
+
+        done[top.rank] = 1;
+        result.indices.push_back(order[top.rank]);
+        result.scores.push_back(top.score);
+        if (config.post_max_size > 0 && result.indices.size() >= static_cast<size_t>(config.post_max_size)) {
+            break;
+        }
+
+        for (int k = degree_start[top.rank]; k < degree_start[top.rank + 1]; ++k) {
+            int j = neighbors[k];
+            if (done[j]) {
+                continue;
+            }
+            scores[j] *= factors[k];
+            if (scores[j] < config.score_threshold) {
+                done[j] = 1;
+                continue;
+            }
+            ScoreEntry entry;
+            entry.score = scores[j];
+            entry.rank = j;
+            heap.push_back(entry);
+            std::push_heap(heap.begin(), heap.end());
+        }
+    }
+
+    return result;
+}
+
+std::vector<Box> weightedBoxFusion(const std::vector<Box>& boxes, const WBFConfig& config) {
+    std::vector<int> order;
+    sortCandidates(boxes, config.score_threshold, -1, order);
+
+    // 融合框的长宽是成员的加权平均，外接圆半径不超过最大半径，
+    // 网格边长取两倍最大半径时，重叠的簇一定位于相邻的3×3个单元内
+    float max_radius = 0.0f;
+    for (size_t i = 0; i < order.size(); ++i) {
+        const Box& box = boxes[order[i]];
+        max_radius = std::max(max_radius, 0.5f * std::sqrt(box.length * box.length + box.width * box.width));
+    }
+    const float cell_size = std::max(2.0f * max_radius, 1e-3f);
+
+    std::vector<FusionCluster> clusters;
+    std::unordered_map<long long, std::vector<int>> cells;
+    PreparedBox prepared;
+
+    for (size_t i = 0; i < order.size(); ++i) {
+        const Box& box = boxes[order[i]];
+        prepareBox(box, prepared);
+
+        // 在相邻单元中寻找IoU最大的簇，IoU相同时取先建立的簇
+        int best = -1;
+        float best_iou = config.iou_threshold;
+        for (int dx = -1; dx <= 1; ++dx) {
+            for (int dz = -1; dz <= 1; ++dz) {
+                std::unordered_map<long long, std::vector<int>>::const_iterator it =
+                    cells.find(fusionCellKey(box.center_x, box.center_z, cell_size, dx, dz));
+                if (it == cells.end()) {
+                    continue;
+                }
+                for (size_t k = 0; k < it->second.size(); ++k) {
+                    int c = it->second[k];
+                    const FusionCluster& cluster = clusters[c];
+                    if (config.class_aware && cluster.fused.class_id != box.class_id) {
+                        continue;
+                    }
+                    if (!mayOverlap(prepared, cluster.prepared)) {
+                        continue;
+                    }
+                    float iou = candidateIoU(prepared, cluster.prepared, config.iou_type);
+                    if (iou > best_iou || (iou == best_iou && best >= 0 && c < best)) {
+                        best_iou = iou;
+                        best = c;
+                    }
+                }
+            }
+        }
+
+        if (best < 0) {
+            FusionCluster cluster = FusionCluster();
+            cluster.fused = box;
+            cluster.reference_yaw = box.yaw;
+            addToCluster(box, cluster);
+            cluster.cell = fusionCellKey(cluster.fused.center_x, cluster.fused.center_z, cell_size, 0, 0);
+            cells[cluster.cell].push_back(static_cast<int>(clusters.size()));
+            clusters.push_back(cluster);
+            continue;
+        }
+
+        // 融合框中心移动后更新所在单元
+        FusionCluster& cluster = clusters[best];
+        addToCluster(box, cluster);
+        long long cell = fusionCellKey(cluster.fused.center_x, cluster.fused.center_z, cell_size, 0, 0);
+        if (cell != cluster.cell) {
+            std::vector<int>& members = cells[cluster.cell];
+            members.erase(std::find(members.begin(), members.end(), best));
+            cells[cell].push_back(best);
+            cluster.cell = cell;
+        }
+    }
+
+    std::vector<Box> fused;
+    fused.reserve(clusters.size());
+    for (size_t c = 0; c < clusters.size(); ++c) {
+        const FusionCluster& cluster = clusters[c];
+        Box box = cluster.fused;
+        float confidence = static_cast<float>(cluster.weight_sum / cluster.count);
+        if (config.num_models > 0) {
+            confidence *= static_cast<float>(std::min(cluster.count, config.num_models)) / config.num_models;
+        }
+        box.confidence = confidence;
+        fused.push_back(box);
+    }
+    std::stable_sort(fused.begin(), fused.end(), [](const Box& a, const Box& b) {
+        return a.confidence > b.confidence;
+    });
+
+    return fused;
+}
+
+} // namespace nms
@@ -0,0 +1,242 @@
+#pragma once
+
+#include "iou3d.h"
+#include "broad_phase.h"
+
+#include <vector>
+
+namespace nms {
+
+struct BoxBatchView;
+
+/**
+ * @brief NMS使用的重叠度类型
+ */
+enum class IoUType {
+    BEV,     // BEV平面（xoz）IoU
+    IOU_3D   // 3D IoU
+};
+
+/**
+ * @brief 非极大值抑制参数
+ */
+struct NMSConfig {
+    // IoU大于该阈值的低分框被抑制
+    float iou_threshold = 0.5f;
+    // 置信度低于该阈值的框在NMS之前被丢弃
+    float score_threshold = 0.0f;
+    // 使用BEV IoU还是3D IoU判断重叠
+    IoUType iou_type = IoUType::BEV;
+    // 为true时只在相同class_id的框之间进行抑制
+    bool class_aware = true;
+    // NMS之前按置信度保留的最大框数，<=0表示不限制
+    int pre_max_size = -1;
+    // NMS之后保留的最大框数，<=0表示不限制
+    int post_max_size = -1;
+    // 为true时使用DIoU（IoU减去中心距离惩罚项）判断是否抑制，
+    // 中心相距较远的重叠框更容易被保留
+    bool use_distance_iou = false;
+};
+
+/**
+ * @brief Soft-NMS的分数衰减方式
+ */
+enum class SoftNMSMethod {
+    LINEAR,   // IoU超过阈值时分数乘以(1 - IoU)
+    GAUSSIAN  // 分数乘以exp(-IoU^2 / sigma)
+};
+
+/**
+ * @brief Soft-NMS参数
+ */
+struct SoftNMSConfig {
+    SoftNMSMethod method = SoftNMSMethod::GAUSSIAN;
+    // 高斯衰减的sigma
+    float sigma = 0.5f;
+    // 线性衰减只作用于IoU大于该阈值的框
+    float iou_threshold = 0.3f;
+    // 输入框以及衰减后的分数低于该阈值时被丢弃
+    float score_threshold = 0.001f;
+    IoUType iou_type = IoUType::BEV;
+    bool class_aware = true;
+    // 参与Soft-NMS的最大框数（按原始置信度），<=0表示不限制
+    int pre_max_size = -1;
+    // 输出的最大框数，<=0表示不限制
+    int post_max_size = -1;
+};
+
+/**
+ * @brief Soft-NMS结果，indices与scores一一对应，按选出顺序（衰减后分数降序）排列
+ */
+struct SoftNMSResult {
+    std::vector<int> indices;
+    std::vector<float> scores;
+};
+
+/**
+ * @brief 加权框融合参数
+ */
+struct WBFConfig {
+    // 与簇的融合框IoU超过该阈值时并入该簇
+    float iou_threshold = 0.55f;
+    // 置信度低于该阈值的框不参与融合
+    float score_threshold = 0.0f;
+    IoUType iou_type = IoUType::BEV;
+    bool class_aware = true;
+    // 参与集成的模型数，>0时融合置信度乘以min(簇大小, num_models) / num_models
+    int num_models = 0;
+};
+
+/**
+ * @brief 对3D包围盒执行贪心非极大值抑制
+ * 按置信度降序处理（置信度相同时索引小的优先），对外接圆或轴对齐包围矩形
+ * 不相交的框对直接跳过IoU计算
+ * @param boxes 待处理的包围盒
+ * @param config NMS参数
+ * @return 保留框在boxes中的索引，按置信度降序排列
+ */
+std::vector<int> nonMaximumSuppression(const std::vector<Box>& boxes,
+                                       const NMSConfig& config = NMSConfig());
+
+/**
+ * @brief 并行NMS
+ * 先用BEV网格找出包围矩形相交的候选对，由执行器并行计算每对是否超过IoU阈值，
+ * 再按置信度顺序串行扫描完成抑制。结果与串行版本完全一致，与线程数无关。
+ * @param boxes 待处理的包围盒
+ * @param config NMS参数
+ * @param executor 并行执行器（见executor.h）
+ * @return 保留框在boxes中的索引，按置信度降序排列
+ */
+std::vector<int> nonMaximumSuppression(const std::vector<Box>& boxes, const NMSConfig& config,
+                                       Executor& executor);
+
+/**
+ * @brief BoxPOD版本的NMS，结果与对应Box的版本完全一致
+ */
+std::vector<int> nonMaximumSuppression(const std::vector<BoxPOD>& boxes,
+                                       const NMSConfig& config = NMSConfig());
+std::vector<int> nonMaximumSuppression(const std::vector<BoxPOD>& boxes, const NMSConfig& config,
+                                       Executor& executor);
+
+/**
+ * @brief 基于64位分块抑制位图的NMS
+ * 候选框按置信度排序后，第i个框对其后每个框是否超过IoU阈值记录为一行位图，
+ * 按64列分块存储。位图以64×64的块为单位由执行器并行计算（块之间没有依赖），
+ * 最后按置信度顺序串行扫描，每保留一个框就把它的位图行按字或入已抑制集合。
+ * IoU阶段完全并行，串行阶段只做O(N²/64)次字操作。结果与nonMaximumSuppression完全一致。
+ * 位图占用N²/8字节，适合单帧数万个框以内的规模。
+ * @param boxes 待处理的包围盒
+ * @param config NMS参数
+ * @return 保留框在boxes中的索引，按置信度降序排列
+ */
+std::vector<int> bitmaskNonMaximumSuppression(const std::vector<Box>& boxes,
+                                              const NMSConfig& config = NMSConfig());
+
+/**
+ * @brief 位图NMS（并行版本）
+ */
+std::vector<int> bitmaskNonMaximumSuppression(const std::vector<Box>& boxes, const NMSConfig& config,
+                                              Executor& executor);
+
+/**
+ * @brief 可逐帧复用的NMS工作区
+ * 持有排序、几何预计算、网格粗筛、邻接表和输出所需的全部缓冲区，每帧只重置不释放。
+ * 缓冲区容量达到所处理过的最大帧的规模后，process不再分配堆内存
+ * （使用ThreadPool时，执行器内部的任务调度同样不分配内存）。
+ * 结果与nonMaximumSuppression完全一致。一个工作区不能被多个线程同时使用。
+ */
+class NmsWorkspace {
+public:
+    explicit NmsWorkspace(const NMSConfig& config = NMSConfig());
+
+    void setConfig(const NMSConfig& config) { config_ = config; }
+    const NMSConfig& config() const { return config_; }
+
+    /**
+     * @brief 按预计的最大框数预留缓冲区，减少预热阶段的重新分配
+     */
+    void reserve(size_t max_boxes);
+
+    /**
+     * @brief 对一帧执行NMS
+     * @return 保留框的索引（按置信度降序），引用在下一次process之前有效
+     */
+    const std::vector<int>& process(const std::vector<Box>& boxes);
+
+    /**
+     * @brief 对一帧执行NMS（并行版本）
+     */
+    const std::vector<int>& process(const std::vector<Box>& boxes, Executor& executor);
+
+    /**
+     * @brief 对一帧BoxPOD执行NMS
+     */
+    const std::vector<int>& process(const std::vector<BoxPOD>& boxes);
+    const std::vector<int>& process(const std::vector<BoxPOD>& boxes, Executor& executor);
+
+    /**
+     * @brief 对按行存放的原始参数执行NMS，不构造Box
+     * @param boxes 第i个框的参数为boxes[i*stride ... i*stride+6]：
+     *              center_x, center_y, center_z, length, width, height, yaw
+     * @param count 框数
+     * @param stride 相邻两个框之间的float个数，不小于7
+     * @param scores 长度为count的置信度
+     * @param class_ids 长度为count的类别，为nullptr时视为同一类别
+     * @return 保留框的索引（按置信度降序）
+     */
+    const std::vector<int>& process(const float* boxes, size_t count, size_t stride,
+                                    const float* scores, const int* class_ids, Executor& executor);
+
+    /**
+     * @brief 对SoA视图（例如内存映射文件中的一帧）执行NMS，置信度和类别取自视图
+     * @return 保留框在视图中的索引（按置信度降序）
+     */
+    const std::vector<int>& process(const BoxBatchView& boxes, Executor& executor);
+
+private:
+    template <typename BoxType>
+    const std::vector<int>& processBoxes(const std::vector<BoxType>& boxes, Executor& executor);
+    void suppress(Executor& executor);
+    void testPairs(Executor& executor);
+    void sweep();
+
+    NMSConfig config_;
+    std::vector<int> order_;
+    std::vector<PreparedBox> prepared_;
+    std::vector<int> class_ids_;
+    std::vector<BEVBounds> bounds_;
+    BEVGrid grid_;
+    std::vector<CandidatePair> pairs_;
+    std::vector<char> overlapping_;
+    // 以高分框为起点的邻接表（CSR）
+    std::vector<int> adjacency_start_;
+    std::vector<int> adjacency_;
+    std::vector<int> adjacency_fill_;
+    std::vector<char> suppressed_;
+    std::vector<int> keep_;
+};
+
+/**
+ * @brief 带线性或高斯分数衰减的Soft-NMS
+ * 先用BEV网格求出所有有重叠的框对及其IoU，再用惰性更新的优先队列反复取出当前分数最高的框，
+ * 只更新其重叠邻居的分数。复杂度为O((N + 重叠对数) log N)，结果与逐轮全量重排的朴素实现一致。
+ * @param boxes 待处理的包围盒
+ * @param config Soft-NMS参数
+ * @return 保留的索引及衰减后的分数
+ */
+SoftNMSResult softNonMaximumSuppression(const std::vector<Box>& boxes,
+                                        const SoftNMSConfig& config = SoftNMSConfig());
+
+/**
+ * @brief 加权框融合（WBF）
+ * 按置信度降序依次处理，每个框并入融合框IoU最大且超过阈值的簇，否则新建一个簇。
+ * 融合框的中心和尺寸按置信度加权平均；yaw先对齐到簇内最高分框的朝向（相差超过90°时翻转180°），
+ * 再对(cos, sin)加权平均求角度，避免±π附近的跳变。
+ * @param boxes 待融合的包围盒（通常为多个模型输出的并集）
+ * @param config 融合参数
+ * @return 融合后的包围盒，按置信度降序排列
+ */
+std::vector<Box> weightedBoxFusion(const std::vector<Box>& boxes,
+                                   const WBFConfig& config = WBFConfig());
+
+} // namespace nms
@@ -0,0 +1,105 @@
+#include "pipeline.h"
+#include "executor.h"
+#include "stats_hooks.h"
+#include <algorithm>
+
+namespace nms {
+
+FramePipeline::FramePipeline(const NMSConfig& nms_config, const AssociationConfig& association_config)
+    : nms_(nms_config), association_config_(association_config) {}
+
+void FramePipeline::reserve(size_t max_boxes, size_t max_tracks) {
+    nms_.reserve(max_boxes);
+    kept_.reserve(max_boxes);
+    rows_.reserve(max_boxes);
+    detections_.reserve(max_boxes);
+    detection_classes_.reserve(max_boxes);
+    tracks_.reserve(max_tracks);
+    track_classes_.reserve(max_tracks);
+    iou_.reserve(max_boxes * max_tracks);
+    result_.matches.reserve(std::min(max_boxes, max_tracks));
+    result_.unmatched_detections.reserve(max_boxes);
+    result_.unmatched_tracks.reserve(max_tracks);
+}
+
+const std::vector<int>& FramePipeline::process(const std::vector<Box>& frame_boxes) {
+    SerialExecutor executor;
+    return process(frame_boxes, executor);
+}
+
+const std::vector<int>& FramePipeline::process(const std::vector<Box>& frame_boxes, Executor& executor) {
+    const std::vector<int>& keep = nms_.process(frame_boxes, executor);
+    kept_.assign(keep.begin(), keep.end());
+    return kept_;
+}
+
+const AssociationResult& FramePipeline::associate(const std::vector<Box>& frame_boxes,
+                                                  const std::vector<Box>& tracks) {
+    SerialExecutor executor;
+    return associate(frame_boxes, tracks, executor);
+}
+
+const AssociationResult& FramePipeline::associate(const std::vector<Box>& frame_boxes,
+                                                  const std::vector<Box>& tracks, Executor& executor) {
+    IOU3D_STAGE_TIMER(Stage::ASSOCIATION);
+    process(frame_boxes, executor);
+
+    // 行按原始索引升序，使结果与associate(保留框, tracks)的顺序一致
+    rows_.assign(kept_.begin(), kept_.end());
+    std::sort(rows_.begin(), rows_.end());
+    detections_.resize(rows_.size());
+    detection_classes_.resize(rows_.size());
+    for (size_t i = 0; i < rows_.size(); ++i) {
+        const Box& box = frame_boxes[rows_[i]];
+        prepareBox(box, detections_[i]);
+        detection_classes_[i] = box.class_id;
+    }
+    tracks_.resize(tracks.size());
+    track_classes_.resize(tracks.size());
+    for (size_t j = 0; j < tracks.size(); ++j) {
+        prepareBox(tracks[j], tracks_[j]);
+        track_classes_[j] = tracks[j].class_id;
+    }
+
+    fillIoU(executor);
+
+    const AssociationConfig& config = association_config_;
+    if (config.method == AssignmentMethod::GREEDY) {
+        greedyAssignment(iou_.data(), detections_.size(), tracks_.size(), config.iou_threshold,
+                         result_, assignment_);
+    } else {
+        hungarianAssignment(iou_.data(), detections_.size(), tracks_.size(), config.iou_threshold,
+                            result_, assignment_);
+    }
+
+    // 行号映射回帧内索引，映射保持单调，因此结果顺序不变
+    for (size_t k = 0; k < result_.matches.size(); ++k) {
+        result_.matches[k].detection = rows_[result_.matches[k].detection];
+    }
+    for (size_t k = 0; k < result_.unmatched_detections.size(); ++k) {
+        result_.unmatched_detections[k] = rows_[result_.unmatched_detections[k]];
+    }
+    return result_;
+}
+
+void FramePipeline::fillIoU(Executor& executor) {
+    const size_t cols = tracks_.size();
+    iou_.resize(detections_.size() * cols);
+    executor.parallelFor(detections_.size(), 16, [this](size_t begin, size_t end) {
+        const size_t cols = tracks_.size();
+        const bool use_3d = association_config_.iou_type == IoUType::IOU_3D;
+        for (size_t i = begin; i < end; ++i) {
+            float* row = iou_.data() + i * cols;
+            for (size_t j = 0; j < cols; ++j) {
+                if (association_config_.class_aware && detection_classes_[i] != track_classes_[j]) {
+                    row[j] = 0.0f;
+                } else {
+                    row[j] = use_3d ? calculateIoU3D(detections_[i], tracks_[j])
+                                    : calculateBEVIoU(detections_[i], tracks_[j]);
+                }
+            }
+        }
+    });
+}
+
+} // namespace nms
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "iou3d.h"
+#include "nms.h"
+#include "association.h"
+
+#include <vector>
+#include <cstddef>
+
+namespace nms {
+
+/**
+ * @brief 逐帧的检测后处理流水线：NMS，随后与轨迹框做数据关联
+ * 持有NMS工作区、关联IoU矩阵和分配算法工作区，所有缓冲区每帧重置、从不释放。
+ * 预热（处理过规模不小于当前帧的帧）之后，process和associate不再分配堆内存。
+ * 关联只支持稠密IoU矩阵，AssociationConfig::sparse被忽略。
+ * 一个流水线对象不能被多个线程同时使用。
+ */
+class FramePipeline {
+public:
+    explicit FramePipeline(const NMSConfig& nms_config = NMSConfig(),
+                           const AssociationConfig& association_config = AssociationConfig());
+
+    void setNMSConfig(const NMSConfig& config) { nms_.setConfig(config); }
+    const NMSConfig& nmsConfig() const { return nms_.config(); }
+    void setAssociationConfig(const AssociationConfig& config) { association_config_ = config; }
+    const AssociationConfig& associationConfig() const { return association_config_; }
+
+    /**
+     * @brief 按预计的每帧最大框数和轨迹数预留缓冲区
+     */
+    void reserve(size_t max_boxes, size_t max_tracks);
+
+    /**
+     * @brief 对一帧执行NMS
+     * @return 保留框在frame_boxes中的索引（按置信度降序），引用在下一次调用之前有效
+     */
+    const std::vector<int>& process(const std::vector<Box>& frame_boxes);
+
+    /**
+     * @brief 对一帧执行NMS（并行版本）
+     */
+    const std::vector<int>& process(const std::vector<Box>& frame_boxes, Executor& executor);
+
+    /**
+     * @brief 对一帧执行NMS，再将保留的框与轨迹框关联
+     * 结果中的检测框索引为frame_boxes中的索引，matches与unmatched_detections按该索引升序
+     * @return 关联结果，引用在下一次调用之前有效
+     */
+    const AssociationResult& associate(const std::vector<Box>& frame_boxes, const std::vector<Box>& tracks);
+
+    /**
+     * @brief 同上，NMS与IoU矩阵由执行器并行计算
+     */
+    const AssociationResult& associate(const std::vector<Box>& frame_boxes, const std::vector<Box>& tracks,
+                                       Executor& executor);
+
+    /**
+     * @brief 最近一次调用保留的框索引（按置信度降序）
+     */
+    const std::vector<int>& kept() const { return kept_; }
+
+private:
+    void fillIoU(Executor& executor);
+
+    NmsWorkspace nms_;
+    AssociationConfig association_config_;
+    AssignmentWorkspace assignment_;
+    std::vector<int> kept_;
+    // 按索引升序排列的保留框及其几何信息，作为IoU矩阵的行
+    std::vector<int> rows_;
+    std::vector<PreparedBox> detections_;
+    std::vector<int> detection_classes_;
+    std::vector<PreparedBox> tracks_;
+    std::vector<int> track_classes_;
+    std::vector<float> iou_;
+    AssociationResult result_;
+};
+
+} // namespace nms
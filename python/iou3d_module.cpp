@@ -0,0 +1,179 @@
+// NumPy绑定，构建在C接口（iou3d_c.h）之上
+// 包围盒数组为(N, K)、K >= 7的float32数组，只要最后一维连续即直接传入底层内存，
+// 前7列依次为center_x, center_y, center_z, length, width, height, yaw；其他dtype或布局会先转换一次
+#include "iou3d_c.h"
+
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+
+#include <stdexcept>
+#include <string>
+
+namespace py = pybind11;
+
+namespace {
+
+/**
+ * @brief 持有iou3d_context的Python对象
+ */
+class Context {
+public:
+    explicit Context(size_t num_threads) : ctx_(nullptr) {
+        check(iou3d_context_create(num_threads, &ctx_));
+    }
+    ~Context() { iou3d_context_destroy(ctx_); }
+
+    Context(const Context&) = delete;
+    Context& operator=(const Context&) = delete;
+
+    iou3d_context* get() const { return ctx_; }
+
+    static void check(int status) {
+        if (status == IOU3D_OK) {
+            return;
+        }
+        if (status == IOU3D_ERROR_INVALID_ARGUMENT || status == IOU3D_ERROR_INVALID_STRIDE) {
+            throw py::value_error(iou3d_status_string(status));
+        }
+        throw std::runtime_error(iou3d_status_string(status));
+    }
+
+private:
+    iou3d_context* ctx_;
+};
+
+/**
+ * @brief 包围盒数组的行视图，array保证底层内存在计算期间有效
+ */
+struct BoxView {
+    py::array array;
+    const float* data;
+    size_t rows;
+    size_t stride;
+};
+
+bool isZeroCopyLayout(const py::array& array) {
+    return array.dtype().is(py::dtype::of<float>()) && array.ndim() == 2 &&
+           array.strides(1) == static_cast<py::ssize_t>(sizeof(float)) &&
+           array.strides(0) > 0 && array.strides(0) % static_cast<py::ssize_t>(sizeof(float)) == 0;
+}
+
+BoxView viewBoxes(const py::array& input, const char* name) {
+    py::array array = input;
+    if (!isZeroCopyLayout(array)) {
+        array = py::array_t<float, py::array::c_style | py::array::forcecast>::ensure(input);
+        if (!array) {
+            throw py::type_error(std::string(name) + " must be convertible to a float32 array");
+        }
+    }
+    if (array.ndim() != 2 || array.shape(1) < IOU3D_BOX_PARAMS) {
+        throw py::value_error(std::string(name) + " must have shape (N, K) with K >= 7");
+    }
+
+    BoxView view;
+    view.array = array;
+    view.data = static_cast<const float*>(array.data());
+    view.rows = static_cast<size_t>(array.shape(0));
+    // 只有一行时numpy的行步长没有意义
+    view.stride = view.rows > 1 ? static_cast<size_t>(array.strides(0)) / sizeof(float)
+                                : static_cast<size_t>(array.shape(1));
+    return view;
+}
+
+iou3d_context* contextOf(const Context* context) {
+    return context ? context->get() : nullptr;
+}
+
+typedef int (*MatrixFunction)(const float*, size_t, size_t, const float*, size_t, size_t, float*, iou3d_context*);
+
+py::array_t<float> matrix(MatrixFunction function, const py::array& boxes1, const py::object& boxes2,
+                          const Context* context) {
+    BoxView view1 = viewBoxes(boxes1, "boxes1");
+    BoxView view2 = boxes2.is_none() ? view1 : viewBoxes(boxes2.cast<py::array>(), "boxes2");
+
+    py::array_t<float> out({static_cast<py::ssize_t>(view1.rows), static_cast<py::ssize_t>(view2.rows)});
+    float* out_data = out.mutable_data();
+    int status;
+    {
+        py::gil_scoped_release release;
+        status = function(view1.data, view1.rows, view1.stride, view2.data, view2.rows, view2.stride,
+                          out_data, contextOf(context));
+    }
+    Context::check(status);
+    return out;
+}
+
+py::array nms(const py::array& boxes, const py::array& scores, const py::object& class_ids,
+              float iou_threshold, float score_threshold, bool use_3d, bool class_aware,
+              int pre_max_size, int post_max_size, bool use_distance_iou, const Context* context) {
+    BoxView view = viewBoxes(boxes, "boxes");
+    // 置信度和类别是一维的小数组，布局不符时转换一次
+    py::array_t<float, py::array::c_style | py::array::forcecast> score_array(scores);
+    if (score_array.ndim() != 1 || static_cast<size_t>(score_array.shape(0)) != view.rows) {
+        throw py::value_error("scores must have shape (N,)");
+    }
+    py::array_t<int, py::array::c_style | py::array::forcecast> class_array;
+    if (!class_ids.is_none()) {
+        class_array = py::array_t<int, py::array::c_style | py::array::forcecast>(class_ids);
+        if (class_array.ndim() != 1 || static_cast<size_t>(class_array.shape(0)) != view.rows) {
+            throw py::value_error("class_ids must have shape (N,)");
+        }
+    }
+
+    iou3d_nms_params params;
+    iou3d_nms_params_init(&params);
+    params.iou_threshold = iou_threshold;
+    params.score_threshold = score_threshold;
+    params.use_3d = use_3d;
+    params.class_aware = class_aware;
+    params.pre_max_size = pre_max_size;
+    params.post_max_size = post_max_size;
+    params.use_distance_iou = use_distance_iou;
+
+    py::array_t<int> keep(static_cast<py::ssize_t>(view.rows));
+    const float* score_data = score_array.data();
+    const int* class_data = class_ids.is_none() ? nullptr : class_array.data();
+    int* keep_data = keep.mutable_data();
+    size_t num_keep = 0;
+    int status;
+    {
+        py::gil_scoped_release release;
+        status = iou3d_nms(view.data, view.rows, view.stride, score_data, class_data, &params,
+                           keep_data, &num_keep, contextOf(context));
+    }
+    Context::check(status);
+
+    // 返回前num_keep个元素的视图，不拷贝
+    return py::array(keep[py::slice(0, static_cast<py::ssize_t>(num_keep), 1)]);
+}
+
+} // namespace
+
+PYBIND11_MODULE(iou3d, m) {
+    m.doc() = "Rotated 3D / BEV IoU and NMS over (N, 7+) float32 arrays";
+
+    py::class_<Context>(m, "Context")
+        .def(py::init<size_t>(), py::arg("num_threads") = 0,
+             "Thread pool and reusable buffers; not safe for concurrent use");
+
+    m.def("bev_iou_matrix",
+          [](const py::array& boxes1, const py::object& boxes2, const Context* context) {
+              return matrix(iou3d_bev_iou_matrix, boxes1, boxes2, context);
+          },
+          py::arg("boxes1"), py::arg("boxes2") = py::none(), py::arg("context") = nullptr,
+          "(N, M) BEV IoU matrix; boxes2 defaults to boxes1");
+
+    m.def("iou3d_matrix",
+          [](const py::array& boxes1, const py::object& boxes2, const Context* context) {
+              return matrix(iou3d_iou3d_matrix, boxes1, boxes2, context);
+          },
+          py::arg("boxes1"), py::arg("boxes2") = py::none(), py::arg("context") = nullptr,
+          "(N, M) 3D IoU matrix; boxes2 defaults to boxes1");
+
+    m.def("nms", &nms,
+          py::arg("boxes"), py::arg("scores"), py::arg("class_ids") = py::none(),
+          py::arg("iou_threshold") = 0.5f, py::arg("score_threshold") = 0.0f, py::arg("use_3d") = false,
+          py::arg("class_aware") = true, py::arg("pre_max_size") = -1, py::arg("post_max_size") = -1,
+          py::arg("use_distance_iou") = false, py::arg("context") = nullptr,
+          "Indices of kept boxes, sorted by descending score");
+}
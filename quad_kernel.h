@@ -0,0 +1,36 @@
+#pragma once
+
+// 内部头文件：四边形交集内核的顶点级接口，不对外安装
+// 供需要交集顶点本身（而不仅是面积）的模块使用，例如IoU损失的解析梯度
+
+#include "iou3d.h"
+
+namespace nms {
+namespace detail {
+
+/**
+ * @brief 交集多边形顶点的来源
+ */
+struct VertexSource {
+    enum Kind {
+        CORNER1,       // quad1的角点index1
+        CORNER2,       // quad2的角点index2
+        EDGE_CROSSING  // quad1的边index1（角点index1到index1+1）与quad2的边index2的交点
+    };
+    Kind kind;
+    int index1;
+    int index2;
+};
+
+/**
+ * @brief 计算两个逆时针凸四边形的交集多边形，与calculateQuadIntersectionArea使用同一内核
+ * @param points 输出的交集顶点，按逆时针排列
+ * @param sources 每个顶点的来源
+ * @return 顶点数，交集为空时返回0
+ */
+template <typename T>
+int quadIntersectionPolygon(const BasicPoint2D<T> quad1[4], const BasicPoint2D<T> quad2[4],
+                            BasicPoint2D<T> points[24], VertexSource sources[24]);
+
+} // namespace detail
+} // namespace nms
@@ -0,0 +1,266 @@
+#pragma once
+
+// 内部头文件：只由各指令集的翻译单元（simd_kernels_*.cpp）包含，
+// 包含前定义的IOU3D_SIMD_TARGET_*决定生成哪个后端的内核与内核表
+
+#include "simd_math.h"
+#include "cpu_dispatch.h"
+
+namespace nms {
+namespace IOU3D_SIMD_NAMESPACE {
+
+namespace {
+
+/**
+ * @brief 计算一个寄存器宽度的包围盒顶点
+ * 旋转公式与boxToBEVPolygon相同：x' = x*cos + z*sin, z' = -x*sin + z*cos
+ */
+inline void cornersKernel(const float* center_x, const float* center_z,
+                          const float* length, const float* width, const float* yaw,
+                          float* const corners_x[4], float* const corners_z[4], size_t offset) {
+    VecF sin_yaw, cos_yaw;
+    sincos(load(yaw + offset), sin_yaw, cos_yaw);
+
+    const VecF half = set1(0.5f);
+    VecF half_length = mul(load(length + offset), half);
+    VecF half_width = mul(load(width + offset), half);
+    VecF cx = load(center_x + offset);
+    VecF cz = load(center_z + offset);
+
+    VecF lc = mul(half_length, cos_yaw);
+    VecF ls = mul(half_length, sin_yaw);
+    VecF wc = mul(half_width, cos_yaw);
+    VecF ws = mul(half_width, sin_yaw);
+
+    // 右前、左前、左后、右后
+    store(corners_x[0] + offset, add(add(lc, ws), cx));
+    store(corners_z[0] + offset, add(sub(wc, ls), cz));
+    store(corners_x[1] + offset, add(sub(ws, lc), cx));
+    store(corners_z[1] + offset, add(add(ls, wc), cz));
+    store(corners_x[2] + offset, sub(cx, add(lc, ws)));
+    store(corners_z[2] + offset, add(sub(ls, wc), cz));
+    store(corners_x[3] + offset, add(sub(lc, ws), cx));
+    store(corners_z[3] + offset, sub(cz, add(ls, wc)));
+}
+
+void bevCorners(const float* center_x, const float* center_z,
+                const float* length, const float* width, const float* yaw,
+                size_t n, float* const corners_x[4], float* const corners_z[4]) {
+    const size_t width_simd = static_cast<size_t>(kWidth);
+
+    size_t i = 0;
+    for (; i + width_simd <= n; i += width_simd) {
+        cornersKernel(center_x, center_z, length, width, yaw, corners_x, corners_z, i);
+    }
+
+    if (i < n) {
+        // 尾部不足一个寄存器宽度，拷贝到临时缓冲区后用同一内核处理，保证结果一致
+        float in[5][kWidth] = {};
+        float out_x[4][kWidth];
+        float out_z[4][kWidth];
+        size_t remaining = n - i;
+        for (size_t t = 0; t < remaining; ++t) {
+            in[0][t] = center_x[i + t];
+            in[1][t] = center_z[i + t];
+            in[2][t] = length[i + t];
+            in[3][t] = width[i + t];
+            in[4][t] = yaw[i + t];
+        }
+
+        float* tail_x[4] = {out_x[0], out_x[1], out_x[2], out_x[3]};
+        float* tail_z[4] = {out_z[0], out_z[1], out_z[2], out_z[3]};
+        cornersKernel(in[0], in[1], in[2], in[3], in[4], tail_x, tail_z, 0);
+
+        for (int k = 0; k < 4; ++k) {
+            for (size_t t = 0; t < remaining; ++t) {
+                corners_x[k][i + t] = out_x[k][t];
+                corners_z[k][i + t] = out_z[k][t];
+            }
+        }
+    }
+}
+
+/**
+ * @brief 用一个半平面裁剪边段a + t*(b - a)的参数区间[t0, t1]
+ * s0、s1为两个端点到半平面边界的有向距离（乘以边长），非负为内侧。
+ * 两个端点都在容差内时视为与边界共线，此时不裁剪，keep_on_line为假的通道整段丢弃。
+ */
+inline void clipToHalfPlane(VecF s0, VecF s1, VecF tolerance, MaskF keep_on_line, VecF& t0, VecF& t1) {
+    const VecF zero = set1(0.0f);
+    const VecF one = set1(1.0f);
+    MaskF on_line = maskAnd(lessEqual(abs(s0), tolerance), lessEqual(abs(s1), tolerance));
+    MaskF in0 = lessEqual(zero, s0);
+    MaskF in1 = lessEqual(zero, s1);
+    MaskF out0 = lessThan(s0, zero);
+    MaskF out1 = lessThan(s1, zero);
+    // 只在恰好一个端点在内侧的通道使用，其余通道的值被丢弃
+    VecF crossing = div(s0, sub(s0, s1));
+
+    MaskF leaving = maskAndNot(maskAnd(in0, out1), on_line);
+    MaskF entering = maskAndNot(maskAnd(out0, in1), on_line);
+    MaskF dropped = maskOr(maskAndNot(maskAnd(out0, out1), on_line), maskAndNot(on_line, keep_on_line));
+
+    t1 = select(leaving, min(t1, crossing), t1);
+    t0 = select(entering, max(t0, crossing), t0);
+    t0 = select(dropped, one, t0);
+    t1 = select(dropped, zero, t1);
+}
+
+/**
+ * @brief 裁剪后边段两端点的叉积（格林公式中的两倍面积贡献），空区间为0
+ */
+inline VecF edgeContribution(VecF ax, VecF az, VecF ex, VecF ez, VecF t0, VecF t1) {
+    VecF x0 = add(ax, mul(t0, ex));
+    VecF z0 = add(az, mul(t0, ez));
+    VecF x1 = add(ax, mul(t1, ex));
+    VecF z1 = add(az, mul(t1, ez));
+    return select(lessThan(t0, t1), sub(mul(x0, z1), mul(z0, x1)), set1(0.0f));
+}
+
+/**
+ * @brief 一个寄存器宽度的候选框与参考框的BEV IoU
+ * 每个通道一个候选框，所有通道执行相同的指令。交集面积由格林公式得到：凸多边形交集的边界
+ * 由候选框在参考框内的边段和参考框在候选框内的边段组成，每条边用Liang-Barsky方法对另一个
+ * 四边形的4个半平面裁剪，不需要像Sutherland-Hodgman那样按通道维护不同长度的顶点列表。
+ * 两条边共线时，同向的只计入参考框的边，反向的（两框只在边上接触）都不计入。
+ * 包围矩形都不相交的寄存器直接输出0。
+ */
+inline void oneToManyKernel(const detail::BEVReference& reference, const float* center_x, const float* center_z,
+                            const float* length, const float* width, const float* yaw,
+                            float* out, size_t offset) {
+    const VecF zero = set1(0.0f);
+    const VecF one = set1(1.0f);
+    const VecF half = set1(0.5f);
+
+    VecF sin_yaw, cos_yaw;
+    sincos(load(yaw + offset), sin_yaw, cos_yaw);
+    VecF box_length = load(length + offset);
+    VecF box_width = load(width + offset);
+    VecF half_length = mul(box_length, half);
+    VecF half_width = mul(box_width, half);
+    VecF cx = sub(load(center_x + offset), set1(reference.origin_x));
+    VecF cz = sub(load(center_z + offset), set1(reference.origin_z));
+
+    VecF lc = mul(half_length, cos_yaw);
+    VecF ls = mul(half_length, sin_yaw);
+    VecF wc = mul(half_width, cos_yaw);
+    VecF ws = mul(half_width, sin_yaw);
+
+    // 与cornersKernel相同的顶点顺序：右前、左前、左后、右后
+    VecF qx[5];
+    VecF qz[5];
+    qx[0] = add(add(lc, ws), cx);
+    qz[0] = add(sub(wc, ls), cz);
+    qx[1] = add(sub(ws, lc), cx);
+    qz[1] = add(add(ls, wc), cz);
+    qx[2] = sub(cx, add(lc, ws));
+    qz[2] = add(sub(ls, wc), cz);
+    qx[3] = add(sub(lc, ws), cx);
+    qz[3] = sub(cz, add(ls, wc));
+    qx[4] = qx[0];
+    qz[4] = qz[0];
+
+    VecF min_x = min(min(qx[0], qx[1]), min(qx[2], qx[3]));
+    VecF max_x = max(max(qx[0], qx[1]), max(qx[2], qx[3]));
+    VecF min_z = min(min(qz[0], qz[1]), min(qz[2], qz[3]));
+    VecF max_z = max(max(qz[0], qz[1]), max(qz[2], qz[3]));
+    MaskF overlap = maskAnd(maskAnd(lessThan(min_x, set1(reference.max_x)), lessThan(set1(reference.min_x), max_x)),
+                            maskAnd(lessThan(min_z, set1(reference.max_z)), lessThan(set1(reference.min_z), max_z)));
+    if (!anyTrue(overlap)) {
+        store(out + offset, zero);
+        return;
+    }
+
+    VecF ex[4];
+    VecF ez[4];
+    VecF tolerance[4];
+    for (int k = 0; k < 4; ++k) {
+        ex[k] = sub(qx[k + 1], qx[k]);
+        ez[k] = sub(qz[k + 1], qz[k]);
+        tolerance[k] = mul(set1(1e-5f), add(mul(ex[k], ex[k]), mul(ez[k], ez[k])));
+    }
+
+    const MaskF never = lessThan(one, zero);
+    VecF twice_area = zero;
+
+    // 候选框的边对参考框的半平面裁剪；参考框的边界对所有通道相同
+    for (int k = 0; k < 4; ++k) {
+        VecF t0 = zero;
+        VecF t1 = one;
+        for (int j = 0; j < 4; ++j) {
+            VecF rx = set1(reference.corner_x[j]);
+            VecF rz = set1(reference.corner_z[j]);
+            VecF rex = set1(reference.edge_x[j]);
+            VecF rez = set1(reference.edge_z[j]);
+            VecF s0 = sub(mul(rex, sub(qz[k], rz)), mul(rez, sub(qx[k], rx)));
+            VecF s1 = sub(mul(rex, sub(qz[k + 1], rz)), mul(rez, sub(qx[k + 1], rx)));
+            clipToHalfPlane(s0, s1, set1(reference.collinear_tolerance[j]), never, t0, t1);
+        }
+        twice_area = add(twice_area, edgeContribution(qx[k], qz[k], ex[k], ez[k], t0, t1));
+    }
+
+    // 参考框的边对各通道候选框的半平面裁剪
+    for (int j = 0; j < 4; ++j) {
+        VecF ax = set1(reference.corner_x[j]);
+        VecF az = set1(reference.corner_z[j]);
+        VecF bx = set1(reference.corner_x[(j + 1) & 3]);
+        VecF bz = set1(reference.corner_z[(j + 1) & 3]);
+        VecF rex = set1(reference.edge_x[j]);
+        VecF rez = set1(reference.edge_z[j]);
+        VecF t0 = zero;
+        VecF t1 = one;
+        for (int k = 0; k < 4; ++k) {
+            VecF s0 = sub(mul(ex[k], sub(az, qz[k])), mul(ez[k], sub(ax, qx[k])));
+            VecF s1 = sub(mul(ex[k], sub(bz, qz[k])), mul(ez[k], sub(bx, qx[k])));
+            MaskF same_direction = lessThan(zero, add(mul(rex, ex[k]), mul(rez, ez[k])));
+            clipToHalfPlane(s0, s1, tolerance[k], same_direction, t0, t1);
+        }
+        twice_area = add(twice_area, edgeContribution(ax, az, rex, rez, t0, t1));
+    }
+
+    VecF intersection = max(mul(twice_area, half), zero);
+    VecF box_area = abs(mul(box_length, box_width));
+    VecF area_union = sub(add(set1(reference.area), box_area), intersection);
+    VecF iou = select(lessThan(area_union, set1(1e-10f)), zero, div(intersection, area_union));
+    store(out + offset, select(overlap, iou, zero));
+}
+
+void bevIoUOneToMany(const detail::BEVReference& reference, const float* center_x, const float* center_z,
+                     const float* length, const float* width, const float* yaw,
+                     size_t n, float* out) {
+    const size_t width_simd = static_cast<size_t>(kWidth);
+
+    size_t i = 0;
+    for (; i + width_simd <= n; i += width_simd) {
+        oneToManyKernel(reference, center_x, center_z, length, width, yaw, out, i);
+    }
+
+    if (i < n) {
+        // 尾部补零长宽的框（IoU为0）后用同一内核处理
+        float in[5][kWidth] = {};
+        float tail[kWidth];
+        size_t remaining = n - i;
+        for (size_t t = 0; t < remaining; ++t) {
+            in[0][t] = center_x[i + t];
+            in[1][t] = center_z[i + t];
+            in[2][t] = length[i + t];
+            in[3][t] = width[i + t];
+            in[4][t] = yaw[i + t];
+        }
+        oneToManyKernel(reference, in[0], in[1], in[2], in[3], in[4], tail, 0);
+        for (size_t t = 0; t < remaining; ++t) {
+            out[i + t] = tail[t];
+        }
+    }
+}
+
+const detail::KernelTable kTable = {backendName(), bevCorners, bevIoUOneToMany};
+
+} // namespace
+
+const detail::KernelTable& kernelTable() {
+    return kTable;
+}
+
+} // namespace IOU3D_SIMD_NAMESPACE
+} // namespace nms
@@ -0,0 +1,3 @@
+// 以-mavx2编译，只在CPU支持AVX2时被选中
+#define IOU3D_SIMD_TARGET_AVX2 1
+#include "simd_kernels.h"
@@ -0,0 +1,3 @@
+// 以-mavx512f编译，只在CPU支持AVX-512F时被选中
+#define IOU3D_SIMD_TARGET_AVX512 1
+#include "simd_kernels.h"
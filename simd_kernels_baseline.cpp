@@ -0,0 +1,8 @@
+// 默认编译选项下可用的基线后端：x86-64为SSE2，ARM为NEON；其他平台只有标量后端
+#if defined(__SSE2__) || defined(_M_X64)
+#define IOU3D_SIMD_TARGET_SSE2 1
+#include "simd_kernels.h"
+#elif defined(__ARM_NEON)
+#define IOU3D_SIMD_TARGET_NEON 1
+#include "simd_kernels.h"
+#endif
@@ -0,0 +1,3 @@
+// 标量后端，所有平台都会编译，作为分发的兜底
+#define IOU3D_SIMD_TARGET_SCALAR 1
+#include "simd_kernels.h"
@@ -0,0 +1,3 @@
+// 以-msse4.1编译，只在CPU支持SSE4.1时被选中
+#define IOU3D_SIMD_TARGET_SSE41 1
+#include "simd_kernels.h"
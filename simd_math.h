@@ -0,0 +1,312 @@
+#pragma once
+
+// 内部头文件：SIMD向量抽象层，不对外安装
+// 包含前定义IOU3D_SIMD_TARGET_{AVX512,AVX2,SSE41,SSE2,NEON,SCALAR}之一可指定后端，
+// 对应的翻译单元需要以相应的指令集选项编译（见simd_kernels.h）；未指定时按编译目标选择
+// AVX2 (8路) / SSE2 (4路) / NEON (4路) / 标量 (1路)。
+// 每个后端位于独立的命名空间simd_<后端>中，不同指令集的翻译单元可以链接在一起；
+// nms::simd是当前后端命名空间的别名。
+
+#if !defined(IOU3D_SIMD_TARGET_AVX512) && !defined(IOU3D_SIMD_TARGET_AVX2) && \
+    !defined(IOU3D_SIMD_TARGET_SSE41) && !defined(IOU3D_SIMD_TARGET_SSE2) && \
+    !defined(IOU3D_SIMD_TARGET_NEON) && !defined(IOU3D_SIMD_TARGET_SCALAR)
+#if defined(__AVX2__)
+#define IOU3D_SIMD_TARGET_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#define IOU3D_SIMD_TARGET_SSE2 1
+#elif defined(__ARM_NEON)
+#define IOU3D_SIMD_TARGET_NEON 1
+#else
+#define IOU3D_SIMD_TARGET_SCALAR 1
+#endif
+#endif
+
+#if defined(IOU3D_SIMD_TARGET_AVX512)
+#if !defined(__AVX512F__)
+#error "IOU3D_SIMD_TARGET_AVX512 requires compiling with -mavx512f"
+#endif
+#include <immintrin.h>
+#define IOU3D_SIMD_AVX512 1
+#define IOU3D_SIMD_NAMESPACE simd_avx512
+#elif defined(IOU3D_SIMD_TARGET_AVX2)
+#if !defined(__AVX2__)
+#error "IOU3D_SIMD_TARGET_AVX2 requires compiling with -mavx2"
+#endif
+#include <immintrin.h>
+#define IOU3D_SIMD_AVX2 1
+#define IOU3D_SIMD_NAMESPACE simd_avx2
+#elif defined(IOU3D_SIMD_TARGET_SSE41)
+#if !defined(__SSE4_1__)
+#error "IOU3D_SIMD_TARGET_SSE41 requires compiling with -msse4.1"
+#endif
+#include <smmintrin.h>
+#define IOU3D_SIMD_SSE41 1
+#define IOU3D_SIMD_NAMESPACE simd_sse41
+#elif defined(IOU3D_SIMD_TARGET_SSE2)
+#include <emmintrin.h>
+#define IOU3D_SIMD_SSE2 1
+#define IOU3D_SIMD_NAMESPACE simd_sse2
+#elif defined(IOU3D_SIMD_TARGET_NEON)
+#include <arm_neon.h>
+#define IOU3D_SIMD_NEON 1
+#define IOU3D_SIMD_NAMESPACE simd_neon
+#else
+#define IOU3D_SIMD_SCALAR 1
+#define IOU3D_SIMD_NAMESPACE simd_scalar
+#endif
+
+namespace nms {
+namespace IOU3D_SIMD_NAMESPACE {
+
+#if defined(IOU3D_SIMD_AVX512)
+
+// 不使用以_mm512_undefined_ps()为源操作数的intrinsic（_mm512_roundscale_ps、_mm512_min_ps等），
+// gcc 12对其误报-Wuninitialized；改用全掩码的maskz版本或比较加混合
+const int kWidth = 16;
+inline const char* backendName() { return "avx512"; }
+
+struct VecF { __m512 v; };
+struct MaskF { __mmask16 v; };
+
+inline VecF set1(float a) { VecF r = {_mm512_set1_ps(a)}; return r; }
+inline VecF load(const float* p) { VecF r = {_mm512_loadu_ps(p)}; return r; }
+inline void store(float* p, VecF a) { _mm512_storeu_ps(p, a.v); }
+inline VecF add(VecF a, VecF b) { VecF r = {_mm512_add_ps(a.v, b.v)}; return r; }
+inline VecF sub(VecF a, VecF b) { VecF r = {_mm512_sub_ps(a.v, b.v)}; return r; }
+inline VecF mul(VecF a, VecF b) { VecF r = {_mm512_mul_ps(a.v, b.v)}; return r; }
+inline VecF div(VecF a, VecF b) { VecF r = {_mm512_div_ps(a.v, b.v)}; return r; }
+// 与_mm_min_ps/_mm_max_ps语义相同
+inline VecF min(VecF a, VecF b) { VecF r = {_mm512_mask_blend_ps(_mm512_cmp_ps_mask(a.v, b.v, _CMP_LT_OQ), b.v, a.v)}; return r; }
+inline VecF max(VecF a, VecF b) { VecF r = {_mm512_mask_blend_ps(_mm512_cmp_ps_mask(b.v, a.v, _CMP_LT_OQ), b.v, a.v)}; return r; }
+inline VecF truncate(VecF a) {
+    VecF r = {_mm512_maskz_roundscale_ps(static_cast<__mmask16>(0xFFFF), a.v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC)};
+    return r;
+}
+inline MaskF lessThan(VecF a, VecF b) { MaskF r = {_mm512_cmp_ps_mask(a.v, b.v, _CMP_LT_OQ)}; return r; }
+inline MaskF equal(VecF a, VecF b) { MaskF r = {_mm512_cmp_ps_mask(a.v, b.v, _CMP_EQ_OQ)}; return r; }
+inline MaskF lessEqual(VecF a, VecF b) { MaskF r = {_mm512_cmp_ps_mask(a.v, b.v, _CMP_LE_OQ)}; return r; }
+inline MaskF maskAnd(MaskF a, MaskF b) { MaskF r = {static_cast<__mmask16>(a.v & b.v)}; return r; }
+inline MaskF maskAndNot(MaskF a, MaskF b) { MaskF r = {static_cast<__mmask16>(a.v & ~b.v)}; return r; }
+inline bool anyTrue(MaskF m) { return m.v != 0; }
+inline MaskF maskOr(MaskF a, MaskF b) { MaskF r = {static_cast<__mmask16>(a.v | b.v)}; return r; }
+inline VecF select(MaskF m, VecF a, VecF b) { VecF r = {_mm512_mask_blend_ps(m.v, b.v, a.v)}; return r; }
+
+#elif defined(IOU3D_SIMD_AVX2)
+
+const int kWidth = 8;
+inline const char* backendName() { return "avx2"; }
+
+struct VecF { __m256 v; };
+struct MaskF { __m256 v; };
+
+inline VecF set1(float a) { VecF r = {_mm256_set1_ps(a)}; return r; }
+inline VecF load(const float* p) { VecF r = {_mm256_loadu_ps(p)}; return r; }
+inline void store(float* p, VecF a) { _mm256_storeu_ps(p, a.v); }
+inline VecF add(VecF a, VecF b) { VecF r = {_mm256_add_ps(a.v, b.v)}; return r; }
+inline VecF sub(VecF a, VecF b) { VecF r = {_mm256_sub_ps(a.v, b.v)}; return r; }
+inline VecF mul(VecF a, VecF b) { VecF r = {_mm256_mul_ps(a.v, b.v)}; return r; }
+inline VecF div(VecF a, VecF b) { VecF r = {_mm256_div_ps(a.v, b.v)}; return r; }
+inline VecF min(VecF a, VecF b) { VecF r = {_mm256_min_ps(a.v, b.v)}; return r; }
+inline VecF max(VecF a, VecF b) { VecF r = {_mm256_max_ps(a.v, b.v)}; return r; }
+inline VecF truncate(VecF a) { VecF r = {_mm256_round_ps(a.v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC)}; return r; }
+inline MaskF lessThan(VecF a, VecF b) { MaskF r = {_mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ)}; return r; }
+inline MaskF equal(VecF a, VecF b) { MaskF r = {_mm256_cmp_ps(a.v, b.v, _CMP_EQ_OQ)}; return r; }
+inline MaskF lessEqual(VecF a, VecF b) { MaskF r = {_mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ)}; return r; }
+inline MaskF maskAnd(MaskF a, MaskF b) { MaskF r = {_mm256_and_ps(a.v, b.v)}; return r; }
+inline MaskF maskAndNot(MaskF a, MaskF b) { MaskF r = {_mm256_andnot_ps(b.v, a.v)}; return r; }
+inline bool anyTrue(MaskF m) { return _mm256_movemask_ps(m.v) != 0; }
+inline MaskF maskOr(MaskF a, MaskF b) { MaskF r = {_mm256_or_ps(a.v, b.v)}; return r; }
+inline VecF select(MaskF m, VecF a, VecF b) { VecF r = {_mm256_blendv_ps(b.v, a.v, m.v)}; return r; }
+
+#elif defined(IOU3D_SIMD_SSE41)
+
+const int kWidth = 4;
+inline const char* backendName() { return "sse41"; }
+
+struct VecF { __m128 v; };
+struct MaskF { __m128 v; };
+
+inline VecF set1(float a) { VecF r = {_mm_set1_ps(a)}; return r; }
+inline VecF load(const float* p) { VecF r = {_mm_loadu_ps(p)}; return r; }
+inline void store(float* p, VecF a) { _mm_storeu_ps(p, a.v); }
+inline VecF add(VecF a, VecF b) { VecF r = {_mm_add_ps(a.v, b.v)}; return r; }
+inline VecF sub(VecF a, VecF b) { VecF r = {_mm_sub_ps(a.v, b.v)}; return r; }
+inline VecF mul(VecF a, VecF b) { VecF r = {_mm_mul_ps(a.v, b.v)}; return r; }
+inline VecF div(VecF a, VecF b) { VecF r = {_mm_div_ps(a.v, b.v)}; return r; }
+inline VecF min(VecF a, VecF b) { VecF r = {_mm_min_ps(a.v, b.v)}; return r; }
+inline VecF max(VecF a, VecF b) { VecF r = {_mm_max_ps(a.v, b.v)}; return r; }
+inline VecF truncate(VecF a) { VecF r = {_mm_round_ps(a.v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC)}; return r; }
+inline MaskF lessThan(VecF a, VecF b) { MaskF r = {_mm_cmplt_ps(a.v, b.v)}; return r; }
+inline MaskF equal(VecF a, VecF b) { MaskF r = {_mm_cmpeq_ps(a.v, b.v)}; return r; }
+inline MaskF lessEqual(VecF a, VecF b) { MaskF r = {_mm_cmple_ps(a.v, b.v)}; return r; }
+inline MaskF maskAnd(MaskF a, MaskF b) { MaskF r = {_mm_and_ps(a.v, b.v)}; return r; }
+inline MaskF maskAndNot(MaskF a, MaskF b) { MaskF r = {_mm_andnot_ps(b.v, a.v)}; return r; }
+inline bool anyTrue(MaskF m) { return _mm_movemask_ps(m.v) != 0; }
+inline MaskF maskOr(MaskF a, MaskF b) { MaskF r = {_mm_or_ps(a.v, b.v)}; return r; }
+inline VecF select(MaskF m, VecF a, VecF b) { VecF r = {_mm_blendv_ps(b.v, a.v, m.v)}; return r; }
+
+#elif defined(IOU3D_SIMD_SSE2)
+
+const int kWidth = 4;
+inline const char* backendName() { return "sse2"; }
+
+struct VecF { __m128 v; };
+struct MaskF { __m128 v; };
+
+inline VecF set1(float a) { VecF r = {_mm_set1_ps(a)}; return r; }
+inline VecF load(const float* p) { VecF r = {_mm_loadu_ps(p)}; return r; }
+inline void store(float* p, VecF a) { _mm_storeu_ps(p, a.v); }
+inline VecF add(VecF a, VecF b) { VecF r = {_mm_add_ps(a.v, b.v)}; return r; }
+inline VecF sub(VecF a, VecF b) { VecF r = {_mm_sub_ps(a.v, b.v)}; return r; }
+inline VecF mul(VecF a, VecF b) { VecF r = {_mm_mul_ps(a.v, b.v)}; return r; }
+inline VecF div(VecF a, VecF b) { VecF r = {_mm_div_ps(a.v, b.v)}; return r; }
+inline VecF min(VecF a, VecF b) { VecF r = {_mm_min_ps(a.v, b.v)}; return r; }
+inline VecF max(VecF a, VecF b) { VecF r = {_mm_max_ps(a.v, b.v)}; return r; }
+// 仅用于|a| < 2^31的非负输入
+inline VecF truncate(VecF a) { VecF r = {_mm_cvtepi32_ps(_mm_cvttps_epi32(a.v))}; return r; }
+inline MaskF lessThan(VecF a, VecF b) { MaskF r = {_mm_cmplt_ps(a.v, b.v)}; return r; }
+inline MaskF equal(VecF a, VecF b) { MaskF r = {_mm_cmpeq_ps(a.v, b.v)}; return r; }
+inline MaskF lessEqual(VecF a, VecF b) { MaskF r = {_mm_cmple_ps(a.v, b.v)}; return r; }
+inline MaskF maskAnd(MaskF a, MaskF b) { MaskF r = {_mm_and_ps(a.v, b.v)}; return r; }
+inline MaskF maskAndNot(MaskF a, MaskF b) { MaskF r = {_mm_andnot_ps(b.v, a.v)}; return r; }
+inline bool anyTrue(MaskF m) { return _mm_movemask_ps(m.v) != 0; }
+inline MaskF maskOr(MaskF a, MaskF b) { MaskF r = {_mm_or_ps(a.v, b.v)}; return r; }
+inline VecF select(MaskF m, VecF a, VecF b) {
+    VecF r = {_mm_or_ps(_mm_and_ps(m.v, a.v), _mm_andnot_ps(m.v, b.v))};
+    return r;
+}
+
+#elif defined(IOU3D_SIMD_NEON)
+
+const int kWidth = 4;
+inline const char* backendName() { return "neon"; }
+
+struct VecF { float32x4_t v; };
+struct MaskF { uint32x4_t v; };
+
+inline VecF set1(float a) { VecF r = {vdupq_n_f32(a)}; return r; }
+inline VecF load(const float* p) { VecF r = {vld1q_f32(p)}; return r; }
+inline void store(float* p, VecF a) { vst1q_f32(p, a.v); }
+inline VecF add(VecF a, VecF b) { VecF r = {vaddq_f32(a.v, b.v)}; return r; }
+inline VecF sub(VecF a, VecF b) { VecF r = {vsubq_f32(a.v, b.v)}; return r; }
+inline VecF mul(VecF a, VecF b) { VecF r = {vmulq_f32(a.v, b.v)}; return r; }
+#if defined(__aarch64__)
+inline VecF div(VecF a, VecF b) { VecF r = {vdivq_f32(a.v, b.v)}; return r; }
+#else
+// ARMv7没有向量除法，逐通道计算以保持IEEE结果
+inline VecF div(VecF a, VecF b) {
+    float x[4], y[4];
+    vst1q_f32(x, a.v);
+    vst1q_f32(y, b.v);
+    for (int i = 0; i < 4; ++i) {
+        x[i] /= y[i];
+    }
+    VecF r = {vld1q_f32(x)};
+    return r;
+}
+#endif
+inline VecF min(VecF a, VecF b) { VecF r = {vminq_f32(a.v, b.v)}; return r; }
+inline VecF max(VecF a, VecF b) { VecF r = {vmaxq_f32(a.v, b.v)}; return r; }
+inline VecF truncate(VecF a) { VecF r = {vcvtq_f32_s32(vcvtq_s32_f32(a.v))}; return r; }
+inline MaskF lessThan(VecF a, VecF b) { MaskF r = {vcltq_f32(a.v, b.v)}; return r; }
+inline MaskF equal(VecF a, VecF b) { MaskF r = {vceqq_f32(a.v, b.v)}; return r; }
+inline MaskF lessEqual(VecF a, VecF b) { MaskF r = {vcleq_f32(a.v, b.v)}; return r; }
+inline MaskF maskAnd(MaskF a, MaskF b) { MaskF r = {vandq_u32(a.v, b.v)}; return r; }
+inline MaskF maskAndNot(MaskF a, MaskF b) { MaskF r = {vbicq_u32(a.v, b.v)}; return r; }
+inline bool anyTrue(MaskF m) {
+    uint32x2_t folded = vorr_u32(vget_low_u32(m.v), vget_high_u32(m.v));
+    return (vget_lane_u32(folded, 0) | vget_lane_u32(folded, 1)) != 0;
+}
+inline MaskF maskOr(MaskF a, MaskF b) { MaskF r = {vorrq_u32(a.v, b.v)}; return r; }
+inline VecF select(MaskF m, VecF a, VecF b) { VecF r = {vbslq_f32(m.v, a.v, b.v)}; return r; }
+
+#else
+
+const int kWidth = 1;
+inline const char* backendName() { return "scalar"; }
+
+struct VecF { float v; };
+struct MaskF { bool v; };
+
+inline VecF set1(float a) { VecF r = {a}; return r; }
+inline VecF load(const float* p) { VecF r = {*p}; return r; }
+inline void store(float* p, VecF a) { *p = a.v; }
+inline VecF add(VecF a, VecF b) { VecF r = {a.v + b.v}; return r; }
+inline VecF sub(VecF a, VecF b) { VecF r = {a.v - b.v}; return r; }
+inline VecF mul(VecF a, VecF b) { VecF r = {a.v * b.v}; return r; }
+inline VecF div(VecF a, VecF b) { VecF r = {a.v / b.v}; return r; }
+// 与x86的min/max一致：不满足比较时返回第二个操作数
+inline VecF min(VecF a, VecF b) { return a.v < b.v ? a : b; }
+inline VecF max(VecF a, VecF b) { return a.v > b.v ? a : b; }
+inline VecF truncate(VecF a) { VecF r = {static_cast<float>(static_cast<int>(a.v))}; return r; }
+inline MaskF lessThan(VecF a, VecF b) { MaskF r = {a.v < b.v}; return r; }
+inline MaskF equal(VecF a, VecF b) { MaskF r = {a.v == b.v}; return r; }
+inline MaskF lessEqual(VecF a, VecF b) { MaskF r = {a.v <= b.v}; return r; }
+inline MaskF maskAnd(MaskF a, MaskF b) { MaskF r = {a.v && b.v}; return r; }
+inline MaskF maskAndNot(MaskF a, MaskF b) { MaskF r = {a.v && !b.v}; return r; }
+inline bool anyTrue(MaskF m) { return m.v; }
+inline MaskF maskOr(MaskF a, MaskF b) { MaskF r = {a.v || b.v}; return r; }
+inline VecF select(MaskF m, VecF a, VecF b) { return m.v ? a : b; }
+
+#endif
+
+inline VecF negate(VecF a) { return sub(set1(0.0f), a); }
+inline VecF abs(VecF a) { return select(lessThan(a, set1(0.0f)), negate(a), a); }
+
+/**
+ * @brief 向量化sin/cos（Cephes单精度多项式）
+ * 先将|x|约化到[-π/4, π/4]并记录象限，再分别求值sin/cos多项式并按象限交换、取符号。
+ * 对|x| < 8192的输入误差在1e-7量级。
+ */
+inline void sincos(VecF x, VecF& out_sin, VecF& out_cos) {
+    const VecF zero = set1(0.0f);
+    const VecF one = set1(1.0f);
+    const VecF minus_one = set1(-1.0f);
+
+    MaskF negative = lessThan(x, zero);
+    VecF ax = abs(x);
+
+    // j = (int)(|x| * 4/π)，向上取偶数
+    VecF t = truncate(mul(ax, set1(1.27323954473516f)));
+    VecF j = mul(set1(2.0f), truncate(mul(add(t, one), set1(0.5f))));
+
+    // 扩展精度的Cody-Waite约化
+    VecF r = sub(ax, mul(j, set1(0.78515625f)));
+    r = sub(r, mul(j, set1(2.4187564849853515625e-4f)));
+    r = sub(r, mul(j, set1(3.77489497744594108e-8f)));
+
+    // 象限k = (j/2) mod 4
+    VecF half_j = mul(j, set1(0.5f));
+    VecF k = sub(half_j, mul(set1(4.0f), truncate(mul(half_j, set1(0.25f)))));
+
+    VecF z = mul(r, r);
+    VecF cos_poly = add(mul(set1(2.443315711809948e-5f), z), set1(-1.388731625493765e-3f));
+    cos_poly = add(mul(cos_poly, z), set1(4.166664568298827e-2f));
+    cos_poly = mul(mul(cos_poly, z), z);
+    cos_poly = add(sub(cos_poly, mul(set1(0.5f), z)), one);
+
+    VecF sin_poly = add(mul(set1(-1.9515295891e-4f), z), set1(8.3321608736e-3f));
+    sin_poly = add(mul(sin_poly, z), set1(-1.6666654611e-1f));
+    sin_poly = add(mul(mul(sin_poly, z), r), r);
+
+    MaskF k1 = equal(k, one);
+    MaskF k2 = equal(k, set1(2.0f));
+    MaskF k3 = equal(k, set1(3.0f));
+    MaskF swap = maskOr(k1, k3);
+
+    VecF s = select(swap, cos_poly, sin_poly);
+    VecF c = select(swap, sin_poly, cos_poly);
+
+    VecF sin_sign = select(maskOr(k2, k3), minus_one, one);
+    sin_sign = mul(sin_sign, select(negative, minus_one, one));
+    VecF cos_sign = select(maskOr(k1, k2), minus_one, one);
+
+    out_sin = mul(s, sin_sign);
+    out_cos = mul(c, cos_sign);
+}
+
+} // namespace IOU3D_SIMD_NAMESPACE
+
+namespace simd = IOU3D_SIMD_NAMESPACE;
+
+} // namespace nms
@@ -0,0 +1,153 @@
+#include "stats.h"
+#include "stats_hooks.h"
+
+#ifdef IOU3D_ENABLE_STATS
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#endif
+
+namespace nms {
+
+#ifdef IOU3D_ENABLE_STATS
+
+namespace detail {
+
+namespace {
+
+/**
+ * @brief 所有线程计数器的登记表，线程退出时把计数并入retired
+ */
+struct Registry {
+    std::mutex mutex;
+    std::vector<ThreadStats*> threads;
+    uint64_t retired[NUM_COUNTERS] = {};
+};
+
+Registry& registry() {
+    // 故意不析构：其他静态对象析构时仍可能有线程在退出
+    static Registry* instance = new Registry();
+    return *instance;
+}
+
+struct ThreadStatsHolder {
+    ThreadStats stats;
+
+    ThreadStatsHolder() {
+        for (int c = 0; c < NUM_COUNTERS; ++c) {
+            stats.values[c].store(0, std::memory_order_relaxed);
+        }
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.threads.push_back(&stats);
+    }
+
+    ~ThreadStatsHolder() {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        for (int c = 0; c < NUM_COUNTERS; ++c) {
+            r.retired[c] += stats.values[c].load(std::memory_order_relaxed);
+        }
+        r.threads.erase(std::find(r.threads.begin(), r.threads.end(), &stats));
+    }
+};
+
+StatsSnapshot toSnapshot(const uint64_t values[NUM_COUNTERS]) {
+    StatsSnapshot snapshot;
+    snapshot.enabled = true;
+    snapshot.pairs_evaluated = values[PAIRS_EVALUATED];
+    snapshot.y_rejects = values[Y_REJECTS];
+    snapshot.bev_rejects = values[BEV_REJECTS];
+    snapshot.aligned_pairs = values[ALIGNED_PAIRS];
+    snapshot.empty_intersections = values[EMPTY_INTERSECTIONS];
+    snapshot.degenerate_denominators = values[DEGENERATE_DENOMINATORS];
+    snapshot.parallel_edges = values[PARALLEL_EDGES];
+    for (size_t b = 0; b < kClipHistogramBins; ++b) {
+        snapshot.clip_vertex_histogram[b] = values[CLIP_HISTOGRAM + b];
+    }
+    for (size_t s = 0; s < kNumStages; ++s) {
+        snapshot.stages[s].calls = values[STAGE_CALLS + s];
+        snapshot.stages[s].nanoseconds = values[STAGE_NANOSECONDS + s];
+    }
+    return snapshot;
+}
+
+} // namespace
+
+ThreadStats& threadStats() {
+    static thread_local ThreadStatsHolder holder;
+    return holder.stats;
+}
+
+} // namespace detail
+
+bool statsEnabled() {
+    return true;
+}
+
+StatsSnapshot statsSnapshot() {
+    detail::Registry& r = detail::registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    uint64_t values[detail::NUM_COUNTERS];
+    for (int c = 0; c < detail::NUM_COUNTERS; ++c) {
+        values[c] = r.retired[c];
+        for (size_t t = 0; t < r.threads.size(); ++t) {
+            values[c] += r.threads[t]->values[c].load(std::memory_order_relaxed);
+        }
+    }
+    return detail::toSnapshot(values);
+}
+
+StatsSnapshot threadStatsSnapshot() {
+    detail::ThreadStats& stats = detail::threadStats();
+    uint64_t values[detail::NUM_COUNTERS];
+    for (int c = 0; c < detail::NUM_COUNTERS; ++c) {
+        values[c] = stats.values[c].load(std::memory_order_relaxed);
+    }
+    return detail::toSnapshot(values);
+}
+
+void resetStats() {
+    detail::Registry& r = detail::registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (int c = 0; c < detail::NUM_COUNTERS; ++c) {
+        r.retired[c] = 0;
+        for (size_t t = 0; t < r.threads.size(); ++t) {
+            r.threads[t]->values[c].store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+#else
+
+bool statsEnabled() {
+    return false;
+}
+
+StatsSnapshot statsSnapshot() {
+    return StatsSnapshot();
+}
+
+StatsSnapshot threadStatsSnapshot() {
+    return StatsSnapshot();
+}
+
+void resetStats() {}
+
+#endif
+
+const char* stageName(Stage stage) {
+    switch (stage) {
+        case Stage::IOU_MATRIX:
+            return "iou_matrix";
+        case Stage::SPARSE_MATRIX:
+            return "sparse_matrix";
+        case Stage::NMS:
+            return "nms";
+        case Stage::ASSOCIATION:
+            return "association";
+    }
+    return "unknown";
+}
+
+} // namespace nms
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace nms {
+
+/**
+ * @brief 计时的阶段，计时包含内部嵌套调用的其他阶段
+ */
+enum class Stage {
+    IOU_MATRIX,    // 稠密IoU矩阵（calculateIoU3DMatrix/calculateBEVIoUMatrix）
+    SPARSE_MATRIX, // 稀疏IoU矩阵（calculateSparseIoU3DMatrix/calculateSparseBEVIoUMatrix）
+    NMS,           // nonMaximumSuppression、bitmaskNonMaximumSuppression与NmsWorkspace::process
+    ASSOCIATION    // associate与FramePipeline::associate
+};
+
+const size_t kNumStages = 4;
+
+// 交集多边形顶点数直方图的桶数，最后一个桶统计顶点数不少于kClipHistogramBins-1的情况
+const size_t kClipHistogramBins = 10;
+
+/**
+ * @brief 阶段计时
+ */
+struct StageTiming {
+    uint64_t calls = 0;
+    uint64_t nanoseconds = 0;
+};
+
+/**
+ * @brief 热路径计数器与阶段计时的快照
+ */
+struct StatsSnapshot {
+    // 编译时是否启用了统计（IOU3D_ENABLE_STATS），未启用时所有计数均为0
+    bool enabled = false;
+    // calculateIoU3D/calculateBEVIoU的调用次数（包括批量接口内部的调用）
+    uint64_t pairs_evaluated = 0;
+    // 因y区间不重叠而提前返回的框对
+    uint64_t y_rejects = 0;
+    // 因外接圆或包围矩形不相交而提前返回的框对
+    uint64_t bev_rejects = 0;
+    // yaw相差π/2整数倍、按轴对齐矩形直接求交的框对
+    uint64_t aligned_pairs = 0;
+    // 进行了多边形求交但交集为空的次数（四边形内核与sutherlandHodgmanClip）
+    uint64_t empty_intersections = 0;
+    // 交集多边形顶点数直方图，四边形内核的顶点可能含重复点
+    uint64_t clip_vertex_histogram[kClipHistogramBins] = {};
+    // getLineIntersectionX/Z中分母接近0的次数
+    uint64_t degenerate_denominators = 0;
+    // 四边形内核中因两边平行而跳过的边对
+    uint64_t parallel_edges = 0;
+    StageTiming stages[kNumStages];
+
+    const StageTiming& stage(Stage s) const { return stages[static_cast<size_t>(s)]; }
+};
+
+/**
+ * @brief 编译时是否启用了统计
+ */
+bool statsEnabled();
+
+/**
+ * @brief 所有线程的计数之和，包括已经退出的线程
+ * 计数器按线程独立累加，读取时不阻塞计算线程；并发计算中读到的快照各字段之间不保证一致
+ */
+StatsSnapshot statsSnapshot();
+
+/**
+ * @brief 只包含当前线程的计数
+ */
+StatsSnapshot threadStatsSnapshot();
+
+/**
+ * @brief 将所有线程的计数清零，调用时其他线程不应正在计算
+ */
+void resetStats();
+
+/**
+ * @brief 阶段名称，用于日志输出
+ */
+const char* stageName(Stage stage);
+
+} // namespace nms
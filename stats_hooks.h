@@ -0,0 +1,89 @@
+#pragma once
+
+// 内部头文件：热路径统计的埋点宏，不对外安装
+// 未定义IOU3D_ENABLE_STATS时所有宏展开为空，不产生任何开销
+
+#include "stats.h"
+
+#ifdef IOU3D_ENABLE_STATS
+
+#include <atomic>
+#include <chrono>
+
+namespace nms {
+namespace detail {
+
+enum Counter {
+    PAIRS_EVALUATED,
+    Y_REJECTS,
+    BEV_REJECTS,
+    ALIGNED_PAIRS,
+    EMPTY_INTERSECTIONS,
+    DEGENERATE_DENOMINATORS,
+    PARALLEL_EDGES,
+    CLIP_HISTOGRAM,
+    STAGE_CALLS = CLIP_HISTOGRAM + kClipHistogramBins,
+    STAGE_NANOSECONDS = STAGE_CALLS + kNumStages,
+    NUM_COUNTERS = STAGE_NANOSECONDS + kNumStages
+};
+
+/**
+ * @brief 单个线程的计数器
+ * 只有所属线程写入，用relaxed的load/store代替原子加，其他线程可以无锁读取
+ */
+struct ThreadStats {
+    std::atomic<uint64_t> values[NUM_COUNTERS];
+
+    void add(int counter, uint64_t amount) {
+        std::atomic<uint64_t>& value = values[counter];
+        value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @brief 当前线程的计数器，首次调用时登记到全局列表
+ */
+ThreadStats& threadStats();
+
+/**
+ * @brief 将作用域的耗时累加到指定阶段
+ */
+class StageTimer {
+public:
+    explicit StageTimer(Stage stage) : stage_(static_cast<int>(stage)), start_(std::chrono::steady_clock::now()) {}
+
+    ~StageTimer() {
+        std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start_;
+        ThreadStats& stats = threadStats();
+        stats.add(STAGE_CALLS + stage_, 1);
+        stats.add(STAGE_NANOSECONDS + stage_,
+                  static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    }
+
+private:
+    StageTimer(const StageTimer&);
+    StageTimer& operator=(const StageTimer&);
+
+    int stage_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+inline void recordClipVertices(size_t count) {
+    size_t bin = count < kClipHistogramBins ? count : kClipHistogramBins - 1;
+    threadStats().add(CLIP_HISTOGRAM + static_cast<int>(bin), 1);
+}
+
+} // namespace detail
+} // namespace nms
+
+#define IOU3D_STAT_INC(counter) ::nms::detail::threadStats().add(::nms::detail::counter, 1)
+#define IOU3D_STAT_CLIP_VERTICES(count) ::nms::detail::recordClipVertices(count)
+#define IOU3D_STAGE_TIMER(stage) ::nms::detail::StageTimer iou3d_stage_timer_(stage)
+
+#else
+
+#define IOU3D_STAT_INC(counter) ((void)0)
+#define IOU3D_STAT_CLIP_VERTICES(count) ((void)0)
+#define IOU3D_STAGE_TIMER(stage) ((void)0)
+
+#endif
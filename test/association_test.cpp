@@ -0,0 +1,297 @@
+#include "association.h"
+#include "executor.h"
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <algorithm>
+
+using namespace nms;
+
+namespace {
+
+Box makeBox(float x, float z, float yaw, int class_id) {
+    Box box;
+    box.class_id = class_id;
+    box.center_x = x;
+    box.center_y = 0.0f;
+    box.center_z = z;
+    box.length = 4.0f;
+    box.width = 2.0f;
+    box.height = 1.5f;
+    box.yaw = yaw;
+    box.confidence = 1.0f;
+    return box;
+}
+
+/**
+ * @brief 枚举所有部分匹配求最大IoU总和（每行可以不匹配）
+ */
+double bruteForceBest(const std::vector<float>& iou, size_t rows, size_t cols, float threshold,
+                      size_t row, std::vector<char>& col_used) {
+    if (row == rows) {
+        return 0.0;
+    }
+    double best = bruteForceBest(iou, rows, cols, threshold, row + 1, col_used);
+    for (size_t j = 0; j < cols; ++j) {
+        float value = iou[row * cols + j];
+        if (col_used[j] || value <= 0.0f || value < threshold) {
+            continue;
+        }
+        col_used[j] = 1;
+        best = std::max(best, value + bruteForceBest(iou, rows, cols, threshold, row + 1, col_used));
+        col_used[j] = 0;
+    }
+    return best;
+}
+
+double totalIoU(const AssociationResult& result) {
+    double total = 0.0;
+    for (size_t k = 0; k < result.matches.size(); ++k) {
+        total += result.matches[k].iou;
+    }
+    return total;
+}
+
+/**
+ * @brief 检查结果是合法的匹配且覆盖所有行和列
+ */
+bool isConsistent(const AssociationResult& result, const float* iou, size_t rows, size_t cols,
+                  float threshold) {
+    std::vector<int> row_seen(rows, 0);
+    std::vector<int> col_seen(cols, 0);
+    for (size_t k = 0; k < result.matches.size(); ++k) {
+        const Match& match = result.matches[k];
+        if (k > 0 && result.matches[k - 1].detection >= match.detection) return false;
+        if (iou != nullptr && iou[match.detection * cols + match.track] != match.iou) return false;
+        if (match.iou <= 0.0f || match.iou < threshold) return false;
+        ++row_seen[match.detection];
+        ++col_seen[match.track];
+    }
+    for (size_t k = 0; k < result.unmatched_detections.size(); ++k) {
+        ++row_seen[result.unmatched_detections[k]];
+    }
+    for (size_t k = 0; k < result.unmatched_tracks.size(); ++k) {
+        ++col_seen[result.unmatched_tracks[k]];
+    }
+    for (size_t i = 0; i < rows; ++i) {
+        if (row_seen[i] != 1) return false;
+    }
+    for (size_t j = 0; j < cols; ++j) {
+        if (col_seen[j] != 1) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 记录parallelFor调用次数的顺序执行器
+ */
+class CountingExecutor : public Executor {
+public:
+    CountingExecutor() : calls(0) {}
+    void parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& body) override {
+        ++calls;
+        serial_.parallelFor(count, grain, body);
+    }
+    size_t concurrency() const override { return 1; }
+
+    size_t calls;
+
+private:
+    SerialExecutor serial_;
+};
+
+bool sameMatch(const Match& a, const Match& b) {
+    return a.detection == b.detection && a.track == b.track && a.iou == b.iou;
+}
+
+bool sameResult(const AssociationResult& a, const AssociationResult& b) {
+    return a.matches.size() == b.matches.size() &&
+           std::equal(a.matches.begin(), a.matches.end(), b.matches.begin(), sameMatch) &&
+           a.unmatched_detections == b.unmatched_detections && a.unmatched_tracks == b.unmatched_tracks;
+}
+
+} // namespace
+
+bool testHungarianOptimal() {
+    std::cout << "\n=== 测试匈牙利算法与穷举结果一致 ===" << std::endl;
+
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<int> dim(0, 6);
+    std::uniform_real_distribution<float> value(0.0f, 1.0f);
+    std::bernoulli_distribution zero(0.4);
+
+    for (int trial = 0; trial < 300; ++trial) {
+        size_t rows = dim(rng);
+        size_t cols = dim(rng);
+        float threshold = trial % 2 == 0 ? 0.0f : 0.3f;
+        std::vector<float> iou(rows * cols);
+        for (size_t k = 0; k < iou.size(); ++k) {
+            iou[k] = zero(rng) ? 0.0f : value(rng);
+        }
+
+        AssociationResult result;
+        hungarianAssignment(iou.data(), rows, cols, threshold, result);
+        if (!isConsistent(result, iou.data(), rows, cols, threshold)) {
+            std::cerr << "  第" << trial << "组结果不是合法匹配" << std::endl;
+            return false;
+        }
+
+        std::vector<char> col_used(cols, 0);
+        double best = bruteForceBest(iou, rows, cols, threshold, 0, col_used);
+        if (std::abs(totalIoU(result) - best) > 1e-5) {
+            std::cerr << "  第" << trial << "组IoU总和 " << totalIoU(result) << "，最优 " << best << std::endl;
+            return false;
+        }
+
+        AssociationResult greedy;
+        greedyAssignment(iou.data(), rows, cols, threshold, greedy);
+        if (!isConsistent(greedy, iou.data(), rows, cols, threshold) || totalIoU(greedy) > best + 1e-5) {
+            std::cerr << "  第" << trial << "组贪心结果错误" << std::endl;
+            return false;
+        }
+    }
+
+    std::cout << "✓ 300组随机矩阵均得到最优分配" << std::endl;
+    return true;
+}
+
+bool testGreedyVersusHungarian() {
+    std::cout << "\n=== 测试贪心与匈牙利算法的区别 ===" << std::endl;
+
+    // 贪心先取0.9，剩下0.1；最优解为0.8 + 0.8
+    const float iou[] = {
+        0.9f, 0.8f,
+        0.8f, 0.1f
+    };
+
+    AssociationResult greedy;
+    greedyAssignment(iou, 2, 2, 0.0f, greedy);
+    AssociationResult optimal;
+    hungarianAssignment(iou, 2, 2, 0.0f, optimal);
+
+    std::cout << "  贪心总和: " << totalIoU(greedy) << "，匈牙利总和: " << totalIoU(optimal) << std::endl;
+    if (greedy.matches.size() != 2 || greedy.matches[0].track != 0) return false;
+    if (optimal.matches.size() != 2 || optimal.matches[0].track != 1 || optimal.matches[1].track != 0) return false;
+
+    // 门限0.5时贪心的0.1被排除
+    greedyAssignment(iou, 2, 2, 0.5f, greedy);
+    if (greedy.matches.size() != 1 || greedy.unmatched_detections.size() != 1 ||
+        greedy.unmatched_tracks.size() != 1) {
+        return false;
+    }
+
+    std::cout << "✓ 贪心与最优分配符合预期" << std::endl;
+    return true;
+}
+
+bool testAssociateBoxes() {
+    std::cout << "\n=== 测试包围盒关联（门限与类别） ===" << std::endl;
+
+    std::vector<Box> tracks;
+    tracks.push_back(makeBox(0.0f, 0.0f, 0.0f, 0));
+    tracks.push_back(makeBox(10.0f, 0.0f, 0.3f, 1));
+    tracks.push_back(makeBox(30.0f, 5.0f, 0.0f, 0));
+
+    std::vector<Box> detections;
+    detections.push_back(makeBox(10.3f, 0.2f, 0.25f, 1));  // 匹配轨迹1
+    detections.push_back(makeBox(0.2f, 0.1f, 0.05f, 0));   // 匹配轨迹0
+    detections.push_back(makeBox(30.0f, 5.0f, 0.0f, 1));   // 与轨迹2重合但类别不同
+    detections.push_back(makeBox(-20.0f, 0.0f, 0.0f, 0));  // 无重叠
+
+    AssociationConfig config;
+    AssociationResult result = associate(detections, tracks, config);
+    if (!isConsistent(result, nullptr, detections.size(), tracks.size(), config.iou_threshold)) return false;
+    if (result.matches.size() != 2) return false;
+    if (result.matches[0].detection != 0 || result.matches[0].track != 1) return false;
+    if (result.matches[1].detection != 1 || result.matches[1].track != 0) return false;
+    if (result.unmatched_detections != std::vector<int>({2, 3})) return false;
+    if (result.unmatched_tracks != std::vector<int>(1, 2)) return false;
+
+    // 关闭类别感知后检测2与轨迹2匹配
+    config.class_aware = false;
+    result = associate(detections, tracks, config);
+    if (result.matches.size() != 3 || result.matches[2].detection != 2 || result.matches[2].track != 2) {
+        return false;
+    }
+
+    std::cout << "✓ 关联结果正确" << std::endl;
+    return true;
+}
+
+bool testSparseMatchesDense() {
+    std::cout << "\n=== 测试稀疏模式与稠密模式一致 ===" << std::endl;
+
+    std::mt19937 rng(17);
+    std::uniform_real_distribution<float> position(-60.0f, 60.0f);
+    std::uniform_real_distribution<float> jitter(-1.5f, 1.5f);
+    std::uniform_real_distribution<float> angle(-3.2f, 3.2f);
+    std::uniform_int_distribution<int> label(0, 2);
+
+    std::vector<Box> tracks;
+    std::vector<Box> detections;
+    for (int i = 0; i < 200; ++i) {
+        Box track = makeBox(position(rng), position(rng), angle(rng), label(rng));
+        tracks.push_back(track);
+        if (i % 5 != 0) {
+            Box detection = track;
+            detection.center_x += jitter(rng);
+            detection.center_z += jitter(rng);
+            detection.yaw += 0.1f * jitter(rng);
+            detections.push_back(detection);
+        }
+    }
+    for (int i = 0; i < 30; ++i) {
+        detections.push_back(makeBox(position(rng), position(rng), angle(rng), label(rng)));
+    }
+
+    const AssignmentMethod methods[] = {AssignmentMethod::GREEDY, AssignmentMethod::HUNGARIAN};
+    const IoUType types[] = {IoUType::BEV, IoUType::IOU_3D};
+    for (AssignmentMethod method : methods) {
+        for (IoUType type : types) {
+            AssociationConfig config;
+            config.method = method;
+            config.iou_type = type;
+            AssociationResult dense = associate(detections, tracks, config);
+            config.sparse = true;
+            AssociationResult sparse = associate(detections, tracks, config);
+
+            if (!isConsistent(sparse, nullptr, detections.size(), tracks.size(), config.iou_threshold)) {
+                return false;
+            }
+            if (std::abs(totalIoU(dense) - totalIoU(sparse)) > 1e-3) {
+                std::cerr << "  稠密总和 " << totalIoU(dense) << "，稀疏总和 " << totalIoU(sparse) << std::endl;
+                return false;
+            }
+
+            // 使用线程池时稀疏与稠密模式的结果与串行相同
+            ThreadPool pool(3);
+            if (!sameResult(associate(detections, tracks, config, pool), sparse)) return false;
+            // 稀疏模式同样通过执行器计算IoU矩阵
+            CountingExecutor counting;
+            if (!sameResult(associate(detections, tracks, config, counting), sparse) || counting.calls == 0) {
+                return false;
+            }
+            config.sparse = false;
+            if (!sameResult(associate(detections, tracks, config, pool), dense)) return false;
+            std::cout << "  匹配数: " << sparse.matches.size() << "，IoU总和: " << totalIoU(sparse) << std::endl;
+        }
+    }
+
+    std::cout << "✓ 稀疏模式结果一致，线程池下结果与串行相同" << std::endl;
+    return true;
+}
+
+int main() {
+    std::cout << "开始数据关联测试..." << std::endl;
+
+    bool ok = testHungarianOptimal() && testGreedyVersusHungarian() &&
+              testAssociateBoxes() && testSparseMatchesDense();
+    if (!ok) {
+        std::cerr << "❌ 数据关联测试失败" << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n✓ 数据关联测试全部通过" << std::endl;
+    return 0;
+}
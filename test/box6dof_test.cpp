@@ -0,0 +1,249 @@
+#include "box6dof.h"
+#include "executor.h"
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <algorithm>
+
+using namespace nms;
+
+namespace {
+
+const float kPi = 3.14159265358979323846f;
+
+Box6DoF makeBox(float x, float y, float z, float l, float w, float h, float yaw, float pitch, float roll) {
+    Box6DoF box;
+    box.class_id = 0;
+    box.center_x = x;
+    box.center_y = y;
+    box.center_z = z;
+    box.length = l;
+    box.width = w;
+    box.height = h;
+    box.yaw = yaw;
+    box.pitch = pitch;
+    box.roll = roll;
+    box.confidence = 1.0f;
+    return box;
+}
+
+Box toBox(const Box6DoF& box) {
+    Box result;
+    result.class_id = box.class_id;
+    result.center_x = box.center_x;
+    result.center_y = box.center_y;
+    result.center_z = box.center_z;
+    result.length = box.length;
+    result.width = box.width;
+    result.height = box.height;
+    result.yaw = box.yaw;
+    result.confidence = box.confidence;
+    return result;
+}
+
+void multiply(const double a[9], const double b[9], double out[9]) {
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            out[i * 3 + j] = a[i * 3] * b[j] + a[i * 3 + 1] * b[3 + j] + a[i * 3 + 2] * b[6 + j];
+        }
+    }
+}
+
+// 按定义逐个相乘得到旋转矩阵，与库中的展开式相互独立
+void rotationOf(const Box6DoF& box, double r[9]) {
+    double cy = std::cos(box.yaw), sy = std::sin(box.yaw);
+    double cp = std::cos(box.pitch), sp = std::sin(box.pitch);
+    double cr = std::cos(box.roll), sr = std::sin(box.roll);
+    const double ry[9] = {cy, 0, sy, 0, 1, 0, -sy, 0, cy};
+    const double rz[9] = {cp, -sp, 0, sp, cp, 0, 0, 0, 1};
+    const double rx[9] = {1, 0, 0, 0, cr, -sr, 0, sr, cr};
+    double tmp[9];
+    multiply(ry, rz, tmp);
+    multiply(tmp, rx, r);
+}
+
+bool contains(const Box6DoF& box, const double r[9], const double p[3]) {
+    double d[3] = {p[0] - box.center_x, p[1] - box.center_y, p[2] - box.center_z};
+    double local[3];
+    for (int i = 0; i < 3; ++i) {
+        local[i] = r[i] * d[0] + r[3 + i] * d[1] + r[6 + i] * d[2];
+    }
+    return std::abs(local[0]) <= 0.5 * box.length && std::abs(local[1]) <= 0.5 * box.height &&
+           std::abs(local[2]) <= 0.5 * box.width;
+}
+
+/**
+ * @brief 在box1内均匀采样，用落在box2内的比例估计IoU
+ */
+double monteCarloIoU(const Box6DoF& box1, const Box6DoF& box2, std::mt19937& rng, int samples) {
+    double r1[9], r2[9];
+    rotationOf(box1, r1);
+    rotationOf(box2, r2);
+    std::uniform_real_distribution<double> unit(-0.5, 0.5);
+
+    int hits = 0;
+    for (int s = 0; s < samples; ++s) {
+        double local[3] = {unit(rng) * box1.length, unit(rng) * box1.height, unit(rng) * box1.width};
+        double p[3];
+        const double center[3] = {box1.center_x, box1.center_y, box1.center_z};
+        for (int i = 0; i < 3; ++i) {
+            p[i] = center[i] + r1[i * 3] * local[0] + r1[i * 3 + 1] * local[1] + r1[i * 3 + 2] * local[2];
+        }
+        if (contains(box2, r2, p)) {
+            ++hits;
+        }
+    }
+
+    double volume1 = static_cast<double>(box1.length) * box1.width * box1.height;
+    double volume2 = static_cast<double>(box2.length) * box2.width * box2.height;
+    double intersection = volume1 * hits / samples;
+    return intersection / (volume1 + volume2 - intersection);
+}
+
+} // namespace
+
+bool testYawOnlyMatchesPrism() {
+    std::cout << "\n=== 测试pitch、roll为0时与棱柱路径一致 ===" << std::endl;
+
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> position(-2.0f, 2.0f);
+    std::uniform_real_distribution<float> size(0.5f, 4.0f);
+    std::uniform_real_distribution<float> angle(-3.2f, 3.2f);
+
+    float max_error = 0.0f;
+    for (int i = 0; i < 500; ++i) {
+        Box6DoF a = makeBox(position(rng), 0.3f * position(rng), position(rng), size(rng), size(rng), size(rng),
+                            angle(rng), 0.0f, 0.0f);
+        Box6DoF b = makeBox(position(rng), 0.3f * position(rng), position(rng), size(rng), size(rng), size(rng),
+                            angle(rng), 0.0f, 0.0f);
+        float expected = calculateIoU3D(toBox(a), toBox(b));
+        if (calculateIoU3D(a, b) != expected) return false;
+
+        // 绕长度轴或宽度轴旋转π后形状不变，但走多面体裁剪路径
+        Box6DoF flipped_roll = a;
+        flipped_roll.roll = kPi;
+        Box6DoF flipped_pitch = b;
+        flipped_pitch.pitch = kPi;
+        max_error = std::max(max_error, std::abs(calculateIoU3D(flipped_roll, b) - expected));
+        max_error = std::max(max_error, std::abs(calculateIoU3D(a, flipped_pitch) - expected));
+        max_error = std::max(max_error, std::abs(calculateIoU3D(flipped_roll, flipped_pitch) - expected));
+    }
+
+    std::cout << "  多面体路径与棱柱路径最大误差: " << max_error << std::endl;
+    if (max_error > 1e-5f) return false;
+
+    std::cout << "✓ 棱柱回退正确" << std::endl;
+    return true;
+}
+
+bool testAgainstMonteCarlo() {
+    std::cout << "\n=== 测试与蒙特卡洛估计一致 ===" << std::endl;
+
+    std::mt19937 rng(17);
+    std::uniform_real_distribution<float> position(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> size(1.0f, 3.0f);
+    std::uniform_real_distribution<float> angle(-3.2f, 3.2f);
+    std::uniform_real_distribution<float> tilt(-0.6f, 0.6f);
+
+    double max_error = 0.0;
+    int overlapping = 0;
+    for (int i = 0; i < 40; ++i) {
+        Box6DoF a = makeBox(position(rng), position(rng), position(rng), size(rng), size(rng), size(rng),
+                            angle(rng), tilt(rng), tilt(rng));
+        Box6DoF b = makeBox(position(rng), position(rng), position(rng), size(rng), size(rng), size(rng),
+                            angle(rng), tilt(rng), tilt(rng));
+        double estimate = monteCarloIoU(a, b, rng, 200000);
+        float iou = calculateIoU3D(a, b);
+        if (std::abs(iou - calculateIoU3D(b, a)) > 1e-5f) return false;
+        max_error = std::max(max_error, std::abs(iou - estimate));
+        if (iou > 0.0f) ++overlapping;
+    }
+
+    std::cout << "  " << overlapping << " 对有重叠，最大偏差: " << max_error << std::endl;
+    if (max_error > 0.01 || overlapping < 20) return false;
+
+    std::cout << "✓ 交集体积正确" << std::endl;
+    return true;
+}
+
+bool testSpecialCases() {
+    std::cout << "\n=== 测试特殊情况 ===" << std::endl;
+
+    Box6DoF box = makeBox(1.0f, 2.0f, 3.0f, 4.0f, 2.0f, 1.5f, 0.4f, 0.3f, -0.2f);
+    if (std::abs(calculateIoU3D(box, box) - 1.0f) > 1e-5f) return false;
+
+    // 同朝向的小框完全位于大框内部
+    Box6DoF inner = box;
+    inner.length = 2.0f;
+    inner.width = 1.0f;
+    inner.height = 0.75f;
+    float expected = (2.0f * 1.0f * 0.75f) / (4.0f * 2.0f * 1.5f);
+    if (std::abs(calculateIoU3D(inner, box) - expected) > 1e-5f) return false;
+
+    Box6DoF far = box;
+    far.center_x += 10.0f;
+    if (calculateIoU3D(box, far) != 0.0f) return false;
+
+    // 外接球相交但实际不相交
+    Box6DoF tilted = makeBox(0.0f, 0.0f, 0.0f, 4.0f, 0.2f, 0.2f, 0.0f, 0.0f, 0.0f);
+    Box6DoF beside = makeBox(0.0f, 0.0f, 0.5f, 4.0f, 0.2f, 0.2f, 0.0f, 0.1f, 0.0f);
+    if (calculateIoU3D(tilted, beside) != 0.0f) return false;
+
+    Box flat = toBox(box);
+    Box6DoF converted = toBox6DoF(flat);
+    if (converted.pitch != 0.0f || converted.roll != 0.0f || converted.yaw != box.yaw) return false;
+
+    std::cout << "✓ 特殊情况正确" << std::endl;
+    return true;
+}
+
+bool testMatrix() {
+    std::cout << "\n=== 测试IoU矩阵 ===" << std::endl;
+
+    std::mt19937 rng(29);
+    std::uniform_real_distribution<float> position(-5.0f, 5.0f);
+    std::uniform_real_distribution<float> size(1.0f, 4.0f);
+    std::uniform_real_distribution<float> angle(-3.2f, 3.2f);
+    std::uniform_real_distribution<float> tilt(-0.3f, 0.3f);
+
+    std::vector<Box6DoF> boxes1, boxes2;
+    for (int i = 0; i < 60; ++i) {
+        // 一半为只有yaw的框，覆盖两种路径的混合
+        float pitch = i % 2 ? tilt(rng) : 0.0f;
+        float roll = i % 2 ? tilt(rng) : 0.0f;
+        boxes1.push_back(makeBox(position(rng), 0.0f, position(rng), size(rng), size(rng), 1.5f, angle(rng), pitch, roll));
+        boxes2.push_back(makeBox(position(rng), 0.2f, position(rng), size(rng), size(rng), 1.5f, angle(rng), roll, pitch));
+    }
+
+    std::vector<float> serial(boxes1.size() * boxes2.size());
+    std::vector<float> parallel(serial.size());
+    calculateIoU3DMatrix(boxes1, boxes2, serial.data());
+    ThreadPool pool(3);
+    calculateIoU3DMatrix(boxes1, boxes2, parallel.data(), pool);
+
+    for (size_t i = 0; i < boxes1.size(); ++i) {
+        for (size_t j = 0; j < boxes2.size(); ++j) {
+            float expected = calculateIoU3D(boxes1[i], boxes2[j]);
+            if (serial[i * boxes2.size() + j] != expected || parallel[i * boxes2.size() + j] != expected) {
+                return false;
+            }
+        }
+    }
+
+    std::cout << "✓ 矩阵与逐对结果一致" << std::endl;
+    return true;
+}
+
+int main() {
+    std::cout << "开始6自由度IoU测试..." << std::endl;
+
+    bool ok = testYawOnlyMatchesPrism() && testAgainstMonteCarlo() && testSpecialCases() && testMatrix();
+    if (!ok) {
+        std::cerr << "❌ 6自由度IoU测试失败" << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n✓ 6自由度IoU测试全部通过" << std::endl;
+    return 0;
+}
@@ -0,0 +1,107 @@
+#include "box_batch.h"
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cmath>
+
+using namespace nms;
+
+bool testRoundTrip() {
+    std::cout << "\n=== 测试BoxBatch与Box互相转换 ===" << std::endl;
+
+    std::vector<Box> boxes(3);
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        boxes[i].class_name = "car";
+        boxes[i].class_id = static_cast<int>(i);
+        boxes[i].center_x = 1.0f * i;
+        boxes[i].center_y = 2.0f * i;
+        boxes[i].center_z = 3.0f * i;
+        boxes[i].length = 4.0f;
+        boxes[i].width = 2.0f;
+        boxes[i].height = 1.5f;
+        boxes[i].yaw = 0.1f * i;
+        boxes[i].confidence = 0.5f + 0.1f * i;
+    }
+
+    BoxBatch batch = BoxBatch::fromBoxes(boxes);
+    if (batch.size() != boxes.size()) return false;
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        Box box = batch.box(i);
+        if (box.class_id != boxes[i].class_id || box.center_x != boxes[i].center_x ||
+            box.center_y != boxes[i].center_y || box.center_z != boxes[i].center_z ||
+            box.yaw != boxes[i].yaw || box.confidence != boxes[i].confidence) {
+            return false;
+        }
+    }
+
+    std::cout << "✓ 转换结果一致" << std::endl;
+    return true;
+}
+
+bool testCornersMatchScalar() {
+    std::cout << "\n=== 测试批量顶点与boxToBEVPolygon一致 ===" << std::endl;
+    std::cout << "SIMD后端: " << simdBackendName() << std::endl;
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> position(-80.0f, 80.0f);
+    std::uniform_real_distribution<float> size(0.5f, 12.0f);
+    std::uniform_real_distribution<float> angle(-20.0f, 20.0f);
+
+    // 使用非寄存器宽度整数倍的数量，覆盖尾部处理
+    const size_t counts[] = {0, 1, 5, 37};
+    for (size_t count : counts) {
+        BoxBatch batch;
+        for (size_t i = 0; i < count; ++i) {
+            Box box;
+            box.class_id = 0;
+            box.center_x = position(rng);
+            box.center_y = 0.0f;
+            box.center_z = position(rng);
+            box.length = size(rng);
+            box.width = size(rng);
+            box.height = 1.0f;
+            box.yaw = angle(rng);
+            box.confidence = 1.0f;
+            batch.push_back(box);
+        }
+        // 包含特殊角度
+        if (count > 4) {
+            batch.yaw[0] = 0.0f;
+            batch.yaw[1] = static_cast<float>(M_PI / 2);
+            batch.yaw[2] = static_cast<float>(-M_PI);
+            batch.yaw[3] = static_cast<float>(M_PI / 4);
+        }
+
+        BEVCornerBatch corners;
+        computeBEVCorners(batch, corners);
+        if (corners.size() != count) return false;
+
+        float max_error = 0.0f;
+        for (size_t i = 0; i < count; ++i) {
+            Polygon2D polygon = boxToBEVPolygon(batch.box(i));
+            for (int k = 0; k < 4; ++k) {
+                max_error = std::max(max_error, std::abs(corners.x[k][i] - polygon[k].x));
+                max_error = std::max(max_error, std::abs(corners.z[k][i] - polygon[k].z));
+            }
+        }
+
+        std::cout << "  数量 " << count << " 最大误差: " << max_error << std::endl;
+        if (max_error > 1e-4f) return false;
+    }
+
+    std::cout << "✓ 批量顶点计算正确" << std::endl;
+    return true;
+}
+
+int main() {
+    std::cout << "开始BoxBatch测试..." << std::endl;
+
+    bool ok = testRoundTrip() && testCornersMatchScalar();
+    if (!ok) {
+        std::cerr << "❌ BoxBatch测试失败" << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n✓ BoxBatch测试全部通过" << std::endl;
+    return 0;
+}
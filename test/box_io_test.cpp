@@ -0,0 +1,194 @@
+#include "box_io.h"
+#include "nms.h"
+#include "executor.h"
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <random>
+#include <cstdio>
+#include <cstdint>
+
+using namespace nms;
+
+namespace {
+
+const char* kPath = "box_io_test.bin";
+
+std::vector<std::vector<Box> > makeFrames() {
+    const char* names[3] = {"Car", "Pedestrian", "Cyclist"};
+    std::mt19937 rng(20);
+    std::uniform_real_distribution<float> position(-30.0f, 30.0f);
+    std::uniform_real_distribution<float> size(1.0f, 5.0f);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::uniform_int_distribution<int> class_dist(0, 2);
+
+    // 帧大小覆盖0、不足和超过补齐长度的情况
+    const size_t counts[6] = {37, 0, 1, 16, 200, 5};
+    std::vector<std::vector<Box> > frames(6);
+    for (size_t f = 0; f < frames.size(); ++f) {
+        for (size_t i = 0; i < counts[f]; ++i) {
+            Box box;
+            box.class_id = class_dist(rng);
+            box.class_name = names[box.class_id];
+            box.center_x = position(rng);
+            box.center_y = unit(rng);
+            box.center_z = position(rng);
+            box.length = size(rng);
+            box.width = size(rng);
+            box.height = size(rng);
+            box.yaw = unit(rng) * 6.0f - 3.0f;
+            box.confidence = unit(rng);
+            frames[f].push_back(box);
+        }
+    }
+    return frames;
+}
+
+bool sameBox(const Box& a, const Box& b) {
+    return a.class_id == b.class_id && a.class_name == b.class_name && a.center_x == b.center_x &&
+           a.center_y == b.center_y && a.center_z == b.center_z && a.length == b.length &&
+           a.width == b.width && a.height == b.height && a.yaw == b.yaw && a.confidence == b.confidence;
+}
+
+std::vector<char> readFile(const char* path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::vector<char>((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
+
+void writeFile(const char* path, const std::vector<char>& bytes) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+} // namespace
+
+bool testRoundTrip() {
+    std::cout << "\n=== 测试写入与读取 ===" << std::endl;
+    std::vector<std::vector<Box> > frames = makeFrames();
+
+    BoxFileWriter writer;
+    if (!writer.open(kPath)) return false;
+    for (size_t f = 0; f < frames.size(); ++f) {
+        // 交替使用AoS与SoA接口
+        bool ok = f % 2 == 0 ? writer.writeFrame(frames[f]) : writer.writeFrame(BoxBatch::fromBoxes(frames[f]));
+        if (!ok) return false;
+    }
+    writer.setClassName(7, "Tram");
+    if (writer.numFrames() != frames.size() || !writer.close()) return false;
+
+    BoxFileReader reader;
+    if (!reader.open(kPath)) {
+        std::cerr << "  " << reader.error() << std::endl;
+        return false;
+    }
+    size_t total = 0;
+    for (size_t f = 0; f < frames.size(); ++f) total += frames[f].size();
+    if (reader.numFrames() != frames.size() || reader.numBoxes() != total) return false;
+    if (reader.classNames().size() != 4 || reader.className(1) != "Pedestrian" || reader.className(7) != "Tram" ||
+        !reader.className(42).empty()) {
+        return false;
+    }
+
+    for (size_t f = 0; f < frames.size(); ++f) {
+        BoxBatchView view = reader.frame(f);
+        if (view.size() != frames[f].size()) return false;
+        // 每列按64字节对齐
+        if (reinterpret_cast<uintptr_t>(view.center_x) % 64 != 0 ||
+            reinterpret_cast<uintptr_t>(view.class_id) % 64 != 0) {
+            return false;
+        }
+        for (size_t i = 0; i < view.size(); ++i) {
+            if (!sameBox(reader.box(f, i), frames[f][i])) return false;
+        }
+    }
+    if (!reader.frame(frames.size()).empty()) return false;
+    std::cout << "  " << reader.numFrames() << " 帧, " << reader.numBoxes() << " 个框" << std::endl;
+
+    std::cout << "✓ 读写结果逐位一致" << std::endl;
+    return true;
+}
+
+bool testBatchAPIs() {
+    std::cout << "\n=== 测试视图上的批量接口 ===" << std::endl;
+    std::vector<std::vector<Box> > frames = makeFrames();
+    BoxFileReader reader;
+    if (!reader.open(kPath)) return false;
+
+    ThreadPool pool(3);
+    NMSConfig config;
+    config.iou_threshold = 0.1f;
+    NmsWorkspace workspace(config);
+    for (size_t f = 0; f < frames.size(); ++f) {
+        BoxBatchView view = reader.frame(f);
+        std::vector<int> expected = nonMaximumSuppression(frames[f], config);
+        if (workspace.process(view, pool) != expected) return false;
+
+        std::vector<float> expected_iou(frames[f].size() * frames[0].size());
+        std::vector<float> iou(expected_iou.size());
+        calculateIoU3DMatrix(frames[f], frames[0], expected_iou.data());
+        calculateIoU3DMatrix(view, reader.frame(0), iou.data(), pool);
+        if (iou != expected_iou) return false;
+        calculateBEVIoUMatrix(frames[f], frames[0], expected_iou.data());
+        calculateBEVIoUMatrix(view, reader.frame(0), iou.data());
+        if (iou != expected_iou) return false;
+    }
+
+    std::cout << "✓ NMS与IoU矩阵结果与Box接口一致" << std::endl;
+    return true;
+}
+
+bool testInvalidFiles() {
+    std::cout << "\n=== 测试损坏的文件 ===" << std::endl;
+    BoxFileReader reader;
+    if (reader.open("does_not_exist.bin") || reader.error().empty()) return false;
+
+    const std::vector<char> original = readFile(kPath);
+    const char* corrupt_path = "box_io_test_corrupt.bin";
+    bool ok = true;
+
+    // 截断
+    std::vector<char> bytes(original.begin(), original.begin() + original.size() / 2);
+    writeFile(corrupt_path, bytes);
+    ok = ok && !reader.open(corrupt_path) && !reader.isOpen();
+
+    // 魔数错误
+    bytes = original;
+    bytes[0] = 'X';
+    writeFile(corrupt_path, bytes);
+    ok = ok && !reader.open(corrupt_path);
+
+    // 版本错误
+    bytes = original;
+    bytes[8] = 9;
+    writeFile(corrupt_path, bytes);
+    ok = ok && !reader.open(corrupt_path);
+
+    // 未正常关闭的写入器
+    {
+        BoxFileWriter writer;
+        writer.open(corrupt_path);
+        writer.writeFrame(makeFrames()[0]);
+        // 文件头尚未回填时读取
+        ok = ok && !reader.open(corrupt_path);
+    }
+    ok = ok && reader.open(corrupt_path) && reader.numFrames() == 1;
+    reader.close();
+    std::remove(corrupt_path);
+    if (!ok) return false;
+    std::cout << "✓ 损坏的文件被拒绝" << std::endl;
+    return true;
+}
+
+int main() {
+    std::cout << "开始包围盒文件测试..." << std::endl;
+
+    bool ok = testRoundTrip() && testBatchAPIs() && testInvalidFiles();
+    std::remove(kPath);
+    if (!ok) {
+        std::cerr << "❌ 包围盒文件测试失败" << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n✓ 包围盒文件测试全部通过" << std::endl;
+    return 0;
+}
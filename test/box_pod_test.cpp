@@ -0,0 +1,142 @@
+#include "iou3d.h"
+#include "nms.h"
+#include "executor.h"
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cstring>
+#include <type_traits>
+
+using namespace nms;
+
+namespace {
+
+std::vector<Box> makeBoxes(size_t count, unsigned seed) {
+    const char* names[3] = {"Car", "Pedestrian", "Cyclist"};
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> position(-15.0f, 15.0f);
+    std::uniform_real_distribution<float> size(1.0f, 5.0f);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::uniform_int_distribution<int> class_dist(0, 2);
+    std::vector<Box> boxes(count);
+    for (size_t i = 0; i < count; ++i) {
+        Box& box = boxes[i];
+        box.class_id = class_dist(rng);
+        box.class_name = names[box.class_id];
+        box.center_x = position(rng);
+        box.center_y = unit(rng);
+        box.center_z = position(rng);
+        box.length = size(rng);
+        box.width = size(rng);
+        box.height = size(rng);
+        box.yaw = unit(rng) * 6.0f - 3.0f;
+        box.confidence = unit(rng);
+    }
+    return boxes;
+}
+
+} // namespace
+
+bool testConversion() {
+    std::cout << "\n=== 测试BoxPOD转换与类别表 ===" << std::endl;
+    if (!std::is_trivially_copyable<BoxPOD>::value || sizeof(BoxPOD) != 36) return false;
+
+    std::vector<Box> boxes = makeBoxes(20, 1);
+    ClassTable table;
+    std::vector<BoxPOD> pods = toBoxPODs(boxes, &table);
+    if (pods.size() != boxes.size() || table.size() != 3) return false;
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        Box back = toBox(pods[i], table);
+        if (back.class_name != boxes[i].class_name || back.class_id != boxes[i].class_id ||
+            std::memcmp(&back.center_x, &boxes[i].center_x, 8 * sizeof(float)) != 0) {
+            return false;
+        }
+        if (!toBox(pods[i]).class_name.empty()) return false;
+    }
+
+    // 已有名称不被覆盖，intern为新名称分配最大id加1
+    Box renamed = boxes[0];
+    renamed.class_name = "Van";
+    toBoxPOD(renamed, table);
+    if (table.name(renamed.class_id) != boxes[0].class_name) return false;
+    if (table.intern("Car") != table.find("Car") || table.intern("Van") != 3 || table.find("Tram") != -1) {
+        return false;
+    }
+    table.set(10, "Tram");
+    if (table.intern("Truck") != 11 || !table.name(5).empty()) return false;
+
+    ClassTable empty;
+    if (empty.intern("Car") != 0) return false;
+
+    std::cout << "✓ 转换与类别表正确" << std::endl;
+    return true;
+}
+
+bool testIoUOverloads() {
+    std::cout << "\n=== 测试BoxPOD的IoU接口 ===" << std::endl;
+    std::vector<Box> boxes = makeBoxes(120, 2);
+    std::vector<BoxPOD> pods = toBoxPODs(boxes);
+
+    size_t overlapping = 0;
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        for (size_t j = 0; j < boxes.size(); ++j) {
+            float iou = calculateIoU3D(boxes[i], boxes[j]);
+            if (calculateIoU3D(pods[i], pods[j]) != iou) return false;
+            if (calculateBEVIoU(pods[i], pods[j]) != calculateBEVIoU(boxes[i], boxes[j])) return false;
+            if (calculateIoU3D<double>(pods[i], pods[j]) != calculateIoU3D<double>(boxes[i], boxes[j])) return false;
+            if (calculateBEVIoU<float>(pods[i], pods[j], false) != calculateBEVIoU<float>(boxes[i], boxes[j], false)) {
+                return false;
+            }
+            overlapping += iou > 0.0f ? 1 : 0;
+        }
+    }
+    std::cout << "  重叠框对: " << overlapping << std::endl;
+
+    std::vector<float> expected(boxes.size() * boxes.size());
+    std::vector<float> actual(expected.size());
+    ThreadPool pool(3);
+    calculateIoU3DMatrix(boxes, boxes, expected.data());
+    calculateIoU3DMatrix(pods, pods, actual.data());
+    if (actual != expected) return false;
+    calculateIoU3DMatrix(pods, pods, actual.data(), pool);
+    if (actual != expected) return false;
+    calculateBEVIoUMatrix(boxes, boxes, expected.data());
+    calculateBEVIoUMatrix(pods, pods, actual.data(), pool);
+    if (actual != expected) return false;
+
+    std::cout << "✓ 与Box版本结果逐位一致" << std::endl;
+    return true;
+}
+
+bool testNMS() {
+    std::cout << "\n=== 测试BoxPOD的NMS ===" << std::endl;
+    std::vector<Box> boxes = makeBoxes(500, 3);
+    std::vector<BoxPOD> pods = toBoxPODs(boxes);
+    ThreadPool pool(3);
+
+    NMSConfig config;
+    config.iou_threshold = 0.2f;
+    for (int class_aware = 0; class_aware < 2; ++class_aware) {
+        config.class_aware = class_aware != 0;
+        std::vector<int> expected = nonMaximumSuppression(boxes, config);
+        if (nonMaximumSuppression(pods, config) != expected) return false;
+        if (nonMaximumSuppression(pods, config, pool) != expected) return false;
+        std::cout << "  class_aware=" << class_aware << " 保留 " << expected.size() << " 个框" << std::endl;
+    }
+
+    std::cout << "✓ NMS结果与Box版本一致" << std::endl;
+    return true;
+}
+
+int main() {
+    std::cout << "开始BoxPOD测试..." << std::endl;
+
+    bool ok = testConversion() && testIoUOverloads() && testNMS();
+    if (!ok) {
+        std::cerr << "❌ BoxPOD测试失败" << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n✓ BoxPOD测试全部通过" << std::endl;
+    return 0;
+}
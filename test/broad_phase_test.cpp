@@ -0,0 +1,148 @@
+#include "broad_phase.h"
+#include "executor.h"
+#include <iostream>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cmath>
+
+using namespace nms;
+
+// 在200m×200m场景中随机生成包围盒，部分成簇以产生重叠
+std::vector<Box> generateScene(size_t count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> jitter(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> angle(-3.14159f, 3.14159f);
+    std::uniform_real_distribution<float> size(0.5f, 6.0f);
+
+    std::vector<Box> boxes;
+    while (boxes.size() < count) {
+        float cx = position(rng);
+        float cz = position(rng);
+        for (int k = 0; k < 3 && boxes.size() < count; ++k) {
+            Box box;
+            box.class_name = "test";
+            box.class_id = 0;
+            box.center_x = cx + jitter(rng);
+            box.center_y = jitter(rng) * 0.5f;
+            box.center_z = cz + jitter(rng);
+            box.length = size(rng);
+            box.width = size(rng);
+            box.height = 1.5f;
+            box.yaw = angle(rng);
+            box.confidence = 1.0f;
+            boxes.push_back(box);
+        }
+    }
+    return boxes;
+}
+
+bool testSelfPairs() {
+    std::cout << "\n=== 测试网格自身候选对 ===" << std::endl;
+
+    std::vector<Box> boxes = generateScene(1500, 3);
+    std::vector<BEVBounds> bounds(boxes.size());
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        bounds[i] = computeBEVBounds(boxes[i]);
+    }
+
+    const float cell_sizes[] = {0.0f, 0.7f, 25.0f};
+    for (float cell_size : cell_sizes) {
+        BEVGrid grid(cell_size);
+        grid.build(bounds);
+
+        std::vector<CandidatePair> pairs;
+        grid.selfPairs(pairs);
+
+        std::vector<std::pair<int, int> > found;
+        for (size_t k = 0; k < pairs.size(); ++k) {
+            found.push_back(std::make_pair(pairs[k].first, pairs[k].second));
+        }
+        std::sort(found.begin(), found.end());
+
+        std::vector<std::pair<int, int> > expected;
+        for (size_t i = 0; i < bounds.size(); ++i) {
+            for (size_t j = i + 1; j < bounds.size(); ++j) {
+                if (bounds[i].overlaps(bounds[j])) {
+                    expected.push_back(std::make_pair(static_cast<int>(i), static_cast<int>(j)));
+                }
+            }
+        }
+
+        std::cout << "  单元尺寸 " << grid.cellSize() << ": 候选对 " << found.size()
+                  << " / 总对数 " << bounds.size() * (bounds.size() - 1) / 2 << std::endl;
+        if (found != expected) return false;
+    }
+
+    std::cout << "✓ 候选对与暴力枚举一致且无重复" << std::endl;
+    return true;
+}
+
+bool testSparseMatrix() {
+    std::cout << "\n=== 测试稀疏IoU矩阵 ===" << std::endl;
+
+    std::vector<Box> detections = generateScene(400, 11);
+    std::vector<Box> tracks = generateScene(300, 11);
+    for (size_t i = 0; i < tracks.size(); ++i) {
+        tracks[i].center_x += 0.3f;
+    }
+
+    std::vector<float> dense(detections.size() * tracks.size());
+    SparseIoUMatrix sparse;
+    for (int use_3d = 0; use_3d < 2; ++use_3d) {
+        if (use_3d) {
+            calculateIoU3DMatrix(detections, tracks, dense.data());
+            calculateSparseIoU3DMatrix(detections, tracks, sparse);
+        } else {
+            calculateBEVIoUMatrix(detections, tracks, dense.data());
+            calculateSparseBEVIoUMatrix(detections, tracks, sparse);
+        }
+
+        if (sparse.rows != detections.size() || sparse.cols != tracks.size()) return false;
+
+        size_t dense_non_zeros = 0;
+        for (size_t i = 0; i < detections.size(); ++i) {
+            for (size_t j = 0; j < tracks.size(); ++j) {
+                float expected = dense[i * tracks.size() + j];
+                if (expected > 1e-6f) ++dense_non_zeros;
+                if (std::abs(sparse.at(i, j) - expected) > 1e-5f) {
+                    std::cout << "✗ (" << i << "," << j << ") 稀疏: " << sparse.at(i, j) << " 稠密: " << expected << std::endl;
+                    return false;
+                }
+            }
+        }
+
+        // 并行版本与串行版本逐位一致
+        ThreadPool pool(3);
+        SparseIoUMatrix parallel;
+        if (use_3d) {
+            calculateSparseIoU3DMatrix(detections, tracks, parallel, pool);
+        } else {
+            calculateSparseBEVIoUMatrix(detections, tracks, parallel, pool);
+        }
+        if (parallel.rows != sparse.rows || parallel.cols != sparse.cols || parallel.row_ptr != sparse.row_ptr ||
+            parallel.col_index != sparse.col_index || parallel.values != sparse.values) {
+            return false;
+        }
+
+        std::cout << "  " << (use_3d ? "3D" : "BEV") << " 非零元素: " << sparse.nonZeros()
+                  << " (稠密矩阵中 " << dense_non_zeros << ")" << std::endl;
+    }
+
+    std::cout << "✓ 稀疏矩阵与稠密矩阵一致，并行结果与串行一致" << std::endl;
+    return true;
+}
+
+int main() {
+    std::cout << "开始粗筛测试..." << std::endl;
+
+    bool ok = testSelfPairs() && testSparseMatrix();
+    if (!ok) {
+        std::cerr << "❌ 粗筛测试失败" << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n✓ 粗筛测试全部通过" << std::endl;
+    return 0;
+}
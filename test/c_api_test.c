@@ -0,0 +1,143 @@
+/* 用C编译器编译，同时验证iou3d_c.h是合法的C头文件 */
+#include "iou3d_c.h"
+#include <stdio.h>
+#include <math.h>
+#include <stdlib.h>
+
+/* 每行8个float：7个框参数加一列置信度，验证stride */
+#define STRIDE 8
+
+static void setBox(float* row, float x, float z, float l, float w, float yaw, float score) {
+    row[0] = x;
+    row[1] = 0.0f;
+    row[2] = z;
+    row[3] = l;
+    row[4] = w;
+    row[5] = 1.5f;
+    row[6] = yaw;
+    row[7] = score;
+}
+
+static int near(float a, float b) {
+    return fabsf(a - b) < 1e-5f;
+}
+
+static int testMatrix(iou3d_context* ctx) {
+    float boxes[3 * STRIDE];
+    float out[9];
+    float out3d[9];
+    int status;
+
+    printf("\n=== 测试IoU矩阵 ===\n");
+    setBox(boxes, 0.0f, 0.0f, 4.0f, 2.0f, 0.0f, 0.9f);
+    setBox(boxes + STRIDE, 2.0f, 0.0f, 4.0f, 2.0f, 0.0f, 0.8f);
+    setBox(boxes + 2 * STRIDE, 20.0f, 0.0f, 4.0f, 2.0f, 0.7f, 0.7f);
+
+    status = iou3d_bev_iou_matrix(boxes, 3, STRIDE, boxes, 3, STRIDE, out, ctx);
+    if (status != IOU3D_OK) return 0;
+    /* 平移半个长度：交集4，并集12 */
+    if (!near(out[0], 1.0f) || !near(out[1], 1.0f / 3.0f) || !near(out[3], 1.0f / 3.0f)) return 0;
+    if (out[2] != 0.0f || out[6] != 0.0f || !near(out[8], 1.0f)) return 0;
+
+    status = iou3d_iou3d_matrix(boxes, 3, STRIDE, boxes + STRIDE, 2, STRIDE, out3d, ctx);
+    if (status != IOU3D_OK) return 0;
+    if (!near(out3d[0], 1.0f / 3.0f) || !near(out3d[2], 1.0f)) return 0;
+    if (out3d[4] != 0.0f || !near(out3d[5], 1.0f)) return 0;
+
+    printf("✓ IoU矩阵正确\n");
+    return 1;
+}
+
+static int testNMS(iou3d_context* ctx) {
+    enum { N = 200 };
+    float* boxes = (float*)malloc(sizeof(float) * N * STRIDE);
+    float scores[N];
+    int class_ids[N];
+    int keep[N];
+    int keep_serial[N];
+    size_t num_keep = 0;
+    size_t num_keep_serial = 0;
+    size_t i;
+    int ok = 1;
+    iou3d_nms_params params;
+
+    printf("\n=== 测试NMS ===\n");
+    /* 每5个框聚成一簇，簇内中心只相差0.1 */
+    for (i = 0; i < N; ++i) {
+        float cluster = (float)(i / 5);
+        setBox(boxes + i * STRIDE, 10.0f * cluster, 0.1f * (float)(i % 5), 4.0f, 2.0f, 0.3f,
+               1.0f - 0.001f * (float)((i * 37) % N));
+        scores[i] = boxes[i * STRIDE + 7];
+        class_ids[i] = 0;
+    }
+
+    iou3d_nms_params_init(&params);
+    params.iou_threshold = 0.5f;
+    if (iou3d_nms(boxes, N, STRIDE, scores, class_ids, &params, keep, &num_keep, ctx) != IOU3D_OK) ok = 0;
+    if (iou3d_nms(boxes, N, STRIDE, scores, NULL, &params, keep_serial, &num_keep_serial, NULL) != IOU3D_OK) ok = 0;
+    printf("  保留 %zu 个框\n", num_keep);
+    if (num_keep != N / 5 || num_keep_serial != num_keep) ok = 0;
+    for (i = 0; ok && i < num_keep; ++i) {
+        if (keep[i] != keep_serial[i]) ok = 0;
+        /* 保留框按置信度降序 */
+        if (i > 0 && scores[keep[i]] > scores[keep[i - 1]]) ok = 0;
+    }
+
+    /* 类别不同时互不抑制 */
+    for (i = 0; i < N; ++i) {
+        class_ids[i] = (int)(i % 5);
+    }
+    if (iou3d_nms(boxes, N, STRIDE, scores, class_ids, &params, keep, &num_keep, ctx) != IOU3D_OK) ok = 0;
+    if (num_keep != N) ok = 0;
+
+    /* post_max_size */
+    params.post_max_size = 7;
+    if (iou3d_nms(boxes, N, STRIDE, scores, NULL, &params, keep, &num_keep, ctx) != IOU3D_OK) ok = 0;
+    if (num_keep != 7) ok = 0;
+
+    free(boxes);
+    if (ok) printf("✓ NMS正确\n");
+    return ok;
+}
+
+static int testErrors(void) {
+    float box[7] = {0.0f, 0.0f, 0.0f, 4.0f, 2.0f, 1.5f, 0.0f};
+    float out[1];
+    int keep[1];
+    size_t num_keep;
+
+    printf("\n=== 测试错误码 ===\n");
+    if (iou3d_bev_iou_matrix(box, 1, 6, box, 1, 7, out, NULL) != IOU3D_ERROR_INVALID_STRIDE) return 0;
+    if (iou3d_bev_iou_matrix(NULL, 1, 7, box, 1, 7, out, NULL) != IOU3D_ERROR_NULL_POINTER) return 0;
+    if (iou3d_iou3d_matrix(box, 1, 7, box, 1, 7, NULL, NULL) != IOU3D_ERROR_NULL_POINTER) return 0;
+    if (iou3d_nms(box, 1, 7, NULL, NULL, NULL, keep, &num_keep, NULL) != IOU3D_ERROR_NULL_POINTER) return 0;
+    if (iou3d_context_create(1, NULL) != IOU3D_ERROR_NULL_POINTER) return 0;
+    /* 空输入合法 */
+    if (iou3d_bev_iou_matrix(NULL, 0, 7, NULL, 0, 7, NULL, NULL) != IOU3D_OK) return 0;
+    if (iou3d_nms(NULL, 0, 7, NULL, NULL, NULL, NULL, &num_keep, NULL) != IOU3D_OK || num_keep != 0) return 0;
+    printf("  %s\n", iou3d_status_string(IOU3D_ERROR_INVALID_STRIDE));
+
+    printf("✓ 错误码正确\n");
+    return 1;
+}
+
+int main(void) {
+    iou3d_context* ctx = NULL;
+    int ok;
+
+    printf("开始C接口测试...\n");
+    if (iou3d_context_create(3, &ctx) != IOU3D_OK) {
+        fprintf(stderr, "❌ 创建上下文失败\n");
+        return 1;
+    }
+
+    ok = testMatrix(ctx) && testMatrix(NULL) && testNMS(ctx) && testErrors();
+    iou3d_context_destroy(ctx);
+    if (!ok) {
+        fprintf(stderr, "❌ C接口测试失败\n");
+        return 1;
+    }
+
+    printf("\n✓ C接口测试全部通过\n");
+    return 0;
+}
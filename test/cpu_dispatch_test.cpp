@@ -0,0 +1,121 @@
+#include "box_batch.h"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+using namespace nms;
+
+namespace {
+
+BoxBatch makeBatch(size_t count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> size(0.5f, 10.0f);
+    std::uniform_real_distribution<float> yaw(-20.0f, 20.0f);
+    BoxBatch batch;
+    for (size_t i = 0; i < count; ++i) {
+        Box box;
+        box.center_x = position(rng);
+        box.center_z = position(rng);
+        box.length = size(rng);
+        box.width = size(rng);
+        box.yaw = yaw(rng);
+        batch.push_back(box);
+    }
+    return batch;
+}
+
+bool sameCorners(const BEVCornerBatch& a, const BEVCornerBatch& b) {
+    for (int k = 0; k < 4; ++k) {
+        if (a.x[k].size() != b.x[k].size()) return false;
+        if (!a.x[k].empty() && (std::memcmp(a.x[k].data(), b.x[k].data(), a.x[k].size() * sizeof(float)) != 0 ||
+                                std::memcmp(a.z[k].data(), b.z[k].data(), a.z[k].size() * sizeof(float)) != 0)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool testSelection() {
+    std::cout << "\n=== 测试后端选择 ===" << std::endl;
+    std::vector<std::string> available = availableSimdBackends();
+    if (available.empty() || available[0] != "scalar") return false;
+
+    std::string active = simdBackendName();
+    std::cout << "  可用后端:";
+    for (size_t i = 0; i < available.size(); ++i) std::cout << " " << available[i];
+    std::cout << "，当前: " << active << std::endl;
+    if (std::find(available.begin(), available.end(), active) == available.end()) return false;
+
+    // 未指定时使用最高级别；指定的后端可用时必须被选中
+    const char* forced = std::getenv("IOU3D_FORCE_ISA");
+    if (!forced && active != available.back()) return false;
+    if (forced && std::find(available.begin(), available.end(), std::string(forced)) != available.end() &&
+        active != forced) {
+        return false;
+    }
+
+    if (setSimdBackend("no_such_isa") || simdBackendName() != active) return false;
+    std::cout << "✓ 后端选择正确" << std::endl;
+    return true;
+}
+
+bool testBackendsAgree() {
+    std::cout << "\n=== 测试各后端结果逐位一致 ===" << std::endl;
+    const std::string initial = simdBackendName();
+    std::vector<std::string> available = availableSimdBackends();
+    const size_t sizes[] = {0, 1, 3, 4, 7, 8, 15, 16, 17, 33, 1000};
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+        BoxBatch batch = makeBatch(sizes[s], static_cast<unsigned>(s));
+        BEVCornerBatch expected;
+        if (!setSimdBackend("scalar")) return false;
+        computeBEVCorners(batch, expected);
+
+        // 标量结果与逐个计算的顶点一致
+        for (size_t i = 0; i < batch.size(); ++i) {
+            Point2D corners[4];
+            boxToBEVCorners(batch.box(i), corners);
+            for (int k = 0; k < 4; ++k) {
+                if (std::abs(corners[k].x - expected.x[k][i]) > 1e-3f ||
+                    std::abs(corners[k].z - expected.z[k][i]) > 1e-3f) {
+                    return false;
+                }
+            }
+        }
+
+        for (size_t b = 1; b < available.size(); ++b) {
+            if (!setSimdBackend(available[b]) || simdBackendName() != available[b]) return false;
+            BEVCornerBatch corners;
+            computeBEVCorners(batch, corners);
+            if (!sameCorners(corners, expected)) {
+                std::cerr << "  " << available[b] << " 在 n=" << sizes[s] << " 时与标量结果不一致" << std::endl;
+                return false;
+            }
+        }
+    }
+    setSimdBackend(initial);
+
+    std::cout << "✓ " << available.size() << " 个后端结果一致" << std::endl;
+    return true;
+}
+
+int main() {
+    std::cout << "开始CPU分发测试..." << std::endl;
+
+    bool ok = testSelection() && testBackendsAgree();
+    if (!ok) {
+        std::cerr << "❌ CPU分发测试失败" << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n✓ CPU分发测试全部通过" << std::endl;
+    return 0;
+}
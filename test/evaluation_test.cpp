@@ -0,0 +1,265 @@
+#include "evaluation.h"
+#include "executor.h"
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <algorithm>
+
+using namespace nms;
+
+namespace {
+
+Box makeBox(float x, float z, int class_id, float confidence) {
+    Box box;
+    box.class_id = class_id;
+    box.center_x = x;
+    box.center_y = 0.0f;
+    box.center_z = z;
+    box.length = 4.0f;
+    box.width = 2.0f;
+    box.height = 1.5f;
+    box.yaw = 0.0f;
+    box.confidence = confidence;
+    return box;
+}
+
+bool near(float a, float b, float tolerance = 1e-5f) {
+    return std::fabs(a - b) < tolerance;
+}
+
+/**
+ * @brief 参考实现：每个阈值单独用Box接口计算IoU并按置信度贪心匹配，再以全部点积分求AP
+ */
+float referenceAP(const std::vector<EvalFrame>& frames, int class_id, float threshold) {
+    struct Scored {
+        float score;
+        size_t order;
+        bool tp;
+    };
+    std::vector<Scored> all;
+    size_t num_gt = 0;
+    for (size_t f = 0; f < frames.size(); ++f) {
+        const EvalFrame& frame = frames[f];
+        std::vector<int> dets;
+        for (size_t i = 0; i < frame.detections.size(); ++i) {
+            if (frame.detections[i].class_id == class_id) dets.push_back(static_cast<int>(i));
+        }
+        std::stable_sort(dets.begin(), dets.end(), [&frame](int a, int b) {
+            return frame.detections[a].confidence > frame.detections[b].confidence;
+        });
+        std::vector<char> used(frame.ground_truth.size(), 0);
+        for (size_t j = 0; j < frame.ground_truth.size(); ++j) {
+            if (frame.ground_truth[j].class_id == class_id) ++num_gt;
+        }
+        for (size_t k = 0; k < dets.size(); ++k) {
+            int best = -1;
+            float best_iou = 0.0f;
+            for (size_t j = 0; j < frame.ground_truth.size(); ++j) {
+                if (used[j] || frame.ground_truth[j].class_id != class_id) continue;
+                float iou = calculateIoU3D(frame.detections[dets[k]], frame.ground_truth[j]);
+                if (iou > 0.0f && iou >= threshold && iou > best_iou) {
+                    best = static_cast<int>(j);
+                    best_iou = iou;
+                }
+            }
+            if (best >= 0) used[best] = 1;
+            Scored scored = {frame.detections[dets[k]].confidence, all.size(), best >= 0};
+            all.push_back(scored);
+        }
+    }
+    std::stable_sort(all.begin(), all.end(), [](const Scored& a, const Scored& b) { return a.score > b.score; });
+
+    std::vector<double> precision, recall;
+    size_t tp = 0;
+    for (size_t k = 0; k < all.size(); ++k) {
+        tp += all[k].tp ? 1 : 0;
+        precision.push_back(static_cast<double>(tp) / (k + 1));
+        recall.push_back(num_gt > 0 ? static_cast<double>(tp) / num_gt : 0.0);
+    }
+    double ap = 0.0;
+    double previous = 0.0;
+    for (size_t k = 0; k < all.size(); ++k) {
+        double best = 0.0;
+        for (size_t m = k; m < all.size(); ++m) best = std::max(best, precision[m]);
+        ap += (recall[k] - previous) * best;
+        previous = recall[k];
+    }
+    return static_cast<float>(ap);
+}
+
+bool sameResult(const EvaluationResult& a, const EvaluationResult& b) {
+    if (a.classes.size() != b.classes.size() || a.num_frames != b.num_frames) return false;
+    for (size_t c = 0; c < a.classes.size(); ++c) {
+        const ClassEvaluation& x = a.classes[c];
+        const ClassEvaluation& y = b.classes[c];
+        if (x.class_id != y.class_id || x.num_ground_truth != y.num_ground_truth ||
+            x.num_detections != y.num_detections || x.ap != y.ap) {
+            return false;
+        }
+        for (size_t t = 0; t < x.curves.size(); ++t) {
+            if (x.curves[t].precision != y.curves[t].precision || x.curves[t].recall != y.curves[t].recall ||
+                x.curves[t].scores != y.curves[t].scores) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool testHandComputed() {
+    std::cout << "\n=== 测试手工计算的AP ===" << std::endl;
+    // 3个真值框；检测依次为：TP、误检、TP、沿x偏移1（IoU = 3/5）
+    EvalFrame frame;
+    frame.ground_truth.push_back(makeBox(0.0f, 0.0f, 0, 1.0f));
+    frame.ground_truth.push_back(makeBox(10.0f, 0.0f, 0, 1.0f));
+    frame.ground_truth.push_back(makeBox(20.0f, 0.0f, 0, 1.0f));
+    frame.detections.push_back(makeBox(21.0f, 0.0f, 0, 0.6f));
+    frame.detections.push_back(makeBox(0.0f, 0.0f, 0, 0.9f));
+    frame.detections.push_back(makeBox(10.0f, 0.0f, 0, 0.7f));
+    frame.detections.push_back(makeBox(100.0f, 0.0f, 0, 0.8f));
+    std::vector<EvalFrame> frames(1, frame);
+
+    EvalConfig config;
+    config.iou_thresholds = {0.5f, 0.7f};
+    config.num_recall_points = 0;
+    EvaluationResult result = evaluate(frames, config);
+    if (result.classes.size() != 1 || result.classes[0].num_ground_truth != 3) return false;
+    const ClassEvaluation& evaluation = result.classes[0];
+    std::cout << "  AP@0.5 = " << evaluation.ap[0] << ", AP@0.7 = " << evaluation.ap[1] << std::endl;
+    // 0.5：精度1, 1/2, 2/3, 3/4，召回1/3, 1/3, 2/3, 1
+    if (!near(evaluation.ap[0], (1.0f + 0.75f + 0.75f) / 3.0f)) return false;
+    // 0.7：最后一个检测变为误检
+    if (!near(evaluation.ap[1], (1.0f + 2.0f / 3.0f) / 3.0f)) return false;
+
+    const PRCurve& curve = evaluation.curves[0];
+    if (curve.scores.size() != 4 || curve.scores[0] != 0.9f || curve.scores[3] != 0.6f) return false;
+    if (!near(curve.precision[1], 0.5f) || !near(curve.recall[3], 1.0f)) return false;
+
+    // R40：召回点1/40..13/40取精度1，其余27个取0.75
+    config.num_recall_points = 40;
+    result = evaluate(frames, config);
+    if (!near(result.classes[0].ap[0], (13.0f + 27.0f * 0.75f) / 40.0f)) return false;
+
+    std::cout << "✓ AP与手工计算一致" << std::endl;
+    return true;
+}
+
+bool testDuplicatesAndClasses() {
+    std::cout << "\n=== 测试重复检测与类别 ===" << std::endl;
+    EvalFrame frame;
+    frame.ground_truth.push_back(makeBox(0.0f, 0.0f, 0, 1.0f));
+    frame.ground_truth.push_back(makeBox(10.0f, 0.0f, 2, 1.0f));
+    // 同一真值框上的第二个检测是误检
+    frame.detections.push_back(makeBox(0.0f, 0.0f, 0, 0.9f));
+    frame.detections.push_back(makeBox(0.1f, 0.0f, 0, 0.8f));
+    // 类别不同，不能匹配类别2的真值框
+    frame.detections.push_back(makeBox(10.0f, 0.0f, 1, 0.9f));
+    std::vector<EvalFrame> frames(1, frame);
+
+    EvalConfig config;
+    config.iou_thresholds = {0.5f};
+    config.num_recall_points = 0;
+    EvaluationResult result = evaluate(frames, config);
+    if (result.classes.size() != 3) return false;
+    const ClassEvaluation& class0 = result.classes[0];
+    const ClassEvaluation& class1 = result.classes[1];
+    const ClassEvaluation& class2 = result.classes[2];
+    if (class0.class_id != 0 || class1.class_id != 1 || class2.class_id != 2) return false;
+    if (!near(class0.ap[0], 1.0f) || !near(class0.curves[0].precision[1], 0.5f)) return false;
+    if (class1.num_ground_truth != 0 || class1.num_detections != 1 || class1.ap[0] != 0.0f) return false;
+    if (class2.num_ground_truth != 1 || class2.num_detections != 0 || class2.ap[0] != 0.0f) return false;
+    // 类别1没有真值框，不参与mAP
+    if (!near(result.meanAP(0), 0.5f)) return false;
+
+    // 空输入
+    EvaluationResult empty = evaluate(std::vector<EvalFrame>(), config);
+    if (!empty.classes.empty() || empty.meanAP(0) != 0.0f) return false;
+
+    std::cout << "✓ 重复检测与类别处理正确" << std::endl;
+    return true;
+}
+
+bool testRandomFrames() {
+    std::cout << "\n=== 测试随机帧（与参考实现、并行结果比较） ===" << std::endl;
+    std::mt19937 rng(19);
+    std::uniform_real_distribution<float> position(0.0f, 40.0f);
+    std::uniform_real_distribution<float> jitter(-0.8f, 0.8f);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::uniform_real_distribution<float> angle(-0.3f, 0.3f);
+    std::uniform_int_distribution<int> class_dist(0, 2);
+
+    std::vector<EvalFrame> frames(200);
+    for (size_t f = 0; f < frames.size(); ++f) {
+        for (int k = 0; k < 12; ++k) {
+            Box gt = makeBox(position(rng), position(rng), class_dist(rng), 1.0f);
+            gt.yaw = angle(rng);
+            frames[f].ground_truth.push_back(gt);
+            // 大部分真值框有一个带噪声的检测，部分有重复检测
+            int copies = unit(rng) < 0.8f ? 1 : 0;
+            copies += unit(rng) < 0.2f ? 1 : 0;
+            for (int c = 0; c < copies; ++c) {
+                Box det = gt;
+                det.center_x += jitter(rng);
+                det.center_z += jitter(rng);
+                det.yaw += angle(rng);
+                det.confidence = unit(rng);
+                frames[f].detections.push_back(det);
+            }
+        }
+        // 误检
+        for (int k = 0; k < 4; ++k) {
+            frames[f].detections.push_back(makeBox(position(rng), position(rng), class_dist(rng), unit(rng) * 0.5f));
+        }
+    }
+
+    EvalConfig config;
+    config.iou_thresholds = {0.3f, 0.5f, 0.7f};
+    config.num_recall_points = 0;
+    EvaluationResult serial = evaluate(frames, config);
+
+    for (size_t c = 0; c < serial.classes.size(); ++c) {
+        for (size_t t = 0; t < config.iou_thresholds.size(); ++t) {
+            float reference = referenceAP(frames, serial.classes[c].class_id, config.iou_thresholds[t]);
+            if (!near(serial.classes[c].ap[t], reference, 1e-4f)) {
+                std::cerr << "  类别 " << serial.classes[c].class_id << " 阈值 " << config.iou_thresholds[t]
+                          << ": " << serial.classes[c].ap[t] << " vs " << reference << std::endl;
+                return false;
+            }
+        }
+    }
+    std::cout << "  mAP@0.3/0.5/0.7 = " << serial.meanAP(0) << " / " << serial.meanAP(1) << " / "
+              << serial.meanAP(2) << std::endl;
+    // 阈值越高AP越低
+    if (!(serial.meanAP(0) >= serial.meanAP(1) && serial.meanAP(1) >= serial.meanAP(2))) return false;
+
+    ThreadPool pool(4);
+    if (!sameResult(serial, evaluate(frames, config, pool))) return false;
+
+    // 逐帧加入与批量加入一致
+    Evaluator evaluator(config);
+    for (size_t f = 0; f < frames.size(); ++f) {
+        evaluator.addFrame(frames[f].ground_truth, frames[f].detections);
+    }
+    if (evaluator.numFrames() != frames.size() || !sameResult(serial, evaluator.result())) return false;
+    evaluator.clear();
+    if (evaluator.numFrames() != 0 || !evaluator.result().classes.empty()) return false;
+
+    std::cout << "✓ 与参考实现一致，并行结果与串行相同" << std::endl;
+    return true;
+}
+
+int main() {
+    std::cout << "开始评估测试..." << std::endl;
+
+    bool ok = testHandComputed() && testDuplicatesAndClasses() && testRandomFrames();
+    if (!ok) {
+        std::cerr << "❌ 评估测试失败" << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n✓ 评估测试全部通过" << std::endl;
+    return 0;
+}
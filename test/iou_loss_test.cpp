@@ -0,0 +1,238 @@
+#include "iou_loss.h"
+#include "executor.h"
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <algorithm>
+
+using namespace nms;
+
+namespace {
+
+Box makeBox(float x, float y, float z, float l, float w, float h, float yaw) {
+    Box box;
+    box.class_id = 0;
+    box.center_x = x;
+    box.center_y = y;
+    box.center_z = z;
+    box.length = l;
+    box.width = w;
+    box.height = h;
+    box.yaw = yaw;
+    box.confidence = 1.0f;
+    return box;
+}
+
+float* parameter(Box& box, int index) {
+    float* fields[] = {&box.center_x, &box.center_y, &box.center_z,
+                       &box.length, &box.width, &box.height, &box.yaw};
+    return fields[index];
+}
+
+float gradientComponent(const BoxGradient& gradient, int index) {
+    const float values[] = {gradient.center_x, gradient.center_y, gradient.center_z,
+                            gradient.length, gradient.width, gradient.height, gradient.yaw};
+    return values[index];
+}
+
+const char* kParamNames[] = {"center_x", "center_y", "center_z", "length", "width", "height", "yaw"};
+
+// CIoU的长宽比项v
+double aspectTerm(const Box& pred, const Box& target) {
+    const double pi = 3.14159265358979323846;
+    double delta = std::atan2(target.length, target.width) - std::atan2(pred.length, pred.width);
+    return 4.0 / (pi * pi) * delta * delta;
+}
+
+/**
+ * @brief 有限差分使用的损失：CIoU的alpha按定义视为常数，固定为pred处的值
+ */
+double lossForDifference(const Box& pred, const Box& target, const Box& base,
+                         IoULossType loss_type, IoUType iou_type) {
+    if (loss_type != IoULossType::CIOU) {
+        return calculateIoULoss(pred, target, loss_type, iou_type);
+    }
+    IoUMetrics metrics = calculateIoUMetrics(base, target, iou_type);
+    double v = aspectTerm(base, target);
+    double alpha = v > 0.0 ? (metrics.diou - metrics.ciou) / v : 0.0;
+    return 1.0 - calculateIoUMetrics(pred, target, iou_type).diou + alpha * aspectTerm(pred, target);
+}
+
+} // namespace
+
+bool testMetricsMatchIoU() {
+    std::cout << "\n=== 测试IoU与calculateIoU3D/BEV一致 ===" << std::endl;
+
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> position(-3.0f, 3.0f);
+    std::uniform_real_distribution<float> size(0.5f, 5.0f);
+    std::uniform_real_distribution<float> angle(-3.2f, 3.2f);
+
+    float max_error = 0.0f;
+    for (int i = 0; i < 2000; ++i) {
+        Box pred = makeBox(position(rng), 0.3f * position(rng), position(rng), size(rng), size(rng), size(rng), angle(rng));
+        Box target = makeBox(position(rng), 0.3f * position(rng), position(rng), size(rng), size(rng), size(rng), angle(rng));
+
+        IoUMetrics metrics3d = calculateIoUMetrics(pred, target, IoUType::IOU_3D);
+        IoUMetrics metrics_bev = calculateIoUMetrics(pred, target, IoUType::BEV);
+        max_error = std::max(max_error, std::abs(metrics3d.iou - calculateIoU3D(pred, target)));
+        max_error = std::max(max_error, std::abs(metrics_bev.iou - calculateBEVIoU(pred, target)));
+
+        // GIoU、DIoU、CIoU不超过IoU，且不低于-1
+        const IoUMetrics all[] = {metrics3d, metrics_bev};
+        for (const IoUMetrics& m : all) {
+            if (m.giou > m.iou + 1e-6f || m.diou > m.iou + 1e-6f || m.ciou > m.diou + 1e-6f) return false;
+            if (m.giou < -1.0f - 1e-6f || m.diou < -1.0f - 1e-6f) return false;
+        }
+    }
+
+    std::cout << "  最大误差: " << max_error << std::endl;
+    if (max_error > 1e-5f) return false;
+
+    std::cout << "✓ IoU一致" << std::endl;
+    return true;
+}
+
+bool testSpecialCases() {
+    std::cout << "\n=== 测试特殊情况 ===" << std::endl;
+
+    Box box = makeBox(1.0f, 0.0f, 2.0f, 4.0f, 2.0f, 1.5f, 0.7f);
+    IoUMetrics same = calculateIoUMetrics(box, box);
+    if (std::abs(same.iou - 1.0f) > 1e-6f || std::abs(same.giou - 1.0f) > 1e-6f ||
+        std::abs(same.diou - 1.0f) > 1e-6f || std::abs(same.ciou - 1.0f) > 1e-6f) {
+        return false;
+    }
+
+    // 不相交：IoU为0，GIoU/DIoU为负且仍有非零梯度，把预测框拉向目标
+    Box far = makeBox(8.0f, 0.0f, 2.0f, 4.0f, 2.0f, 1.5f, 0.7f);
+    IoUMetrics disjoint = calculateIoUMetrics(far, box);
+    std::cout << "  不相交: IoU=" << disjoint.iou << ", GIoU=" << disjoint.giou << ", DIoU=" << disjoint.diou << std::endl;
+    if (disjoint.iou != 0.0f || disjoint.giou >= 0.0f || disjoint.diou >= 0.0f) return false;
+
+    BoxGradient gradient;
+    calculateIoULoss(far, box, IoULossType::GIOU, IoUType::IOU_3D, &gradient);
+    if (!(gradient.center_x > 0.0f)) return false;
+    calculateIoULoss(far, box, IoULossType::DIOU, IoUType::IOU_3D, &gradient);
+    if (!(gradient.center_x > 0.0f)) return false;
+    calculateIoULoss(far, box, IoULossType::IOU, IoUType::IOU_3D, &gradient);
+    if (gradient.center_x != 0.0f) return false;
+
+    std::cout << "✓ 特殊情况正确" << std::endl;
+    return true;
+}
+
+bool testGradientsAgainstFiniteDifference() {
+    std::cout << "\n=== 测试解析梯度与有限差分一致 ===" << std::endl;
+
+    std::mt19937 rng(19);
+    std::uniform_real_distribution<float> offset(-1.2f, 1.2f);
+    std::uniform_real_distribution<float> size(1.0f, 5.0f);
+    std::uniform_real_distribution<float> angle(-3.2f, 3.2f);
+
+    const IoULossType losses[] = {IoULossType::IOU, IoULossType::GIOU, IoULossType::DIOU, IoULossType::CIOU};
+    const IoUType types[] = {IoUType::BEV, IoUType::IOU_3D};
+    const float step = 1e-3f;
+
+    int checked = 0;
+    int skipped = 0;
+    float max_error = 0.0f;
+    for (int i = 0; i < 200; ++i) {
+        Box target = makeBox(10.0f, 0.5f, -5.0f, size(rng), size(rng), size(rng), angle(rng));
+        Box pred = makeBox(10.0f + offset(rng), 0.5f + 0.3f * offset(rng), -5.0f + offset(rng),
+                           size(rng), size(rng), size(rng), angle(rng));
+
+        for (IoULossType loss_type : losses) {
+            for (IoUType iou_type : types) {
+                BoxGradient gradient;
+                calculateIoULoss(pred, target, loss_type, iou_type, &gradient);
+                double loss = lossForDifference(pred, target, pred, loss_type, iou_type);
+
+                for (int p = 0; p < 7; ++p) {
+                    Box plus = pred;
+                    Box minus = pred;
+                    *parameter(plus, p) += step;
+                    *parameter(minus, p) -= step;
+                    float h_plus = *parameter(plus, p) - *parameter(pred, p);
+                    float h_minus = *parameter(pred, p) - *parameter(minus, p);
+                    double loss_plus = lossForDifference(plus, target, pred, loss_type, iou_type);
+                    double loss_minus = lossForDifference(minus, target, pred, loss_type, iou_type);
+                    float forward = static_cast<float>((loss_plus - loss) / h_plus);
+                    float backward = static_cast<float>((loss - loss_minus) / h_minus);
+
+                    // 两侧差分相差过大说明该点附近不可导（顶点来源变化），跳过
+                    if (std::abs(forward - backward) > 2e-3f) {
+                        ++skipped;
+                        continue;
+                    }
+                    float numeric = static_cast<float>((loss_plus - loss_minus) / (h_plus + h_minus));
+                    float analytic = gradientComponent(gradient, p);
+                    float error = std::abs(numeric - analytic);
+                    max_error = std::max(max_error, error);
+                    ++checked;
+                    if (error > 2e-3f + 1e-2f * std::abs(numeric)) {
+                        std::cerr << "  梯度不一致: 第" << i << "组 " << kParamNames[p]
+                                  << " 解析=" << analytic << " 数值=" << numeric << std::endl;
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+
+    std::cout << "  检查 " << checked << " 个分量，跳过 " << skipped << " 个不可导点，最大误差: " << max_error << std::endl;
+    if (skipped * 20 > checked) return false;
+
+    std::cout << "✓ 梯度正确" << std::endl;
+    return true;
+}
+
+bool testBatchMatchesSingle() {
+    std::cout << "\n=== 测试批量接口 ===" << std::endl;
+
+    std::mt19937 rng(29);
+    std::uniform_real_distribution<float> position(-2.0f, 2.0f);
+    std::uniform_real_distribution<float> size(1.0f, 4.0f);
+    std::uniform_real_distribution<float> angle(-3.2f, 3.2f);
+
+    std::vector<Box> preds;
+    std::vector<Box> targets;
+    for (int i = 0; i < 3000; ++i) {
+        preds.push_back(makeBox(position(rng), 0.0f, position(rng), size(rng), size(rng), 1.5f, angle(rng)));
+        targets.push_back(makeBox(position(rng), 0.2f, position(rng), size(rng), size(rng), 1.5f, angle(rng)));
+    }
+
+    std::vector<float> losses(preds.size());
+    std::vector<BoxGradient> gradients(preds.size());
+    ThreadPool pool(3);
+    calculateIoULossBatch(preds, targets, IoULossType::CIOU, IoUType::IOU_3D, losses.data(), gradients.data(), pool);
+
+    std::vector<IoUMetrics> metrics(preds.size());
+    calculateIoUMetricsBatch(preds, targets, IoUType::IOU_3D, metrics.data());
+
+    for (size_t i = 0; i < preds.size(); ++i) {
+        BoxGradient gradient;
+        float loss = calculateIoULoss(preds[i], targets[i], IoULossType::CIOU, IoUType::IOU_3D, &gradient);
+        if (loss != losses[i] || gradient.yaw != gradients[i].yaw || gradient.length != gradients[i].length) {
+            return false;
+        }
+        if (1.0f - metrics[i].ciou != loss) return false;
+    }
+
+    std::cout << "✓ 批量结果与逐对结果一致" << std::endl;
+    return true;
+}
+
+int main() {
+    std::cout << "开始IoU损失测试..." << std::endl;
+
+    bool ok = testMetricsMatchIoU() && testSpecialCases() &&
+              testGradientsAgainstFiniteDifference() && testBatchMatchesSingle();
+    if (!ok) {
+        std::cerr << "❌ IoU损失测试失败" << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n✓ IoU损失测试全部通过" << std::endl;
+    return 0;
+}
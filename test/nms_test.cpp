@@ -0,0 +1,392 @@
+#include "nms.h"
+#include "executor.h"
+#include <iostream>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cmath>
+
+using namespace nms;
+
+// 辅助函数：创建测试用的Box
+Box createBox(float center_x, float center_z, float length, float width,
+              float yaw, float confidence, int class_id = 0, float center_y = 0.0f) {
+    Box box;
+    box.class_name = "test";
+    box.class_id = class_id;
+    box.center_x = center_x;
+    box.center_y = center_y;
+    box.center_z = center_z;
+    box.length = length;
+    box.width = width;
+    box.height = 1.5f;
+    box.yaw = yaw;
+    box.confidence = confidence;
+    return box;
+}
+
+// 随机生成聚集在若干中心附近的包围盒，模拟检测网络NMS之前的输出
+std::vector<Box> generateClusteredBoxes(size_t count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> position(-30.0f, 30.0f);
+    std::uniform_real_distribution<float> jitter(-0.6f, 0.6f);
+    std::uniform_real_distribution<float> angle(-3.14159f, 3.14159f);
+    std::uniform_real_distribution<float> score(0.05f, 1.0f);
+    std::uniform_int_distribution<int> cls(0, 2);
+
+    std::vector<Box> boxes;
+    while (boxes.size() < count) {
+        float cx = position(rng);
+        float cz = position(rng);
+        float yaw = angle(rng);
+        int class_id = cls(rng);
+        for (int k = 0; k < 8 && boxes.size() < count; ++k) {
+            boxes.push_back(createBox(cx + jitter(rng), cz + jitter(rng), 4.0f + jitter(rng), 2.0f + jitter(rng) * 0.5f,
+                                      yaw + jitter(rng) * 0.3f, score(rng), class_id, jitter(rng)));
+        }
+    }
+    return boxes;
+}
+
+// 参考实现：朴素的O(N^2)贪心NMS
+std::vector<int> referenceNMS(const std::vector<Box>& boxes, const NMSConfig& config) {
+    std::vector<int> order;
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        if (boxes[i].confidence >= config.score_threshold) {
+            order.push_back(static_cast<int>(i));
+        }
+    }
+    std::stable_sort(order.begin(), order.end(), [&boxes](int a, int b) {
+        return boxes[a].confidence > boxes[b].confidence;
+    });
+    if (config.pre_max_size > 0 && order.size() > static_cast<size_t>(config.pre_max_size)) {
+        order.resize(config.pre_max_size);
+    }
+
+    std::vector<int> keep;
+    std::vector<bool> suppressed(order.size(), false);
+    for (size_t i = 0; i < order.size(); ++i) {
+        if (suppressed[i]) continue;
+        keep.push_back(order[i]);
+        if (config.post_max_size > 0 && keep.size() >= static_cast<size_t>(config.post_max_size)) break;
+        for (size_t j = i + 1; j < order.size(); ++j) {
+            const Box& a = boxes[order[i]];
+            const Box& b = boxes[order[j]];
+            if (config.class_aware && a.class_id != b.class_id) continue;
+            float iou = config.iou_type == IoUType::IOU_3D ? calculateIoU3D(a, b) : calculateBEVIoU(a, b);
+            if (iou > config.iou_threshold) suppressed[j] = true;
+        }
+    }
+    return keep;
+}
+
+bool testBasicSuppression() {
+    std::cout << "\n=== 测试基本抑制 ===" << std::endl;
+
+    std::vector<Box> boxes = {
+        createBox(0.0f, 0.0f, 4.0f, 2.0f, 0.0f, 0.9f),
+        createBox(0.2f, 0.1f, 4.0f, 2.0f, 0.05f, 0.8f),   // 与第0个高度重叠
+        createBox(10.0f, 0.0f, 4.0f, 2.0f, 0.0f, 0.7f),   // 远离
+        createBox(0.1f, 0.0f, 4.0f, 2.0f, 0.0f, 0.95f, 1) // 不同类别
+    };
+
+    NMSConfig config;
+    std::vector<int> keep = nonMaximumSuppression(boxes, config);
+    std::vector<int> expected = {3, 0, 2};
+    std::cout << "类别感知保留: " << keep.size() << " 个框" << std::endl;
+    if (keep != expected) return false;
+
+    config.class_aware = false;
+    keep = nonMaximumSuppression(boxes, config);
+    expected = {3, 2};
+    std::cout << "类别无关保留: " << keep.size() << " 个框" << std::endl;
+    if (keep != expected) return false;
+
+    config.post_max_size = 1;
+    keep = nonMaximumSuppression(boxes, config);
+    if (keep.size() != 1 || keep[0] != 3) return false;
+
+    config = NMSConfig();
+    config.score_threshold = 0.85f;
+    keep = nonMaximumSuppression(boxes, config);
+    expected = {3, 0};
+    if (keep != expected) return false;
+
+    std::cout << "✓ 基本抑制正确" << std::endl;
+    return true;
+}
+
+bool testHeightSeparation() {
+    std::cout << "\n=== 测试3D模式下高度分离的框 ===" << std::endl;
+
+    std::vector<Box> boxes = {
+        createBox(0.0f, 0.0f, 4.0f, 2.0f, 0.0f, 0.9f),
+        createBox(0.0f, 0.0f, 4.0f, 2.0f, 0.0f, 0.8f, 0, 3.0f)
+    };
+
+    NMSConfig config;
+    config.iou_type = IoUType::BEV;
+    if (nonMaximumSuppression(boxes, config).size() != 1) return false;
+
+    config.iou_type = IoUType::IOU_3D;
+    if (nonMaximumSuppression(boxes, config).size() != 2) return false;
+
+    std::cout << "✓ BEV模式抑制，3D模式保留" << std::endl;
+    return true;
+}
+
+bool testAgainstReference() {
+    std::cout << "\n=== 与朴素实现对比 ===" << std::endl;
+
+    std::vector<Box> boxes = generateClusteredBoxes(600, 42);
+    const IoUType types[] = {IoUType::BEV, IoUType::IOU_3D};
+    const float thresholds[] = {0.1f, 0.3f, 0.5f};
+
+    for (IoUType type : types) {
+        for (float threshold : thresholds) {
+            for (int class_aware = 0; class_aware < 2; ++class_aware) {
+                NMSConfig config;
+                config.iou_type = type;
+                config.iou_threshold = threshold;
+                config.class_aware = class_aware != 0;
+                config.score_threshold = 0.1f;
+                config.pre_max_size = 500;
+                config.post_max_size = 80;
+
+                std::vector<int> keep = nonMaximumSuppression(boxes, config);
+                std::vector<int> expected = referenceNMS(boxes, config);
+                if (keep != expected) {
+                    std::cout << "✗ 结果不一致: threshold=" << threshold << ", class_aware=" << class_aware << std::endl;
+                    return false;
+                }
+            }
+        }
+    }
+
+    std::cout << "✓ 与朴素实现结果一致" << std::endl;
+    return true;
+}
+
+// 参考实现：每轮取当前最高分并衰减其余所有框的朴素Soft-NMS
+SoftNMSResult referenceSoftNMS(const std::vector<Box>& boxes, const SoftNMSConfig& config) {
+    std::vector<int> order;
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        if (boxes[i].confidence >= config.score_threshold) {
+            order.push_back(static_cast<int>(i));
+        }
+    }
+    std::stable_sort(order.begin(), order.end(), [&boxes](int a, int b) {
+        return boxes[a].confidence > boxes[b].confidence;
+    });
+
+    std::vector<float> scores;
+    for (int index : order) scores.push_back(boxes[index].confidence);
+    std::vector<bool> done(order.size(), false);
+
+    SoftNMSResult result;
+    while (true) {
+        int best = -1;
+        for (size_t i = 0; i < order.size(); ++i) {
+            if (!done[i] && (best < 0 || scores[i] > scores[best])) best = static_cast<int>(i);
+        }
+        if (best < 0) break;
+        done[best] = true;
+        result.indices.push_back(order[best]);
+        result.scores.push_back(scores[best]);
+        if (config.post_max_size > 0 && result.indices.size() >= static_cast<size_t>(config.post_max_size)) break;
+
+        for (size_t j = 0; j < order.size(); ++j) {
+            if (done[j]) continue;
+            const Box& a = boxes[order[best]];
+            const Box& b = boxes[order[j]];
+            if (config.class_aware && a.class_id != b.class_id) continue;
+            float iou = config.iou_type == IoUType::IOU_3D ? calculateIoU3D(a, b) : calculateBEVIoU(a, b);
+            if (config.method == SoftNMSMethod::GAUSSIAN) {
+                scores[j] *= std::exp(-iou * iou / config.sigma);
+            } else if (iou > config.iou_threshold) {
+                scores[j] *= 1.0f - iou;
+            }
+            if (scores[j] < config.score_threshold) done[j] = true;
+        }
+    }
+    return result;
+}
+
+bool testSoftNMSAgainstReference() {
+    std::cout << "\n=== Soft-NMS与朴素实现对比 ===" << std::endl;
+
+    std::vector<Box> boxes = generateClusteredBoxes(400, 7);
+    const SoftNMSMethod methods[] = {SoftNMSMethod::LINEAR, SoftNMSMethod::GAUSSIAN};
+    const IoUType types[] = {IoUType::BEV, IoUType::IOU_3D};
+
+    for (SoftNMSMethod method : methods) {
+        for (IoUType type : types) {
+            SoftNMSConfig config;
+            config.method = method;
+            config.iou_type = type;
+            config.score_threshold = 0.05f;
+
+            SoftNMSResult result = softNonMaximumSuppression(boxes, config);
+            SoftNMSResult expected = referenceSoftNMS(boxes, config);
+            if (result.indices != expected.indices) {
+                std::cout << "✗ Soft-NMS保留顺序不一致" << std::endl;
+                return false;
+            }
+            for (size_t k = 0; k < result.scores.size(); ++k) {
+                if (std::abs(result.scores[k] - expected.scores[k]) > 1e-6f) return false;
+            }
+            std::cout << "  保留 " << result.indices.size() << " 个框" << std::endl;
+        }
+    }
+
+    // 线性衰减：完全重合的框分数降为0并被丢弃
+    std::vector<Box> duplicates = {
+        createBox(0.0f, 0.0f, 4.0f, 2.0f, 0.0f, 0.9f),
+        createBox(0.0f, 0.0f, 4.0f, 2.0f, 0.0f, 0.8f),
+        createBox(0.5f, 0.0f, 4.0f, 2.0f, 0.0f, 0.7f)
+    };
+    SoftNMSConfig linear;
+    linear.method = SoftNMSMethod::LINEAR;
+    SoftNMSResult result = softNonMaximumSuppression(duplicates, linear);
+    if (result.indices != std::vector<int>({0, 2})) return false;
+    float expected_score = 0.7f * (1.0f - calculateBEVIoU(duplicates[0], duplicates[2]));
+    if (std::abs(result.scores[1] - expected_score) > 1e-6f) return false;
+
+    std::cout << "✓ Soft-NMS结果正确" << std::endl;
+    return true;
+}
+
+bool testWeightedBoxFusion() {
+    std::cout << "\n=== 测试加权框融合 ===" << std::endl;
+
+    // 两个重叠框按置信度加权平均，远处的框单独成簇
+    std::vector<Box> boxes = {
+        createBox(0.0f, 0.0f, 4.0f, 2.0f, 0.1f, 0.6f),
+        createBox(0.3f, 0.0f, 4.4f, 2.0f, 0.2f, 0.3f),
+        createBox(20.0f, 0.0f, 4.0f, 2.0f, 0.0f, 0.5f)
+    };
+    std::vector<Box> fused = weightedBoxFusion(boxes);
+    if (fused.size() != 2) return false;
+    const Box& merged = fused[1];
+    std::cout << "  融合框: x=" << merged.center_x << ", length=" << merged.length
+              << ", yaw=" << merged.yaw << ", confidence=" << merged.confidence << std::endl;
+    if (std::abs(merged.center_x - 0.1f) > 1e-5f) return false;
+    if (std::abs(merged.length - (4.0f * 0.6f + 4.4f * 0.3f) / 0.9f) > 1e-5f) return false;
+    if (std::abs(merged.confidence - 0.45f) > 1e-6f) return false;
+    if (fused[0].center_x != 20.0f || fused[0].confidence != 0.5f) return false;
+
+    // 两个模型的集成：单成员簇的置信度减半
+    WBFConfig config;
+    config.num_models = 2;
+    fused = weightedBoxFusion(boxes, config);
+    if (std::abs(fused[0].confidence - 0.45f) > 1e-6f || std::abs(fused[1].confidence - 0.25f) > 1e-6f) {
+        return false;
+    }
+
+    // yaw在±π两侧时取圆周平均，而不是平均到0附近
+    std::vector<Box> wrapped = {
+        createBox(0.0f, 0.0f, 4.0f, 2.0f, 3.1f, 0.5f),
+        createBox(0.0f, 0.0f, 4.0f, 2.0f, -3.1f, 0.5f)
+    };
+    fused = weightedBoxFusion(wrapped);
+    if (fused.size() != 1 || std::abs(std::abs(fused[0].yaw) - 3.14159265f) > 1e-4f) return false;
+
+    // 朝向相反的检测先对齐再平均
+    std::vector<Box> flipped = {
+        createBox(0.0f, 0.0f, 4.0f, 2.0f, 0.2f, 0.5f),
+        createBox(0.0f, 0.0f, 4.0f, 2.0f, 0.2f - 3.14159265f, 0.5f)
+    };
+    fused = weightedBoxFusion(flipped);
+    if (fused.size() != 1 || std::abs(fused[0].yaw - 0.2f) > 1e-4f) return false;
+
+    // 大量聚集框：簇数不超过框数，每个输入框都被融合
+    std::vector<Box> clustered = generateClusteredBoxes(800, 3);
+    fused = weightedBoxFusion(clustered);
+    std::cout << "  800个聚集框融合为 " << fused.size() << " 个" << std::endl;
+    if (fused.empty() || fused.size() >= clustered.size()) return false;
+    for (size_t k = 1; k < fused.size(); ++k) {
+        if (fused[k - 1].confidence < fused[k].confidence) return false;
+    }
+
+    std::cout << "✓ 加权框融合正确" << std::endl;
+    return true;
+}
+
+bool testDistanceIoUSuppression() {
+    std::cout << "\n=== 测试DIoU抑制 ===" << std::endl;
+
+    std::vector<Box> boxes = generateClusteredBoxes(600, 11);
+    NMSConfig config;
+    config.iou_threshold = 0.3f;
+    std::vector<int> plain = nonMaximumSuppression(boxes, config);
+
+    config.use_distance_iou = true;
+    std::vector<int> serial = nonMaximumSuppression(boxes, config);
+    SerialExecutor executor;
+    std::vector<int> grid = nonMaximumSuppression(boxes, config, executor);
+    std::cout << "  IoU保留 " << plain.size() << " 个，DIoU保留 " << serial.size() << " 个" << std::endl;
+    if (serial != grid) return false;
+    if (serial.size() < plain.size()) return false;
+
+    // IoU相同时，中心错开的框对受到距离惩罚
+    std::vector<Box> pair = {
+        createBox(0.0f, 0.0f, 4.0f, 2.0f, 0.0f, 0.9f),
+        createBox(1.6f, 0.0f, 4.0f, 2.0f, 0.0f, 0.8f)
+    };
+    config = NMSConfig();
+    config.iou_threshold = 0.4f;
+    if (nonMaximumSuppression(pair, config).size() != 1) return false;
+    config.use_distance_iou = true;
+    if (nonMaximumSuppression(pair, config).size() != 2) return false;
+
+    std::cout << "✓ DIoU抑制正确" << std::endl;
+    return true;
+}
+
+bool testBitmaskNMS() {
+    std::cout << "\n=== 测试位图NMS ===" << std::endl;
+
+    // 框数不是64的整数倍，覆盖不完整的末尾块
+    std::vector<Box> boxes = generateClusteredBoxes(700, 23);
+    const IoUType types[] = {IoUType::BEV, IoUType::IOU_3D};
+    ThreadPool pool(4);
+
+    for (IoUType type : types) {
+        for (int variant = 0; variant < 4; ++variant) {
+            NMSConfig config;
+            config.iou_type = type;
+            config.iou_threshold = variant % 2 ? 0.2f : 0.5f;
+            config.class_aware = variant < 2;
+            config.use_distance_iou = variant == 3;
+            config.score_threshold = 0.1f;
+            config.post_max_size = variant == 1 ? 50 : -1;
+
+            std::vector<int> expected = nonMaximumSuppression(boxes, config);
+            if (bitmaskNonMaximumSuppression(boxes, config) != expected) return false;
+            if (bitmaskNonMaximumSuppression(boxes, config, pool) != expected) return false;
+        }
+    }
+
+    std::vector<Box> empty;
+    if (!bitmaskNonMaximumSuppression(empty).empty()) return false;
+    std::vector<Box> single(1, createBox(0.0f, 0.0f, 4.0f, 2.0f, 0.0f, 0.9f));
+    if (bitmaskNonMaximumSuppression(single).size() != 1) return false;
+
+    std::cout << "✓ 位图NMS与贪心NMS结果一致" << std::endl;
+    return true;
+}
+
+int main() {
+    std::cout << "开始NMS测试..." << std::endl;
+
+    bool ok = testBasicSuppression() && testHeightSeparation() && testAgainstReference() &&
+              testSoftNMSAgainstReference() && testWeightedBoxFusion() && testDistanceIoUSuppression() &&
+              testBitmaskNMS();
+    if (!ok) {
+        std::cerr << "❌ NMS测试失败" << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n✓ NMS测试全部通过" << std::endl;
+    return 0;
+}
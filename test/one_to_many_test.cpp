@@ -0,0 +1,161 @@
+#include "box_batch.h"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <cstring>
+#include <cmath>
+
+using namespace nms;
+
+namespace {
+
+// 格林公式与裁剪多边形两种算法之间允许的IoU差
+const float kTolerance = 1e-4f;
+
+Box makeBox(float x, float z, float length, float width, float yaw) {
+    Box box;
+    box.center_x = x;
+    box.center_z = z;
+    box.length = length;
+    box.width = width;
+    box.yaw = yaw;
+    return box;
+}
+
+// 参考框周围的密集候选框，大部分与参考框重叠
+BoxBatch makeCandidates(const Box& ref, size_t count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> offset(-6.0f, 6.0f);
+    std::uniform_real_distribution<float> size(0.5f, 8.0f);
+    std::uniform_real_distribution<float> yaw(-4.0f, 4.0f);
+    BoxBatch batch;
+    for (size_t i = 0; i < count; ++i) {
+        batch.push_back(makeBox(ref.center_x + offset(rng), ref.center_z + offset(rng), size(rng), size(rng), yaw(rng)));
+    }
+    return batch;
+}
+
+bool matchesPairwise(const Box& ref, const BoxBatch& others, const std::vector<float>& iou, float* max_error) {
+    for (size_t i = 0; i < others.size(); ++i) {
+        float expected = calculateBEVIoU(ref, others.box(i));
+        float error = std::abs(iou[i] - expected);
+        *max_error = std::max(*max_error, error);
+        if (!(error <= kTolerance)) {
+            std::cerr << "  第" << i << "个候选框: " << iou[i] << " != " << expected << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool testSpecialCases() {
+    std::cout << "\n=== 测试特殊位置关系 ===" << std::endl;
+    const Box ref = makeBox(10.0f, -5.0f, 4.0f, 2.0f, 0.0f);
+    const Box rotated = makeBox(10.0f, -5.0f, 4.0f, 2.0f, 0.7f);
+
+    BoxBatch others;
+    others.push_back(ref);                                     // 相同的框：所有边同向共线
+    others.push_back(makeBox(12.0f, -5.0f, 4.0f, 2.0f, 0.0f)); // 平移半个长度：上下边同向共线
+    others.push_back(makeBox(14.0f, -5.0f, 4.0f, 2.0f, 0.0f)); // 只在一条边上接触：反向共线
+    others.push_back(makeBox(10.0f, -5.0f, 2.0f, 1.0f, 0.0f)); // 完全包含
+    others.push_back(makeBox(10.0f, -5.0f, 8.0f, 4.0f, 0.0f)); // 完全被包含
+    others.push_back(makeBox(30.0f, 20.0f, 4.0f, 2.0f, 1.0f)); // 相离
+    others.push_back(makeBox(10.0f, -5.0f, 4.0f, 2.0f, 3.14159265f)); // 旋转180度
+    others.push_back(makeBox(10.0f, -5.0f, 4.0f, 2.0f, 0.5f)); // 同中心旋转
+    others.push_back(makeBox(10.0f, -5.0f, 0.0f, 0.0f, 0.0f)); // 退化为点
+
+    const float expected[9] = {1.0f, 1.0f / 3.0f, 0.0f, 0.25f, 0.25f, 0.0f, 1.0f, -1.0f, 0.0f};
+    std::vector<float> iou(others.size());
+    calculateBEVIoUOneToMany(ref, others, iou.data());
+    for (size_t i = 0; i < others.size(); ++i) {
+        float target = expected[i] >= 0.0f ? expected[i] : calculateBEVIoU(ref, others.box(i));
+        if (!(std::abs(iou[i] - target) <= kTolerance)) {
+            std::cerr << "  第" << i << "个候选框: " << iou[i] << " != " << target << std::endl;
+            return false;
+        }
+    }
+
+    // 旋转后的相同框与沿边接触的框
+    BoxBatch touching;
+    touching.push_back(rotated);
+    float dx = 4.0f * std::cos(0.7f);
+    float dz = -4.0f * std::sin(0.7f);
+    touching.push_back(makeBox(rotated.center_x + dx, rotated.center_z + dz, 4.0f, 2.0f, 0.7f));
+    calculateBEVIoUOneToMany(rotated, touching, iou.data());
+    if (!(std::abs(iou[0] - 1.0f) <= kTolerance) || !(std::abs(iou[1]) <= kTolerance)) {
+        std::cerr << "  旋转后: " << iou[0] << ", " << iou[1] << std::endl;
+        return false;
+    }
+
+    std::cout << "✓ 共线、接触、包含与相离的结果正确" << std::endl;
+    return true;
+}
+
+bool testRandom() {
+    std::cout << "\n=== 测试与逐对计算的一致性 ===" << std::endl;
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+    std::uniform_real_distribution<float> size(0.5f, 8.0f);
+    std::uniform_real_distribution<float> yaw(-4.0f, 4.0f);
+
+    float max_error = 0.0f;
+    size_t overlapping = 0;
+    for (unsigned trial = 0; trial < 40; ++trial) {
+        Box ref = makeBox(position(rng), position(rng), size(rng), size(rng), yaw(rng));
+        // 数量覆盖空输入与不足一个寄存器宽度的尾部
+        size_t count = trial < 34 ? trial : 500;
+        BoxBatch others = makeCandidates(ref, count, trial);
+        std::vector<float> iou(count + 1, -1.0f);
+        calculateBEVIoUOneToMany(ref, others, iou.data());
+        if (iou[count] != -1.0f) return false;
+        if (!matchesPairwise(ref, others, iou, &max_error)) return false;
+        for (size_t i = 0; i < count; ++i) overlapping += iou[i] > 0.0f ? 1 : 0;
+    }
+    std::cout << "  重叠框对: " << overlapping << "，最大误差: " << max_error << std::endl;
+
+    std::cout << "✓ 与calculateBEVIoU的差在容差内" << std::endl;
+    return true;
+}
+
+bool testBackends() {
+    std::cout << "\n=== 测试各SIMD后端 ===" << std::endl;
+    const std::string original = simdBackendName();
+    const Box ref = makeBox(3.0f, 4.0f, 4.5f, 1.8f, 0.3f);
+    BoxBatch others = makeCandidates(ref, 333, 11);
+    others.push_back(ref);
+
+    std::vector<float> expected(others.size());
+    setSimdBackend("scalar");
+    calculateBEVIoUOneToMany(ref, others, expected.data());
+
+    std::vector<std::string> backends = availableSimdBackends();
+    bool ok = true;
+    for (size_t b = 0; b < backends.size() && ok; ++b) {
+        setSimdBackend(backends[b]);
+        std::vector<float> iou(others.size());
+        calculateBEVIoUOneToMany(ref, others.view(), iou.data());
+        ok = std::memcmp(iou.data(), expected.data(), iou.size() * sizeof(float)) == 0;
+        std::cout << "  " << backends[b] << (ok ? " 一致" : " 不一致") << std::endl;
+    }
+    setSimdBackend(original);
+    if (!ok) return false;
+
+    std::cout << "✓ 各后端结果逐位一致" << std::endl;
+    return true;
+}
+
+int main() {
+    std::cout << "开始一对多IoU测试..." << std::endl;
+
+    bool ok = testSpecialCases() && testRandom() && testBackends();
+    if (!ok) {
+        std::cerr << "❌ 一对多IoU测试失败" << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n✓ 一对多IoU测试全部通过" << std::endl;
+    return 0;
+}
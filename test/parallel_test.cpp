@@ -0,0 +1,180 @@
+#include "nms.h"
+#include "executor.h"
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cstring>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <chrono>
+
+using namespace nms;
+
+std::vector<Box> generateBoxes(size_t count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> position(-40.0f, 40.0f);
+    std::uniform_real_distribution<float> jitter(-0.8f, 0.8f);
+    std::uniform_real_distribution<float> angle(-3.14159f, 3.14159f);
+    std::uniform_real_distribution<float> score(0.0f, 1.0f);
+    std::uniform_int_distribution<int> cls(0, 3);
+
+    std::vector<Box> boxes;
+    while (boxes.size() < count) {
+        float cx = position(rng);
+        float cz = position(rng);
+        float yaw = angle(rng);
+        int class_id = cls(rng);
+        for (int k = 0; k < 6 && boxes.size() < count; ++k) {
+            Box box;
+            box.class_name = "test";
+            box.class_id = class_id;
+            box.center_x = cx + jitter(rng);
+            box.center_y = jitter(rng);
+            box.center_z = cz + jitter(rng);
+            box.length = 4.0f + jitter(rng);
+            box.width = 2.0f + jitter(rng) * 0.5f;
+            box.height = 1.5f;
+            box.yaw = yaw + jitter(rng) * 0.2f;
+            box.confidence = score(rng);
+            boxes.push_back(box);
+        }
+    }
+    return boxes;
+}
+
+bool testMatrixDeterminism() {
+    std::cout << "\n=== 测试并行IoU矩阵 ===" << std::endl;
+
+    std::vector<Box> rows = generateBoxes(333, 1);
+    std::vector<Box> cols = generateBoxes(257, 1);
+    std::vector<float> serial_3d(rows.size() * cols.size());
+    std::vector<float> serial_bev(rows.size() * cols.size());
+    calculateIoU3DMatrix(rows, cols, serial_3d.data());
+    calculateBEVIoUMatrix(rows, cols, serial_bev.data());
+
+    const size_t thread_counts[] = {1, 2, 4, 7};
+    for (size_t threads : thread_counts) {
+        ThreadPool pool(threads);
+        std::vector<float> parallel_3d(serial_3d.size(), -1.0f);
+        std::vector<float> parallel_bev(serial_bev.size(), -1.0f);
+        calculateIoU3DMatrix(rows, cols, parallel_3d.data(), pool);
+        calculateBEVIoUMatrix(rows, cols, parallel_bev.data(), pool);
+
+        if (std::memcmp(parallel_3d.data(), serial_3d.data(), serial_3d.size() * sizeof(float)) != 0 ||
+            std::memcmp(parallel_bev.data(), serial_bev.data(), serial_bev.size() * sizeof(float)) != 0) {
+            std::cout << "✗ " << threads << " 线程结果与串行不一致" << std::endl;
+            return false;
+        }
+        std::cout << "  " << threads << " 线程: 结果逐位一致" << std::endl;
+    }
+
+    std::cout << "✓ 并行IoU矩阵结果与线程数无关" << std::endl;
+    return true;
+}
+
+bool testNMSDeterminism() {
+    std::cout << "\n=== 测试并行NMS ===" << std::endl;
+
+    std::vector<Box> boxes = generateBoxes(3000, 5);
+    ThreadPool pool(4);
+    SerialExecutor serial;
+
+    const IoUType types[] = {IoUType::BEV, IoUType::IOU_3D};
+    for (IoUType type : types) {
+        for (int class_aware = 0; class_aware < 2; ++class_aware) {
+            NMSConfig config;
+            config.iou_type = type;
+            config.class_aware = class_aware != 0;
+            config.iou_threshold = 0.2f;
+            config.pre_max_size = 2500;
+            config.post_max_size = 1500;
+
+            std::vector<int> expected = nonMaximumSuppression(boxes, config);
+            std::vector<int> parallel = nonMaximumSuppression(boxes, config, pool);
+            std::vector<int> sequential = nonMaximumSuppression(boxes, config, serial);
+            if (parallel != expected || sequential != expected) {
+                std::cout << "✗ 并行NMS结果与串行不一致" << std::endl;
+                return false;
+            }
+            std::cout << "  保留 " << expected.size() << " 个框" << std::endl;
+        }
+    }
+
+    std::cout << "✓ 并行NMS结果与串行一致" << std::endl;
+    return true;
+}
+
+// 析构时减少计数，异常展开时也会执行
+struct RunningGuard {
+    std::atomic<int>& count;
+    ~RunningGuard() { --count; }
+};
+
+bool testNestingAndExceptions() {
+    std::cout << "\n=== 测试嵌套调用与异常 ===" << std::endl;
+    ThreadPool pool(4);
+
+    // 任务内部（包括调用线程上执行的任务块）再次调用同一个线程池时顺序执行
+    std::atomic<size_t> total(0);
+    pool.parallelFor(64, 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            pool.parallelFor(16, 1, [&](size_t b, size_t e) { total += e - b; });
+        }
+    });
+    if (total.load() != 64 * 16) return false;
+
+    // 每个任务块都抛出异常：只重新抛出一个，且调用返回时所有任务块都已结束。
+    // 工作线程上的任务块比调用线程上的睡眠更久，不等待工作线程就返回的实现会看到running > 0
+    const std::thread::id caller = std::this_thread::get_id();
+    for (int round = 0; round < 5; ++round) {
+        std::atomic<int> running(0);
+        bool caught = false;
+        try {
+            pool.parallelFor(64, 1, [&](size_t, size_t) {
+                ++running;
+                RunningGuard guard = {running};
+                int delay_ms = std::this_thread::get_id() == caller ? 1 : 20;
+                std::this_thread::sleep_for(std::chrono::milliseconds(delay_ms));
+                throw std::runtime_error("chunk failed");
+            });
+        } catch (const std::runtime_error&) {
+            caught = true;
+        }
+        if (!caught || running.load() != 0) return false;
+    }
+
+    // 只有一个任务块抛出异常后，线程池仍然可用
+    bool caught = false;
+    try {
+        pool.parallelFor(1000, 7, [&](size_t begin, size_t end) {
+            if (begin <= 500 && 500 < end) throw std::runtime_error("chunk 500 failed");
+        });
+    } catch (const std::runtime_error&) {
+        caught = true;
+    }
+    if (!caught) return false;
+    std::vector<int> marks(1000, 0);
+    pool.parallelFor(marks.size(), 7, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) marks[i] = 1;
+    });
+    for (size_t i = 0; i < marks.size(); ++i) {
+        if (marks[i] != 1) return false;
+    }
+
+    std::cout << "✓ 嵌套调用顺序执行，异常在调用线程上重新抛出" << std::endl;
+    return true;
+}
+
+int main() {
+    std::cout << "开始并行测试..." << std::endl;
+
+    bool ok = testMatrixDeterminism() && testNMSDeterminism() && testNestingAndExceptions();
+    if (!ok) {
+        std::cerr << "❌ 并行测试失败" << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n✓ 并行测试全部通过" << std::endl;
+    return 0;
+}
@@ -0,0 +1,240 @@
+#include "pipeline.h"
+#include "executor.h"
+#include <iostream>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+using namespace nms;
+
+// 统计全局堆分配次数
+namespace {
+std::atomic<bool> g_counting(false);
+std::atomic<long> g_allocations(0);
+
+void* countedAllocate(size_t size) {
+    if (g_counting.load()) {
+        ++g_allocations;
+    }
+    void* ptr = std::malloc(size == 0 ? 1 : size);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+} // namespace
+
+void* operator new(size_t size) { return countedAllocate(size); }
+void* operator new[](size_t size) { return countedAllocate(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    if (g_counting.load()) {
+        ++g_allocations;
+    }
+    return std::malloc(size == 0 ? 1 : size);
+}
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept { return operator new(size, tag); }
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { std::free(ptr); }
+
+namespace {
+
+Box makeBox(float x, float z, float l, float w, float yaw, float confidence, int class_id) {
+    Box box;
+    box.class_id = class_id;
+    box.center_x = x;
+    box.center_y = 0.0f;
+    box.center_z = z;
+    box.length = l;
+    box.width = w;
+    box.height = 1.5f;
+    box.yaw = yaw;
+    box.confidence = confidence;
+    return box;
+}
+
+struct Frame {
+    std::vector<Box> boxes;
+    std::vector<Box> tracks;
+};
+
+/**
+ * @brief 生成规模逐帧变化的帧序列：检测框围绕目标聚集，轨迹框为目标的扰动
+ */
+std::vector<Frame> makeSequence(unsigned seed, int num_frames) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> position(-40.0f, 40.0f);
+    std::uniform_real_distribution<float> jitter(-0.6f, 0.6f);
+    std::uniform_real_distribution<float> size(1.5f, 4.5f);
+    std::uniform_real_distribution<float> angle(-3.2f, 3.2f);
+    std::uniform_real_distribution<float> score(0.05f, 1.0f);
+    std::uniform_int_distribution<int> num_objects(5, 60);
+
+    std::vector<Frame> frames(num_frames);
+    for (int f = 0; f < num_frames; ++f) {
+        int objects = num_objects(rng);
+        for (int o = 0; o < objects; ++o) {
+            float x = position(rng);
+            float z = position(rng);
+            float l = size(rng);
+            float w = size(rng);
+            float yaw = angle(rng);
+            int class_id = o % 3;
+            for (int k = 0; k < 4; ++k) {
+                frames[f].boxes.push_back(makeBox(x + jitter(rng), z + jitter(rng), l, w, yaw + 0.1f * jitter(rng),
+                                                  score(rng), class_id));
+            }
+            if (o % 4 != 0) {
+                frames[f].tracks.push_back(makeBox(x + jitter(rng), z + jitter(rng), l, w, yaw, 1.0f, class_id));
+            }
+        }
+    }
+    return frames;
+}
+
+bool sameAssociation(const AssociationResult& a, const AssociationResult& b) {
+    if (a.matches.size() != b.matches.size() || a.unmatched_detections != b.unmatched_detections ||
+        a.unmatched_tracks != b.unmatched_tracks) {
+        return false;
+    }
+    for (size_t k = 0; k < a.matches.size(); ++k) {
+        if (a.matches[k].detection != b.matches[k].detection || a.matches[k].track != b.matches[k].track ||
+            a.matches[k].iou != b.matches[k].iou) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 用一次性接口计算参考结果，检测框索引映射回帧内索引
+ */
+AssociationResult referenceAssociation(const Frame& frame, const std::vector<int>& keep,
+                                       const AssociationConfig& config) {
+    std::vector<int> rows(keep);
+    std::sort(rows.begin(), rows.end());
+    std::vector<Box> detections;
+    for (size_t i = 0; i < rows.size(); ++i) {
+        detections.push_back(frame.boxes[rows[i]]);
+    }
+    AssociationResult result = associate(detections, frame.tracks, config);
+    for (size_t k = 0; k < result.matches.size(); ++k) {
+        result.matches[k].detection = rows[result.matches[k].detection];
+    }
+    for (size_t k = 0; k < result.unmatched_detections.size(); ++k) {
+        result.unmatched_detections[k] = rows[result.unmatched_detections[k]];
+    }
+    return result;
+}
+
+} // namespace
+
+bool testMatchesOneShot() {
+    std::cout << "\n=== 测试流水线结果与一次性接口一致 ===" << std::endl;
+
+    std::vector<Frame> frames = makeSequence(7, 20);
+    NMSConfig nms_config;
+    nms_config.iou_threshold = 0.3f;
+    nms_config.score_threshold = 0.1f;
+    const AssignmentMethod methods[] = {AssignmentMethod::HUNGARIAN, AssignmentMethod::GREEDY};
+    const IoUType types[] = {IoUType::BEV, IoUType::IOU_3D};
+
+    ThreadPool pool(3);
+    for (AssignmentMethod method : methods) {
+        for (IoUType iou_type : types) {
+            AssociationConfig association_config;
+            association_config.method = method;
+            association_config.iou_type = iou_type;
+            FramePipeline pipeline(nms_config, association_config);
+
+            for (size_t f = 0; f < frames.size(); ++f) {
+                std::vector<int> expected_keep = nonMaximumSuppression(frames[f].boxes, nms_config);
+                if (pipeline.process(frames[f].boxes) != expected_keep) return false;
+
+                AssociationResult expected = referenceAssociation(frames[f], expected_keep, association_config);
+                Executor* executors[] = {nullptr, &pool};
+                for (Executor* executor : executors) {
+                    const AssociationResult& result = executor
+                        ? pipeline.associate(frames[f].boxes, frames[f].tracks, *executor)
+                        : pipeline.associate(frames[f].boxes, frames[f].tracks);
+                    if (!sameAssociation(result, expected)) return false;
+                    if (pipeline.kept() != expected_keep) return false;
+                }
+            }
+        }
+    }
+
+    std::cout << "✓ NMS与关联结果一致" << std::endl;
+    return true;
+}
+
+bool testZeroSteadyStateAllocations() {
+    std::cout << "\n=== 测试预热后无堆分配 ===" << std::endl;
+
+    std::vector<Frame> frames = makeSequence(11, 30);
+    NMSConfig nms_config;
+    nms_config.iou_threshold = 0.3f;
+    ThreadPool pool(3);
+
+    const AssignmentMethod methods[] = {AssignmentMethod::HUNGARIAN, AssignmentMethod::GREEDY};
+    for (AssignmentMethod method : methods) {
+        AssociationConfig association_config;
+        association_config.method = method;
+        FramePipeline pipeline(nms_config, association_config);
+
+        // 预热：完整处理一遍序列
+        for (size_t f = 0; f < frames.size(); ++f) {
+            pipeline.associate(frames[f].boxes, frames[f].tracks, pool);
+            pipeline.associate(frames[f].boxes, frames[f].tracks);
+        }
+
+        g_allocations = 0;
+        g_counting = true;
+        size_t matches = 0;
+        for (int round = 0; round < 3; ++round) {
+            for (size_t f = 0; f < frames.size(); ++f) {
+                matches += pipeline.associate(frames[f].boxes, frames[f].tracks, pool).matches.size();
+                matches += pipeline.associate(frames[f].boxes, frames[f].tracks).matches.size();
+                pipeline.process(frames[f].boxes);
+            }
+        }
+        g_counting = false;
+
+        std::cout << "  匹配数: " << matches << ", 堆分配次数: " << g_allocations.load() << std::endl;
+        if (g_allocations.load() != 0 || matches == 0) return false;
+    }
+
+    // 单独使用NMS工作区
+    NmsWorkspace workspace(nms_config);
+    workspace.reserve(256);
+    for (size_t f = 0; f < frames.size(); ++f) {
+        workspace.process(frames[f].boxes, pool);
+    }
+    g_allocations = 0;
+    g_counting = true;
+    for (size_t f = 0; f < frames.size(); ++f) {
+        workspace.process(frames[f].boxes, pool);
+    }
+    g_counting = false;
+    if (g_allocations.load() != 0) return false;
+
+    std::cout << "✓ 稳定状态下不分配内存" << std::endl;
+    return true;
+}
+
+int main() {
+    std::cout << "开始帧流水线测试..." << std::endl;
+
+    bool ok = testMatchesOneShot() && testZeroSteadyStateAllocations();
+    if (!ok) {
+        std::cerr << "❌ 帧流水线测试失败" << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n✓ 帧流水线测试全部通过" << std::endl;
+    return 0;
+}
@@ -0,0 +1,141 @@
+#include "iou3d.h"
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <algorithm>
+
+using namespace nms;
+
+namespace {
+
+// 局部坐标取1/64的整数倍，平移到2^17附近后float仍可精确表示中心
+const float kOffsetX = 131072.0f;
+const float kOffsetZ = -131072.0f;
+
+float quantize(float value) {
+    return std::round(value * 64.0f) / 64.0f;
+}
+
+Box makeBox(float x, float y, float z, float l, float w, float h, float yaw) {
+    Box box;
+    box.class_id = 0;
+    box.center_x = x;
+    box.center_y = y;
+    box.center_z = z;
+    box.length = l;
+    box.width = w;
+    box.height = h;
+    box.yaw = yaw;
+    box.confidence = 1.0f;
+    return box;
+}
+
+Box translate(const Box& box, float dx, float dz) {
+    Box moved = box;
+    moved.center_x += dx;
+    moved.center_z += dz;
+    return moved;
+}
+
+} // namespace
+
+bool testDoubleKernelMatchesClip() {
+    std::cout << "\n=== 测试double版本四边形内核与Sutherland-Hodgman一致 ===" << std::endl;
+
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> position(-3.0f, 3.0f);
+    std::uniform_real_distribution<float> size(0.5f, 5.0f);
+    std::uniform_real_distribution<float> angle(-3.2f, 3.2f);
+
+    double max_error = 0.0;
+    for (int i = 0; i < 1000; ++i) {
+        Box box1 = makeBox(position(rng), 0.0f, position(rng), size(rng), size(rng), 1.0f, angle(rng));
+        Box box2 = makeBox(position(rng), 0.0f, position(rng), size(rng), size(rng), 1.0f, angle(rng));
+
+        Point2DD quad1[4];
+        Point2DD quad2[4];
+        boxToBEVCorners<double>(box1, quad1, 0.0, 0.0);
+        boxToBEVCorners<double>(box2, quad2, 0.0, 0.0);
+
+        double kernel = calculateQuadIntersectionArea<double>(quad1, quad2);
+        Polygon2DD clipped = sutherlandHodgmanClip<double>(Polygon2DD(quad1, quad1 + 4),
+                                                           Polygon2DD(quad2, quad2 + 4));
+        double reference = calculatePolygonArea<double>(clipped);
+        max_error = std::max(max_error, std::abs(kernel - reference));
+    }
+
+    std::cout << "  最大面积误差: " << max_error << std::endl;
+    if (max_error > 1e-9) return false;
+
+    std::cout << "✓ double内核结果正确" << std::endl;
+    return true;
+}
+
+bool testLargeCoordinates() {
+    std::cout << "\n=== 测试远离原点时的IoU精度 ===" << std::endl;
+
+    std::mt19937 rng(23);
+    std::uniform_real_distribution<float> position(-2.0f, 2.0f);
+    std::uniform_real_distribution<float> size(1.0f, 5.0f);
+    std::uniform_real_distribution<float> angle(-3.2f, 3.2f);
+
+    double float_error = 0.0;
+    double double_error = 0.0;
+    double bev_error = 0.0;
+    for (int i = 0; i < 1000; ++i) {
+        Box local1 = makeBox(quantize(position(rng)), 0.0f, quantize(position(rng)),
+                             size(rng), size(rng), 1.5f, angle(rng));
+        Box local2 = makeBox(quantize(position(rng)), 0.25f, quantize(position(rng)),
+                             size(rng), size(rng), 1.5f, angle(rng));
+        Box far1 = translate(local1, kOffsetX, kOffsetZ);
+        Box far2 = translate(local2, kOffsetX, kOffsetZ);
+        if (far1.center_x - kOffsetX != local1.center_x || far2.center_z - kOffsetZ != local2.center_z) {
+            std::cerr << "  测试数据无法精确平移" << std::endl;
+            return false;
+        }
+
+        // 参考值：原点附近的double结果
+        double reference = calculateIoU3D<double>(local1, local2, false);
+        float_error = std::max(float_error, std::abs(calculateIoU3D(far1, far2) - reference));
+        double_error = std::max(double_error, std::abs(calculateIoU3D<double>(far1, far2) - reference));
+
+        double bev_reference = calculateBEVIoU<double>(local1, local2, false);
+        bev_error = std::max(bev_error, std::abs(calculateBEVIoU<double>(far1, far2) - bev_reference));
+    }
+
+    std::cout << "  float 3D IoU最大误差: " << float_error << std::endl;
+    std::cout << "  double(重新定心) 3D IoU最大误差: " << double_error << std::endl;
+    std::cout << "  double(重新定心) BEV IoU最大误差: " << bev_error << std::endl;
+    if (double_error > 1e-9 || bev_error > 1e-9) return false;
+    if (!(double_error < float_error)) return false;
+
+    std::cout << "✓ double版本在大坐标下保持精度" << std::endl;
+    return true;
+}
+
+bool testFloatInstantiationMatches() {
+    std::cout << "\n=== 测试float模板与原接口一致 ===" << std::endl;
+
+    Box box1 = makeBox(0.0f, 0.0f, 0.0f, 4.0f, 2.0f, 1.5f, 0.3f);
+    Box box2 = makeBox(1.0f, 0.2f, 0.5f, 4.0f, 2.0f, 1.5f, -0.4f);
+
+    if (calculateIoU3D<float>(box1, box2, false) != calculateIoU3D(box1, box2)) return false;
+    if (calculateBEVIoU<float>(box1, box2, false) != calculateBEVIoU(box1, box2)) return false;
+
+    std::cout << "✓ float模板结果与原接口一致" << std::endl;
+    return true;
+}
+
+int main() {
+    std::cout << "开始精度测试..." << std::endl;
+
+    bool ok = testDoubleKernelMatchesClip() && testLargeCoordinates() && testFloatInstantiationMatches();
+    if (!ok) {
+        std::cerr << "❌ 精度测试失败" << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n✓ 精度测试全部通过" << std::endl;
+    return 0;
+}
@@ -0,0 +1,183 @@
+#include "stats.h"
+#include "iou3d.h"
+#include "nms.h"
+#include "broad_phase.h"
+#include "executor.h"
+#include "iou3d_c.h"
+#include <iostream>
+#include <vector>
+#include <random>
+
+using namespace nms;
+
+namespace {
+
+Box makeBox(float x, float y, float z, float yaw) {
+    Box box;
+    box.center_x = x;
+    box.center_y = y;
+    box.center_z = z;
+    box.length = 4.0f;
+    box.width = 2.0f;
+    box.height = 1.5f;
+    box.yaw = yaw;
+    box.confidence = 0.9f;
+    return box;
+}
+
+std::vector<Box> makeBoxes(size_t count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> position(-10.0f, 10.0f);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::vector<Box> boxes(count);
+    for (size_t i = 0; i < count; ++i) {
+        boxes[i] = makeBox(position(rng), unit(rng), position(rng), unit(rng) * 6.0f - 3.0f);
+        boxes[i].confidence = unit(rng);
+    }
+    return boxes;
+}
+
+uint64_t histogramTotal(const StatsSnapshot& stats) {
+    uint64_t total = 0;
+    for (size_t b = 0; b < kClipHistogramBins; ++b) total += stats.clip_vertex_histogram[b];
+    return total;
+}
+
+bool allZero(const StatsSnapshot& stats) {
+    if (stats.pairs_evaluated || stats.y_rejects || stats.bev_rejects || stats.aligned_pairs ||
+        stats.empty_intersections || stats.degenerate_denominators || stats.parallel_edges ||
+        histogramTotal(stats) != 0) {
+        return false;
+    }
+    for (size_t s = 0; s < kNumStages; ++s) {
+        if (stats.stages[s].calls || stats.stages[s].nanoseconds) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+bool testDisabled() {
+    std::cout << "\n=== 测试未启用统计 ===" << std::endl;
+    std::vector<Box> boxes = makeBoxes(50, 1);
+    std::vector<float> iou(boxes.size() * boxes.size());
+    calculateIoU3DMatrix(boxes, boxes, iou.data());
+    nonMaximumSuppression(boxes, NMSConfig());
+    if (statsSnapshot().enabled || !allZero(statsSnapshot()) || !allZero(threadStatsSnapshot())) return false;
+    std::cout << "✓ 所有计数为0" << std::endl;
+    return true;
+}
+
+bool testCounters() {
+    std::cout << "\n=== 测试单个框对的计数 ===" << std::endl;
+    Box base = makeBox(0.0f, 0.0f, 0.0f, 0.0f);
+
+    resetStats();
+    calculateIoU3D(base, makeBox(0.0f, 5.0f, 0.0f, 0.0f));
+    StatsSnapshot stats = statsSnapshot();
+    if (stats.pairs_evaluated != 1 || stats.y_rejects != 1 || stats.bev_rejects != 0) return false;
+
+    resetStats();
+    calculateBEVIoU(base, makeBox(20.0f, 0.0f, 0.0f, 0.0f));
+    calculateIoU3D(prepareBox(base), prepareBox(makeBox(0.0f, 0.0f, 20.0f, 1.0f)));
+    stats = statsSnapshot();
+    if (stats.pairs_evaluated != 2 || stats.bev_rejects != 2 || histogramTotal(stats) != 0) return false;
+
+    // yaw相差π/2的整数倍时走轴对齐路径，不做多边形求交
+    resetStats();
+    calculateIoU3D(base, makeBox(1.0f, 0.0f, 0.5f, 1.5707964f));
+    stats = statsSnapshot();
+    if (stats.pairs_evaluated != 1 || stats.aligned_pairs != 1 || histogramTotal(stats) != 0) return false;
+
+    resetStats();
+    calculateIoU3D(base, makeBox(1.0f, 0.0f, 0.5f, 0.3f));
+    calculateIoU3D<double>(base, makeBox(1.0f, 0.0f, 0.5f, 0.3f));
+    stats = statsSnapshot();
+    if (stats.pairs_evaluated != 2 || stats.aligned_pairs != 0 || histogramTotal(stats) != 2 ||
+        stats.empty_intersections != 0) {
+        return false;
+    }
+
+    resetStats();
+    Polygon2D square = {Point2D(0, 0), Point2D(1, 0), Point2D(1, 1), Point2D(0, 1)};
+    Polygon2D far = {Point2D(5, 5), Point2D(6, 5), Point2D(6, 6), Point2D(5, 6)};
+    sutherlandHodgmanClip(square, square);
+    sutherlandHodgmanClip(square, far);
+    getLineIntersectionX(0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f);
+    getLineIntersectionZ(0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f);
+    stats = statsSnapshot();
+    if (stats.clip_vertex_histogram[4] != 1 || stats.clip_vertex_histogram[0] != 1 ||
+        stats.empty_intersections != 1 || stats.degenerate_denominators != 2) {
+        return false;
+    }
+
+    std::cout << "✓ 提前排除、快速路径、裁剪直方图与退化分母计数正确" << std::endl;
+    return true;
+}
+
+bool testThreadsAndStages() {
+    std::cout << "\n=== 测试多线程汇总与阶段计时 ===" << std::endl;
+    std::vector<Box> boxes = makeBoxes(60, 2);
+    std::vector<float> iou(boxes.size() * boxes.size());
+
+    resetStats();
+    {
+        ThreadPool pool(3);
+        calculateIoU3DMatrix(boxes, boxes, iou.data(), pool);
+        StatsSnapshot stats = statsSnapshot();
+        if (stats.pairs_evaluated != boxes.size() * boxes.size()) return false;
+        if (threadStatsSnapshot().pairs_evaluated > stats.pairs_evaluated) return false;
+    }
+    // 工作线程退出后计数仍然保留
+    StatsSnapshot stats = statsSnapshot();
+    if (stats.pairs_evaluated != boxes.size() * boxes.size()) return false;
+    if (stats.stage(Stage::IOU_MATRIX).calls != 1 || stats.stage(Stage::IOU_MATRIX).nanoseconds == 0) return false;
+    std::cout << "  " << stats.pairs_evaluated << " 个框对, y排除 " << stats.y_rejects << ", BEV排除 "
+              << stats.bev_rejects << ", " << stageName(Stage::IOU_MATRIX) << " "
+              << stats.stage(Stage::IOU_MATRIX).nanoseconds << " ns" << std::endl;
+
+    SparseIoUMatrix sparse;
+    calculateSparseIoU3DMatrix(boxes, boxes, sparse);
+    nonMaximumSuppression(boxes, NMSConfig());
+    NmsWorkspace workspace;
+    workspace.process(boxes);
+    stats = statsSnapshot();
+    if (stats.stage(Stage::SPARSE_MATRIX).calls != 1 || stats.stage(Stage::NMS).calls != 2 ||
+        stats.stage(Stage::ASSOCIATION).calls != 0) {
+        return false;
+    }
+
+    // C接口走同一条矩阵路径，计入IOU_MATRIX阶段，结果与C++接口一致
+    std::vector<float> rows;
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        const float params[IOU3D_BOX_PARAMS] = {boxes[i].center_x, boxes[i].center_y, boxes[i].center_z,
+                                                boxes[i].length, boxes[i].width, boxes[i].height, boxes[i].yaw};
+        rows.insert(rows.end(), params, params + IOU3D_BOX_PARAMS);
+    }
+    std::vector<float> c_iou(iou.size());
+    const uint64_t matrix_calls = stats.stage(Stage::IOU_MATRIX).calls;
+    if (iou3d_iou3d_matrix(rows.data(), boxes.size(), IOU3D_BOX_PARAMS, rows.data(), boxes.size(),
+                           IOU3D_BOX_PARAMS, c_iou.data(), nullptr) != IOU3D_OK || c_iou != iou) {
+        return false;
+    }
+    if (statsSnapshot().stage(Stage::IOU_MATRIX).calls != matrix_calls + 1) return false;
+
+    resetStats();
+    if (!allZero(statsSnapshot())) return false;
+
+    std::cout << "✓ 各线程计数汇总正确" << std::endl;
+    return true;
+}
+
+int main() {
+    std::cout << "开始热路径统计测试..." << std::endl;
+
+    bool ok = statsEnabled() ? testCounters() && testThreadsAndStages() : testDisabled();
+    if (!ok) {
+        std::cerr << "❌ 热路径统计测试失败" << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n✓ 热路径统计测试全部通过" << std::endl;
+    return 0;
+}
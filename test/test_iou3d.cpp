@@ -3,6 +3,9 @@
 #include <iomanip>
 #include <cmath>
 #include <cassert>
+#include <stdexcept>
+#include <vector>
+#include <random>
 
 using namespace nms;
 
@@ -183,6 +186,232 @@ void testPolygonArea() {
     std::cout << "✓ 多边形面积计算测试通过" << std::endl;
 }
 
+void testIoUMatrix() {
+    std::cout << "\n=== 测试批量IoU矩阵计算 ===" << std::endl;
+    
+    std::vector<Box> detections = {
+        createBox(0, 0, 0, 2, 4, 1.5f),
+        createBox(1, 0, 0, 2, 4, 1.5f, 0.3f),
+        createBox(5, 0, 0, 2, 4, 1.5f, M_PI/4)
+    };
+    std::vector<Box> tracks = {
+        createBox(0.5f, 0, 0, 2, 4, 1.5f),
+        createBox(0, 2, 0, 2, 4, 1.5f),
+        createBox(5, 0.2f, 0.5f, 2, 4, 1.5f, 1.0f),
+        createBox(20, 0, 0, 2, 4, 1.5f)
+    };
+    
+    std::vector<float> iou_matrix(detections.size() * tracks.size());
+    std::vector<float> bev_matrix(detections.size() * tracks.size());
+    calculateIoU3DMatrix(detections, tracks, iou_matrix.data());
+    calculateBEVIoUMatrix(detections, tracks, bev_matrix.data());
+    
+    for (size_t i = 0; i < detections.size(); ++i) {
+        for (size_t j = 0; j < tracks.size(); ++j) {
+            float expected_iou = calculateIoU3D(detections[i], tracks[j]);
+            float expected_bev = calculateBEVIoU(detections[i], tracks[j]);
+            float iou = iou_matrix[i * tracks.size() + j];
+            float bev_iou = bev_matrix[i * tracks.size() + j];
+            std::cout << "  (" << i << "," << j << ") 3D IoU: " << iou << ", BEV IoU: " << bev_iou << std::endl;
+            if (!isEqual(iou, expected_iou) || !isEqual(bev_iou, expected_bev)) {
+                throw std::runtime_error("IoU矩阵与逐对计算结果不一致");
+            }
+        }
+    }
+    
+    std::cout << "✓ 批量IoU矩阵与逐对计算结果一致" << std::endl;
+}
+
+void testStaticPolygonClip() {
+    std::cout << "\n=== 测试固定容量多边形裁剪 ===" << std::endl;
+    
+    Box boxes[] = {
+        createBox(0, 0, 0, 2, 4, 1.5f),
+        createBox(0.7f, 0, 0.4f, 2, 4, 1.5f, M_PI/4),
+        createBox(0, 0, 0, 2, 4, 1.5f, M_PI/2),
+        createBox(-1.2f, 0, 1.0f, 3, 1, 1.5f, 0.3f),
+        createBox(8, 0, 0, 2, 4, 1.5f)
+    };
+    const size_t count = sizeof(boxes) / sizeof(boxes[0]);
+    
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t j = 0; j < count; ++j) {
+            Polygon2D poly1 = boxToBEVPolygon(boxes[i]);
+            Polygon2D poly2 = boxToBEVPolygon(boxes[j]);
+            Polygon2D expected = sutherlandHodgmanClip(poly1, poly2);
+            
+            IntersectionPolygon clipped;
+            sutherlandHodgmanClip(poly1.data(), poly1.size(), poly2.data(), poly2.size(), clipped);
+            
+            if (clipped.size() != expected.size()) {
+                throw std::runtime_error("固定容量裁剪顶点数与vector版本不一致");
+            }
+            for (size_t k = 0; k < expected.size(); ++k) {
+                if (!isEqual(clipped[k].x, expected[k].x) || !isEqual(clipped[k].z, expected[k].z)) {
+                    throw std::runtime_error("固定容量裁剪顶点与vector版本不一致");
+                }
+            }
+            if (!isEqual(calculatePolygonArea(clipped), calculatePolygonArea(expected))) {
+                throw std::runtime_error("固定容量裁剪面积与vector版本不一致");
+            }
+        }
+    }
+    
+    std::cout << "✓ 固定容量裁剪与vector版本结果一致" << std::endl;
+}
+
+void testQuadIntersectionKernel() {
+    std::cout << "\n=== 测试矩形专用交集内核 ===" << std::endl;
+    
+    std::mt19937 rng(2024);
+    std::uniform_real_distribution<float> offset(-3.0f, 3.0f);
+    std::uniform_real_distribution<float> size(0.5f, 5.0f);
+    std::uniform_real_distribution<float> angle(-3.2f, 3.2f);
+    
+    float max_error = 0.0f;
+    for (int trial = 0; trial < 2000; ++trial) {
+        Box box1 = createBox(offset(rng), 0, offset(rng), size(rng), size(rng), 1.5f, angle(rng));
+        Box box2 = createBox(offset(rng), 0, offset(rng), size(rng), size(rng), 1.5f, angle(rng));
+        // 部分用例使用共边、同角度等退化配置
+        if (trial % 10 == 0) {
+            box2 = box1;
+        } else if (trial % 10 == 1) {
+            box2.yaw = box1.yaw;
+            box2.center_x = box1.center_x;
+        }
+        
+        Point2D quad1[4];
+        Point2D quad2[4];
+        boxToBEVCorners(box1, quad1);
+        boxToBEVCorners(box2, quad2);
+        
+        IntersectionPolygon clipped;
+        sutherlandHodgmanClip(quad1, 4, quad2, 4, clipped);
+        float expected = calculatePolygonArea(clipped);
+        float area = calculateQuadIntersectionArea(quad1, quad2);
+        
+        float error = std::abs(area - expected) / std::max(1.0f, expected);
+        max_error = std::max(max_error, error);
+    }
+    
+    std::cout << "与Sutherland-Hodgman的最大相对误差: " << max_error << std::endl;
+    if (max_error > 1e-4f) {
+        throw std::runtime_error("矩形专用交集内核与通用裁剪结果不一致");
+    }
+    
+    std::cout << "✓ 矩形专用交集内核结果正确" << std::endl;
+}
+
+void testPreparedBox() {
+    std::cout << "\n=== 测试预处理包围盒 ===" << std::endl;
+    
+    Box track = createBox(1.0f, 0.2f, -2.0f, 1.8f, 4.5f, 1.6f, 0.7f);
+    PreparedBox prepared = prepareBox(track);
+    
+    Point2D corners[4];
+    boxToBEVCorners(track, corners);
+    for (int k = 0; k < 4; ++k) {
+        if (prepared.corners[k].x != corners[k].x || prepared.corners[k].z != corners[k].z) {
+            throw std::runtime_error("预处理顶点与boxToBEVCorners不一致");
+        }
+        
+        // 内法向量应为单位向量、垂直于边，且对边的另一端点在内侧
+        const Point2D& a = prepared.corners[k];
+        const Point2D& b = prepared.corners[(k + 1) % 4];
+        const Point2D& opposite = prepared.corners[(k + 2) % 4];
+        const Point2D& n = prepared.edge_normals[k];
+        float length = std::sqrt(n.x * n.x + n.z * n.z);
+        float along = n.x * (b.x - a.x) + n.z * (b.z - a.z);
+        float inward = n.x * (opposite.x - a.x) + n.z * (opposite.z - a.z);
+        if (!isEqual(length, 1.0f, 1e-5f) || !isEqual(along, 0.0f, 1e-5f) || inward <= 0.0f) {
+            throw std::runtime_error("边法向量错误");
+        }
+    }
+    
+    if (!isEqual(prepared.area, calculatePolygonArea(corners, 4), 1e-5f) ||
+        !isEqual(prepared.volume, prepared.area * track.height, 1e-5f) ||
+        !isEqual(prepared.y_min, track.center_y - 0.8f) || !isEqual(prepared.y_max, track.center_y + 0.8f)) {
+        throw std::runtime_error("预处理面积、体积或y范围错误");
+    }
+    for (int k = 0; k < 4; ++k) {
+        if (corners[k].x < prepared.min_x || corners[k].x > prepared.max_x ||
+            corners[k].z < prepared.min_z || corners[k].z > prepared.max_z) {
+            throw std::runtime_error("包围矩形未覆盖所有顶点");
+        }
+    }
+    
+    // 同一个track与多个检测框比较
+    Box detections[] = {
+        createBox(1.2f, 0.0f, -1.8f, 1.8f, 4.4f, 1.5f, 0.6f),
+        createBox(0.0f, 0.0f, 0.0f, 2.0f, 4.0f, 1.5f, 0.0f),
+        createBox(30.0f, 0.0f, 0.0f, 2.0f, 4.0f, 1.5f, 0.0f)
+    };
+    for (const Box& detection : detections) {
+        PreparedBox prepared_detection = prepareBox(detection);
+        if (!isEqual(calculateIoU3D(prepared, prepared_detection), calculateIoU3D(track, detection)) ||
+            !isEqual(calculateBEVIoU(prepared, prepared_detection), calculateBEVIoU(track, detection))) {
+            throw std::runtime_error("预处理IoU与逐对计算不一致");
+        }
+    }
+    
+    std::cout << "✓ 预处理包围盒几何信息与IoU正确" << std::endl;
+}
+
+void testEarlyRejectAndAlignedPath() {
+    std::cout << "\n=== 测试廉价排除与朝向对齐快速路径 ===" << std::endl;
+    
+    std::mt19937 rng(77);
+    std::uniform_real_distribution<float> offset(-4.0f, 4.0f);
+    std::uniform_real_distribution<float> size(0.5f, 5.0f);
+    std::uniform_real_distribution<float> angle(-3.2f, 3.2f);
+    const float half_pi = 1.57079632679f;
+    
+    // 朝向相差kπ/2的框对与通用裁剪结果比较
+    float max_error = 0.0f;
+    for (int trial = 0; trial < 2000; ++trial) {
+        Box box1 = createBox(offset(rng), 0, offset(rng), size(rng), size(rng), 1.5f, angle(rng));
+        Box box2 = createBox(offset(rng), 0.5f, offset(rng), size(rng), size(rng), 1.5f,
+                             box1.yaw + half_pi * static_cast<float>(trial % 4));
+        if (trial % 4 == 0) {
+            box2.yaw = box1.yaw;
+        }
+        
+        Polygon2D clipped = sutherlandHodgmanClip(boxToBEVPolygon(box1), boxToBEVPolygon(box2));
+        float area = calculatePolygonArea(clipped);
+        float expected = area / (box1.length * box1.width + box2.length * box2.width - area);
+        float iou = calculateBEVIoU(box1, box2);
+        max_error = std::max(max_error, std::abs(iou - expected));
+        
+        float expected_3d = expected > 0.0f
+            ? area * 1.0f / (box1.length * box1.width * 1.5f + box2.length * box2.width * 1.5f - area * 1.0f)
+            : 0.0f;
+        max_error = std::max(max_error, std::abs(calculateIoU3D(box1, box2) - expected_3d));
+    }
+    std::cout << "对齐框对与通用裁剪的最大误差: " << max_error << std::endl;
+    if (max_error > 1e-4f) {
+        throw std::runtime_error("朝向对齐快速路径结果错误");
+    }
+    
+    // 被排除的框对返回精确的0，且与逐项计算一致
+    Box base = createBox(0, 0, 0, 2.0f, 4.0f, 1.5f, 0.4f);
+    Box far = createBox(6.0f, 0, 0, 2.0f, 4.0f, 1.5f, 0.4f);       // 外接圆不相交
+    Box corner = createBox(3.6f, 0, 2.6f, 2.0f, 4.0f, 1.5f, 1.2f); // 外接圆相交，形状不相交
+    Box above = createBox(0, 2.0f, 0, 2.0f, 4.0f, 1.5f, 0.4f);      // y方向不重叠
+    if (calculateBEVIoU(base, far) != 0.0f || calculateIoU3D(base, far) != 0.0f ||
+        calculateIoU3D(base, above) != 0.0f || calculateBEVIoU(base, above) <= 0.99f) {
+        throw std::runtime_error("廉价排除结果错误");
+    }
+    Point2D quad1[4];
+    Point2D quad2[4];
+    boxToBEVCorners(base, quad1);
+    boxToBEVCorners(corner, quad2);
+    if (calculateQuadIntersectionArea(quad1, quad2) > 1e-6f || calculateBEVIoU(base, corner) > 1e-6f) {
+        throw std::runtime_error("包围矩形排除结果错误");
+    }
+    
+    std::cout << "✓ 廉价排除与快速路径正确" << std::endl;
+}
+
 int main() {
     std::cout << "开始3D IoU测试..." << std::endl;
     
@@ -194,6 +423,11 @@ int main() {
         testCase4_HeightNoOverlap();
         testCase5_RotatedBoxes();
         testCase6_DifferentSizes();
+        testIoUMatrix();
+        testStaticPolygonClip();
+        testQuadIntersectionKernel();
+        testPreparedBox();
+        testEarlyRejectAndAlignedPath();
         
         std::cout << "\n🎉 所有测试用例通过！" << std::endl;
         std::cout << "3D IoU实现验证成功。" << std::endl;
@@ -0,0 +1,211 @@
+#include "track_cache.h"
+#include <iostream>
+#include <vector>
+#include <random>
+
+using namespace nms;
+
+namespace {
+
+std::vector<Box> makeBoxes(size_t count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> position(-25.0f, 25.0f);
+    std::uniform_real_distribution<float> size(1.0f, 5.0f);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::uniform_int_distribution<int> class_dist(0, 2);
+    std::vector<Box> boxes(count);
+    for (size_t i = 0; i < count; ++i) {
+        Box& box = boxes[i];
+        box.class_id = class_dist(rng);
+        box.center_x = position(rng);
+        box.center_y = unit(rng);
+        box.center_z = position(rng);
+        box.length = size(rng);
+        box.width = size(rng);
+        box.height = size(rng);
+        box.yaw = unit(rng) * 6.0f - 3.0f;
+        box.confidence = unit(rng);
+    }
+    return boxes;
+}
+
+// 检测与轨迹的暴力IoU矩阵
+std::vector<float> bruteForce(const std::vector<Box>& detections, const std::vector<Box>& tracks) {
+    std::vector<float> expected(detections.size() * tracks.size(), 0.0f);
+    for (size_t i = 0; i < detections.size(); ++i) {
+        for (size_t j = 0; j < tracks.size(); ++j) {
+            if (detections[i].class_id == tracks[j].class_id) {
+                expected[i * tracks.size() + j] = calculateIoU3D(detections[i], tracks[j]);
+            }
+        }
+    }
+    return expected;
+}
+
+bool checkDetections(TrackIoUCache& cache, const std::vector<Box>& detections, const std::vector<Box>& tracks) {
+    std::vector<float> expected = bruteForce(detections, tracks);
+    std::vector<float> dense(expected.size());
+    cache.computeIoU(detections, dense.data());
+    if (dense != expected) return false;
+
+    SparseIoUMatrix sparse;
+    cache.computeIoU(detections, sparse);
+    if (sparse.rows != detections.size() || sparse.cols != tracks.size()) return false;
+    std::vector<float> expanded(expected.size(), 0.0f);
+    for (size_t i = 0; i < sparse.rows; ++i) {
+        for (int k = sparse.row_ptr[i]; k < sparse.row_ptr[i + 1]; ++k) {
+            if (k > sparse.row_ptr[i] && sparse.col_index[k] <= sparse.col_index[k - 1]) return false;
+            expanded[i * tracks.size() + sparse.col_index[k]] = sparse.values[k];
+        }
+    }
+    return expanded == expected;
+}
+
+// 轨迹之间的暴力重叠对
+bool checkOverlaps(const TrackIoUCache& cache, const std::vector<int>& ids, const std::vector<Box>& tracks) {
+    std::vector<TrackOverlap> overlaps;
+    cache.trackOverlaps(overlaps);
+    std::vector<TrackOverlap> expected;
+    for (size_t a = 0; a < tracks.size(); ++a) {
+        for (size_t b = 0; b < tracks.size(); ++b) {
+            if (ids[a] >= ids[b] || tracks[a].class_id != tracks[b].class_id) continue;
+            float iou = calculateIoU3D(tracks[a], tracks[b]);
+            if (iou > 0.0f) {
+                TrackOverlap overlap = {ids[a], ids[b], iou};
+                expected.push_back(overlap);
+            }
+        }
+    }
+    if (overlaps.size() != expected.size()) return false;
+    for (size_t k = 0; k < overlaps.size(); ++k) {
+        bool found = false;
+        for (size_t e = 0; e < expected.size() && !found; ++e) {
+            found = expected[e].first == overlaps[k].first && expected[e].second == overlaps[k].second &&
+                    expected[e].iou == overlaps[k].iou;
+        }
+        if (!found) return false;
+        if (k > 0 && (overlaps[k - 1].first > overlaps[k].first ||
+                      (overlaps[k - 1].first == overlaps[k].first && overlaps[k - 1].second >= overlaps[k].second))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool testExactness() {
+    std::cout << "\n=== 测试多帧结果与暴力计算一致 ===" << std::endl;
+    TrackCacheConfig config;
+    config.position_epsilon = 0.0f;
+    config.size_epsilon = 0.0f;
+    config.yaw_epsilon = 0.0f;
+    TrackIoUCache cache(config);
+
+    std::vector<Box> tracks = makeBoxes(300, 1);
+    std::vector<int> ids(tracks.size());
+    for (size_t i = 0; i < ids.size(); ++i) ids[i] = static_cast<int>(i) * 3 + 1;
+    int next_id = static_cast<int>(ids.size()) * 3 + 1;
+
+    std::mt19937 rng(2);
+    std::uniform_real_distribution<float> jitter(-0.3f, 0.3f);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    for (int frame = 0; frame < 12; ++frame) {
+        if (cache.update(ids, tracks) > tracks.size()) return false;
+        if (cache.numTracks() != tracks.size()) return false;
+        if (!checkOverlaps(cache, ids, tracks)) return false;
+
+        std::vector<Box> detections = tracks;
+        for (size_t i = 0; i < detections.size(); ++i) {
+            detections[i].center_x += jitter(rng);
+            detections[i].center_z += jitter(rng);
+        }
+        std::vector<Box> extra = makeBoxes(40, 100 + frame);
+        detections.insert(detections.end(), extra.begin(), extra.end());
+        if (!checkDetections(cache, detections, tracks)) return false;
+
+        // 下一帧：约十分之一的轨迹移动，删除一部分旧轨迹并加入新轨迹，打乱顺序
+        std::vector<Box> next_tracks;
+        std::vector<int> next_ids;
+        for (size_t i = 0; i < tracks.size(); ++i) {
+            float r = unit(rng);
+            if (r < 0.05f) continue;
+            Box box = tracks[i];
+            if (r < 0.15f) {
+                box.center_x += jitter(rng) * 10.0f;
+                box.center_z += jitter(rng);
+                box.yaw += jitter(rng);
+            }
+            next_tracks.push_back(box);
+            next_ids.push_back(ids[i]);
+        }
+        std::vector<Box> born = makeBoxes(15, 200 + frame);
+        for (size_t i = 0; i < born.size(); ++i) {
+            next_tracks.push_back(born[i]);
+            next_ids.push_back(next_id++);
+        }
+        std::shuffle(next_tracks.begin(), next_tracks.end(), std::mt19937(frame));
+        std::shuffle(next_ids.begin(), next_ids.end(), std::mt19937(frame));
+        tracks.swap(next_tracks);
+        ids.swap(next_ids);
+    }
+
+    cache.clear();
+    if (cache.numTracks() != 0) return false;
+    cache.update(ids, tracks);
+    if (!checkOverlaps(cache, ids, tracks)) return false;
+
+    std::cout << "✓ 稠密、稀疏矩阵与轨迹重叠对均与暴力计算一致" << std::endl;
+    return true;
+}
+
+bool testIncrementalWork() {
+    std::cout << "\n=== 测试增量计算量 ===" << std::endl;
+    TrackIoUCache cache;
+    std::vector<Box> tracks = makeBoxes(400, 3);
+    std::vector<int> ids(tracks.size());
+    for (size_t i = 0; i < ids.size(); ++i) ids[i] = static_cast<int>(i);
+
+    if (cache.update(ids, tracks) != tracks.size()) return false;
+    size_t full = cache.lastPairEvaluations();
+
+    // 位姿不变时不做任何计算
+    if (cache.update(ids, tracks) != 0 || cache.lastPairEvaluations() != 0) return false;
+
+    // 阈值以内的抖动复用已有几何
+    std::vector<Box> moved = tracks;
+    for (size_t i = 0; i < moved.size(); ++i) moved[i].center_x += 5e-4f;
+    if (cache.update(ids, moved) != 0) return false;
+    if (!checkOverlaps(cache, ids, tracks)) return false;
+
+    // 只有少数轨迹移动时只重新计算与之相关的框对
+    for (size_t i = 0; i < 10; ++i) moved[i * 40].center_z += 0.5f;
+    if (cache.update(ids, moved) != 10) return false;
+    size_t partial = cache.lastPairEvaluations();
+    std::cout << "  首帧框对计算: " << full << ", 10条轨迹移动后: " << partial << std::endl;
+    if (partial == 0 || partial * 10 > full) return false;
+    for (size_t i = 0; i < 10; ++i) tracks[i * 40] = moved[i * 40];
+    if (!checkOverlaps(cache, ids, tracks)) return false;
+
+    // 类别变化视为位姿变化
+    moved[1].class_id = (moved[1].class_id + 1) % 3;
+    if (cache.update(ids, moved) != 1) return false;
+    tracks[1] = moved[1];
+    if (!checkOverlaps(cache, ids, tracks)) return false;
+
+    std::cout << "✓ 未变化的轨迹复用几何与重叠对" << std::endl;
+    return true;
+}
+
+int main() {
+    std::cout << "开始轨迹IoU缓存测试..." << std::endl;
+
+    bool ok = testExactness() && testIncrementalWork();
+    if (!ok) {
+        std::cerr << "❌ 轨迹IoU缓存测试失败" << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n✓ 轨迹IoU缓存测试全部通过" << std::endl;
+    return 0;
+}
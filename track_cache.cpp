@@ -0,0 +1,309 @@
+#include "track_cache.h"
+#include <algorithm>
+#include <cmath>
+
+namespace nms {
+
+TrackIoUCache::TrackIoUCache(const TrackCacheConfig& config)
+    : config_(config), stamp_(0), last_pair_evaluations_(0) {}
+
+bool TrackIoUCache::poseChanged(const BoxPOD& previous, const Box& current) const {
+    if (previous.class_id != current.class_id) {
+        return true;
+    }
+    const float position = config_.position_epsilon;
+    const float size = config_.size_epsilon;
+    // 用!(<=)的形式使NaN也视为变化
+    return !(std::abs(current.center_x - previous.center_x) <= position &&
+             std::abs(current.center_y - previous.center_y) <= position &&
+             std::abs(current.center_z - previous.center_z) <= position &&
+             std::abs(current.length - previous.length) <= size &&
+             std::abs(current.width - previous.width) <= size &&
+             std::abs(current.height - previous.height) <= size &&
+             std::abs(current.yaw - previous.yaw) <= config_.yaw_epsilon);
+}
+
+TrackIoUCache::CellRange TrackIoUCache::cellRange(const BEVBounds& bounds) const {
+    CellRange range;
+    range.x0 = static_cast<int>(std::floor(bounds.min_x / config_.cell_size));
+    range.z0 = static_cast<int>(std::floor(bounds.min_z / config_.cell_size));
+    range.x1 = static_cast<int>(std::floor(bounds.max_x / config_.cell_size));
+    range.z1 = static_cast<int>(std::floor(bounds.max_z / config_.cell_size));
+    return range;
+}
+
+uint64_t TrackIoUCache::cellKey(int x, int z) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(z);
+}
+
+uint64_t TrackIoUCache::pairKey(int a, int b) {
+    if (a > b) {
+        std::swap(a, b);
+    }
+    return (static_cast<uint64_t>(static_cast<uint32_t>(a)) << 32) | static_cast<uint32_t>(b);
+}
+
+float TrackIoUCache::pairIoU(const PreparedBox& a, const PreparedBox& b) const {
+    return config_.iou_type == IoUType::IOU_3D ? calculateIoU3D(a, b) : calculateBEVIoU(a, b);
+}
+
+void TrackIoUCache::computeGeometry(Track& track, const Box& box) {
+    track.pose = toBoxPOD(box);
+    prepareBox(track.pose, track.prepared);
+    BEVBounds bounds = {track.prepared.min_x, track.prepared.min_z, track.prepared.max_x, track.prepared.max_z};
+    track.bounds = bounds;
+    track.cells = cellRange(bounds);
+}
+
+void TrackIoUCache::insertCells(int slot, const CellRange& range) {
+    for (int x = range.x0; x <= range.x1; ++x) {
+        for (int z = range.z0; z <= range.z1; ++z) {
+            cells_[cellKey(x, z)].push_back(slot);
+        }
+    }
+}
+
+void TrackIoUCache::eraseCells(int slot, const CellRange& range) {
+    for (int x = range.x0; x <= range.x1; ++x) {
+        for (int z = range.z0; z <= range.z1; ++z) {
+            std::unordered_map<uint64_t, std::vector<int> >::iterator cell = cells_.find(cellKey(x, z));
+            if (cell == cells_.end()) {
+                continue;
+            }
+            std::vector<int>& items = cell->second;
+            std::vector<int>::iterator it = std::find(items.begin(), items.end(), slot);
+            if (it != items.end()) {
+                *it = items.back();
+                items.pop_back();
+            }
+            if (items.empty()) {
+                cells_.erase(cell);
+            }
+        }
+    }
+}
+
+void TrackIoUCache::dropPairs(int slot) {
+    std::vector<int>& neighbors = tracks_[slot].neighbors;
+    for (size_t k = 0; k < neighbors.size(); ++k) {
+        int other = neighbors[k];
+        pair_iou_.erase(pairKey(slot, other));
+        std::vector<int>& back = tracks_[other].neighbors;
+        std::vector<int>::iterator it = std::find(back.begin(), back.end(), slot);
+        if (it != back.end()) {
+            *it = back.back();
+            back.pop_back();
+        }
+    }
+    neighbors.clear();
+}
+
+void TrackIoUCache::queryCandidates(const BEVBounds& bounds, int class_id) {
+    candidates_.clear();
+    if (visit_stamp_.size() < tracks_.size()) {
+        visit_stamp_.resize(tracks_.size(), 0);
+    }
+    if (++stamp_ == 0) {
+        std::fill(visit_stamp_.begin(), visit_stamp_.end(), 0u);
+        stamp_ = 1;
+    }
+
+    const CellRange range = cellRange(bounds);
+    for (int x = range.x0; x <= range.x1; ++x) {
+        for (int z = range.z0; z <= range.z1; ++z) {
+            std::unordered_map<uint64_t, std::vector<int> >::const_iterator cell = cells_.find(cellKey(x, z));
+            if (cell == cells_.end()) {
+                continue;
+            }
+            const std::vector<int>& items = cell->second;
+            for (size_t k = 0; k < items.size(); ++k) {
+                int slot = items[k];
+                if (visit_stamp_[slot] == stamp_) {
+                    continue;
+                }
+                visit_stamp_[slot] = stamp_;
+                const Track& track = tracks_[slot];
+                if (config_.class_aware && track.pose.class_id != class_id) {
+                    continue;
+                }
+                if (bounds.overlaps(track.bounds)) {
+                    candidates_.push_back(slot);
+                }
+            }
+        }
+    }
+}
+
+size_t TrackIoUCache::update(const std::vector<int>& ids, const std::vector<Box>& tracks) {
+    // 上一帧存在的槽位，本帧出现后清除标记，剩下的即被删除的轨迹
+    std::vector<char> stale(tracks_.size(), 0);
+    for (size_t s = 0; s < tracks_.size(); ++s) {
+        stale[s] = tracks_[s].alive ? 1 : 0;
+    }
+    changed_.assign(tracks_.size(), 0);
+    columns_.resize(ids.size());
+
+    size_t recomputed = 0;
+    for (size_t i = 0; i < ids.size(); ++i) {
+        std::unordered_map<int, int>::const_iterator found = slot_of_id_.find(ids[i]);
+        int slot;
+        if (found == slot_of_id_.end()) {
+            if (!free_slots_.empty()) {
+                slot = free_slots_.back();
+                free_slots_.pop_back();
+            } else {
+                slot = static_cast<int>(tracks_.size());
+                tracks_.push_back(Track());
+                stale.push_back(0);
+                changed_.push_back(0);
+            }
+            Track& track = tracks_[slot];
+            track.id = ids[i];
+            track.alive = true;
+            track.neighbors.clear();
+            computeGeometry(track, tracks[i]);
+            insertCells(slot, track.cells);
+            slot_of_id_[ids[i]] = slot;
+            changed_[slot] = 1;
+            ++recomputed;
+        } else {
+            slot = found->second;
+            stale[slot] = 0;
+            Track& track = tracks_[slot];
+            if (poseChanged(track.pose, tracks[i])) {
+                const CellRange old_cells = track.cells;
+                computeGeometry(track, tracks[i]);
+                // 网格登记只在覆盖的单元范围变化时更新
+                if (!(old_cells == track.cells)) {
+                    eraseCells(slot, old_cells);
+                    insertCells(slot, track.cells);
+                }
+                dropPairs(slot);
+                changed_[slot] = 1;
+                ++recomputed;
+            }
+        }
+        columns_[i] = slot;
+    }
+
+    // 删除本帧没有出现的轨迹
+    for (size_t s = 0; s < stale.size(); ++s) {
+        if (!stale[s]) {
+            continue;
+        }
+        int slot = static_cast<int>(s);
+        eraseCells(slot, tracks_[slot].cells);
+        dropPairs(slot);
+        slot_of_id_.erase(tracks_[slot].id);
+        tracks_[slot].alive = false;
+        free_slots_.push_back(slot);
+    }
+
+    column_of_slot_.assign(tracks_.size(), -1);
+    for (size_t i = 0; i < columns_.size(); ++i) {
+        column_of_slot_[columns_[i]] = static_cast<int>(i);
+    }
+
+    // 只重新计算涉及几何变化轨迹的框对；两条轨迹都变化时由槽位较小的一方计算
+    last_pair_evaluations_ = 0;
+    for (size_t s = 0; s < changed_.size(); ++s) {
+        if (!changed_[s]) {
+            continue;
+        }
+        int slot = static_cast<int>(s);
+        queryCandidates(tracks_[slot].bounds, tracks_[slot].pose.class_id);
+        for (size_t k = 0; k < candidates_.size(); ++k) {
+            int other = candidates_[k];
+            if (other == slot || (changed_[other] && other < slot)) {
+                continue;
+            }
+            ++last_pair_evaluations_;
+            // 按轨迹编号顺序计算，结果与槽位分配无关
+            const Track& a = tracks_[slot].id < tracks_[other].id ? tracks_[slot] : tracks_[other];
+            const Track& b = tracks_[slot].id < tracks_[other].id ? tracks_[other] : tracks_[slot];
+            float iou = pairIoU(a.prepared, b.prepared);
+            if (iou > 0.0f) {
+                pair_iou_[pairKey(slot, other)] = iou;
+                tracks_[slot].neighbors.push_back(other);
+                tracks_[other].neighbors.push_back(slot);
+            }
+        }
+    }
+    return recomputed;
+}
+
+void TrackIoUCache::clear() {
+    tracks_.clear();
+    free_slots_.clear();
+    slot_of_id_.clear();
+    columns_.clear();
+    column_of_slot_.clear();
+    cells_.clear();
+    pair_iou_.clear();
+    changed_.clear();
+    last_pair_evaluations_ = 0;
+}
+
+void TrackIoUCache::computeIoU(const std::vector<Box>& detections, SparseIoUMatrix& out) {
+    out.rows = detections.size();
+    out.cols = columns_.size();
+    out.row_ptr.assign(1, 0);
+    out.col_index.clear();
+    out.values.clear();
+
+    PreparedBox prepared;
+    for (size_t i = 0; i < detections.size(); ++i) {
+        prepareBox(detections[i], prepared);
+        BEVBounds bounds = {prepared.min_x, prepared.min_z, prepared.max_x, prepared.max_z};
+        queryCandidates(bounds, detections[i].class_id);
+
+        row_entries_.clear();
+        for (size_t k = 0; k < candidates_.size(); ++k) {
+            int slot = candidates_[k];
+            float iou = pairIoU(prepared, tracks_[slot].prepared);
+            if (iou > 0.0f) {
+                row_entries_.push_back(std::make_pair(column_of_slot_[slot], iou));
+            }
+        }
+        std::sort(row_entries_.begin(), row_entries_.end());
+        for (size_t k = 0; k < row_entries_.size(); ++k) {
+            out.col_index.push_back(row_entries_[k].first);
+            out.values.push_back(row_entries_[k].second);
+        }
+        out.row_ptr.push_back(static_cast<int>(out.values.size()));
+    }
+}
+
+void TrackIoUCache::computeIoU(const std::vector<Box>& detections, float* out) {
+    const size_t cols = columns_.size();
+    std::fill(out, out + detections.size() * cols, 0.0f);
+
+    PreparedBox prepared;
+    for (size_t i = 0; i < detections.size(); ++i) {
+        prepareBox(detections[i], prepared);
+        BEVBounds bounds = {prepared.min_x, prepared.min_z, prepared.max_x, prepared.max_z};
+        queryCandidates(bounds, detections[i].class_id);
+        for (size_t k = 0; k < candidates_.size(); ++k) {
+            int slot = candidates_[k];
+            out[i * cols + column_of_slot_[slot]] = pairIoU(prepared, tracks_[slot].prepared);
+        }
+    }
+}
+
+void TrackIoUCache::trackOverlaps(std::vector<TrackOverlap>& overlaps) const {
+    overlaps.clear();
+    for (std::unordered_map<uint64_t, float>::const_iterator it = pair_iou_.begin(); it != pair_iou_.end(); ++it) {
+        int a = tracks_[static_cast<int>(it->first >> 32)].id;
+        int b = tracks_[static_cast<int>(it->first & 0xffffffffu)].id;
+        TrackOverlap overlap;
+        overlap.first = std::min(a, b);
+        overlap.second = std::max(a, b);
+        overlap.iou = it->second;
+        overlaps.push_back(overlap);
+    }
+    std::sort(overlaps.begin(), overlaps.end(), [](const TrackOverlap& x, const TrackOverlap& y) {
+        return x.first != y.first ? x.first < y.first : x.second < y.second;
+    });
+}
+
+} // namespace nms
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "iou3d.h"
+#include "nms.h"
+#include "broad_phase.h"
+
+#include <vector>
+#include <utility>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+
+namespace nms {
+
+/**
+ * @brief 轨迹IoU缓存参数
+ */
+struct TrackCacheConfig {
+    // 中心、尺寸和yaw相对于上次计算几何时的变化都不超过对应阈值时，复用已有几何
+    float position_epsilon = 1e-3f;
+    float size_epsilon = 1e-3f;
+    float yaw_epsilon = 1e-4f;
+    // 持久网格的单元边长
+    float cell_size = 4.0f;
+    IoUType iou_type = IoUType::IOU_3D;
+    // 为true时只计算相同class_id的框对
+    bool class_aware = true;
+};
+
+/**
+ * @brief 两条轨迹之间的重叠，first < second为轨迹编号
+ */
+struct TrackOverlap {
+    int first;
+    int second;
+    float iou;
+};
+
+/**
+ * @brief 跨帧复用轨迹几何的IoU缓存
+ * 按轨迹编号保存每条轨迹的PreparedBox、包围矩形和所在的网格单元。每帧update时，
+ * 位姿变化不超过阈值的轨迹不重新计算几何，也不改变网格登记；
+ * 轨迹之间的重叠对只在其中一条轨迹的几何变化时失效并重新计算。
+ * 检测框每帧都是新的，computeIoU在持久网格上查询候选轨迹，只对包围矩形相交的框对计算IoU。
+ * 一个缓存对象不能被多个线程同时使用。
+ */
+class TrackIoUCache {
+public:
+    explicit TrackIoUCache(const TrackCacheConfig& config = TrackCacheConfig());
+
+    const TrackCacheConfig& config() const { return config_; }
+
+    /**
+     * @brief 更新轨迹集合
+     * @param ids 轨迹编号，互不相同；之前存在但不在ids中的轨迹被删除
+     * @param tracks 与ids一一对应的轨迹框，其下标即computeIoU输出的列号
+     * @return 本次重新计算几何的轨迹数（包括新轨迹）
+     */
+    size_t update(const std::vector<int>& ids, const std::vector<Box>& tracks);
+
+    /**
+     * @brief 清空所有轨迹
+     */
+    void clear();
+
+    size_t numTracks() const { return columns_.size(); }
+
+    /**
+     * @brief 检测框与最近一次update的轨迹之间的稀疏IoU矩阵
+     * 行为detections的下标，列为update时tracks的下标
+     */
+    void computeIoU(const std::vector<Box>& detections, SparseIoUMatrix& out);
+
+    /**
+     * @brief 同上，输出行优先的稠密矩阵（至少detections.size() * numTracks()个元素）
+     */
+    void computeIoU(const std::vector<Box>& detections, float* out);
+
+    /**
+     * @brief 当前所有IoU大于0的轨迹对，按(first, second)升序
+     * iou按(first, second)的顺序计算
+     */
+    void trackOverlaps(std::vector<TrackOverlap>& overlaps) const;
+
+    /**
+     * @brief 最近一次update中重新计算IoU的轨迹对数
+     */
+    size_t lastPairEvaluations() const { return last_pair_evaluations_; }
+
+private:
+    // 网格单元坐标范围（闭区间）
+    struct CellRange {
+        int x0;
+        int z0;
+        int x1;
+        int z1;
+
+        bool operator==(const CellRange& other) const {
+            return x0 == other.x0 && z0 == other.z0 && x1 == other.x1 && z1 == other.z1;
+        }
+    };
+
+    struct Track {
+        int id;
+        // 上次计算几何时的位姿
+        BoxPOD pose;
+        PreparedBox prepared;
+        BEVBounds bounds;
+        // 登记的网格单元
+        CellRange cells;
+        bool alive;
+        // IoU大于0的其他轨迹（槽位）
+        std::vector<int> neighbors;
+    };
+
+    bool poseChanged(const BoxPOD& previous, const Box& current) const;
+    void computeGeometry(Track& track, const Box& box);
+    CellRange cellRange(const BEVBounds& bounds) const;
+    void insertCells(int slot, const CellRange& range);
+    void eraseCells(int slot, const CellRange& range);
+    void dropPairs(int slot);
+    float pairIoU(const PreparedBox& a, const PreparedBox& b) const;
+    static uint64_t cellKey(int x, int z);
+    static uint64_t pairKey(int a, int b);
+    // 查询与bounds相交的轨迹槽位，结果写入candidates_
+    void queryCandidates(const BEVBounds& bounds, int class_id);
+
+    TrackCacheConfig config_;
+    std::vector<Track> tracks_;
+    std::vector<int> free_slots_;
+    std::unordered_map<int, int> slot_of_id_;
+    // 最近一次update中第i个轨迹所在的槽位
+    std::vector<int> columns_;
+    // 槽位在columns_中的位置
+    std::vector<int> column_of_slot_;
+    std::unordered_map<uint64_t, std::vector<int> > cells_;
+    std::unordered_map<uint64_t, float> pair_iou_;
+    std::vector<char> changed_;
+    std::vector<unsigned> visit_stamp_;
+    unsigned stamp_;
+    std::vector<int> candidates_;
+    // computeIoU中一行的(列号, IoU)
+    std::vector<std::pair<int, float> > row_entries_;
+    size_t last_pair_evaluations_;
+};
+
+} // namespace nms